@@ -37,6 +37,7 @@
 #include <coredump.h>
 
 #include "utils/log.h"
+#include "packet_replay.h"
 
 using namespace std::chrono_literals;
 using namespace elastos::carrier;
@@ -54,6 +55,8 @@ struct Options {
     uint16_t port {0};
     std::string configFile {};
     std::string dataDir {};
+    std::string replayFile {};
+    double replaySpeed {1.0};
 };
 
 static void printVersion()
@@ -73,6 +76,8 @@ static Options parseArgs(int argc, char **argv)
     app.add_option("-p, --port", options.port, "The port to listen.");
     app.add_option("-d, --data-dir", options.dataDir, "The directory to store the node data.");
     app.add_flag("-D, --daemonize", options.daemonize, "Run in daemonize mode.");
+    app.add_option("-r, --replay", options.replayFile, "Replay a capture of the RPC datagrams against the node, then exit.");
+    app.add_option("--replay-speed", options.replaySpeed, "The speed factor of the replay, 0 as fast as possible.");
     app.add_flag("-v, --version", version, "Show the Carrier version.");
 
     try {
@@ -109,14 +114,20 @@ static Sp<Configuration> initConfigure(Options& options)
     if (!options.dataDir.empty())
         builder.setStoragePath(options.dataDir);
 
+    // the admission filter runs on the real clock, it would shed the datagrams of an accelerated replay
+    if (!options.replayFile.empty())
+        builder.setRPCAdmissionControl(false);
+
     auto config = builder.build();
     return config;
 }
 
-static Sp<Node> initCarrierNode(Sp<Configuration> config)
+static Sp<Node> initCarrierNode(Sp<Configuration> config, Sp<Transport> transport = nullptr)
 {
     auto node = std::make_shared<Node>(config);
     try {
+        if (transport != nullptr)
+            node->setTransport(transport);
         node->start();
     } catch(std::exception& e) {
         std::cout << e.what() << std::endl;
@@ -155,6 +166,35 @@ static void stop()
     }
 }
 
+static int replay(Sp<Configuration> config, const Options& options)
+{
+    Sp<PacketReplay> replay;
+    try {
+        replay = std::make_shared<PacketReplay>(options.replayFile);
+    } catch(std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+
+    g_node = initCarrierNode(config, replay);
+    if (!g_node)
+        return -1;
+
+    if (g_node->getId() != replay->getNodeId()) {
+        std::cout << "The capture was taken by the node " << replay->getNodeId().toBase58String()
+                  << ", replay it with the key of that node." << std::endl;
+        stop();
+        return -1;
+    }
+
+    auto stats = replay->run(options.replaySpeed);
+    std::cout << "Replayed " << stats.replayed << " datagrams in " << stats.elapsed << " ms, the node sent "
+              << stats.sent << " datagrams, " << stats.sentBytes << " bytes." << std::endl;
+
+    stop();
+    return 0;
+}
+
 static void signal_handler(int sig)
 {
     broke = true;
@@ -202,6 +242,9 @@ int main(int argc, char *argv[])
         std::exit(-1);
     }
 
+    if (!options.replayFile.empty())
+        return replay(config, options);
+
     g_node = initCarrierNode(config);
     if (!g_node)
         return 0;
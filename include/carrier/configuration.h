@@ -50,6 +50,90 @@ public:
     virtual std::vector<Sp<NodeInfo>>& getBootstrapNodes() = 0;
 
     virtual std::map<std::string, std::any>& getServices() = 0;
+
+    /**
+     * Number of receive workers used by the RPC server. Each worker receives,
+     * decrypts and parses datagrams on its own thread and hands the parsed
+     * messages to the single DHT thread. 0 keeps the single-threaded receive path.
+     */
+    virtual int rpcWorkers() {
+        return 0;
+    }
+
+    /**
+     * Number of crypto workers used by the RPC server. The receiving threads
+     * hand the raw datagrams to the workers, which decrypt, parse and check
+     * the signatures the messages carry before passing them to the DHT
+     * thread. 0 decrypts on the receiving thread.
+     */
+    virtual int rpcCryptoWorkers() {
+        return 0;
+    }
+
+    /**
+     * Maximum datagrams the RPC server receives or sends per system call,
+     * values less than 2 disable the batched I/O.
+     */
+    virtual int rpcBatchSize() {
+        return 0;
+    }
+
+    /**
+     * Use the io_uring backend for the RPC server sockets on Linux. Ignored
+     * if the library is built without it, the kernel doesn't support it, or
+     * the receive workers are enabled, the socket I/O is used instead.
+     */
+    virtual bool rpcIoUring() {
+        return false;
+    }
+
+    /**
+     * Admit the received datagrams by their cleartext sender id and source
+     * address before decrypting them: per source and per sender rate limits,
+     * a cap on the new senders needing a key derivation, and a blocklist of
+     * the sources sending undecryptable packets. Off by default, the limits
+     * suit the nodes that are exposed to floods.
+     */
+    virtual bool rpcAdmissionControl() {
+        return false;
+    }
+
+    /**
+     * Maximum size of the response datagrams in bytes. The node and peer
+     * lists of the lookup responses are trimmed to fit, so they don't get
+     * fragmented. 0, the default, keeps the whole lists, 1232 fits in the
+     * minimum IPv6 MTU.
+     */
+    virtual int rpcDatagramBudget() {
+        return 0;
+    }
+
+    /**
+     * Number of the recent packets kept in the RPC trace ring (txid, method,
+     * peer, size and timestamp) for the post-mortem analysis, they are dumped
+     * on demand by Node::dumpTrace. 0 disables the tracing.
+     */
+    virtual int rpcTraceCapacity() {
+        return 0;
+    }
+
+    /**
+     * Path of the file capturing every datagram the RPC server receives and
+     * sends, with its timestamp and peer, to replay the real traffic against
+     * the node later (see PacketReplay). Empty disables the capture.
+     */
+    virtual std::string rpcCaptureFile() {
+        return {};
+    }
+
+    /**
+     * Local port of the HTTP endpoint exporting the node metrics in the
+     * Prometheus text format, bound to 127.0.0.1. 0 disables it, it's also
+     * ignored if the library is built without ENABLE_METRICS.
+     */
+    virtual int metricsPort() {
+        return 0;
+    }
 };
 
 } // namespace carrier
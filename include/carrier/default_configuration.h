@@ -69,6 +69,42 @@ public:
         return services;
     }
 
+    int rpcWorkers() override {
+        return workers;
+    }
+
+    int rpcCryptoWorkers() override {
+        return cryptoWorkers;
+    }
+
+    int rpcBatchSize() override {
+        return batchSize;
+    }
+
+    bool rpcIoUring() override {
+        return ioUring;
+    }
+
+    bool rpcAdmissionControl() override {
+        return admissionControl;
+    }
+
+    int rpcDatagramBudget() override {
+        return datagramBudget;
+    }
+
+    int rpcTraceCapacity() override {
+        return traceCapacity;
+    }
+
+    std::string rpcCaptureFile() override {
+        return captureFile;
+    }
+
+    int metricsPort() override {
+        return metricsListeningPort;
+    }
+
     class CARRIER_PUBLIC Builder {
     public:
         Builder() {
@@ -111,6 +147,58 @@ public:
             return this->storagePath;
         }
 
+        void setRPCWorkers(int workers) {
+            if (workers < 0)
+                throw std::invalid_argument("Invalid RPC workers: " + std::to_string(workers));
+
+            this->workers = workers;
+        }
+
+        void setRPCCryptoWorkers(int workers) {
+            if (workers < 0)
+                throw std::invalid_argument("Invalid RPC crypto workers: " + std::to_string(workers));
+
+            this->cryptoWorkers = workers;
+        }
+
+        void setRPCBatchSize(int size) {
+            if (size < 0 || size > 1024)
+                throw std::invalid_argument("Invalid RPC batch size: " + std::to_string(size));
+
+            this->batchSize = size;
+        }
+
+        void setRPCIoUring(bool enabled) {
+            this->ioUring = enabled;
+        }
+
+        void setRPCAdmissionControl(bool enabled) {
+            this->admissionControl = enabled;
+        }
+
+        void setRPCDatagramBudget(int size) {
+            if (size != 0 && (size < 512 || size > 65507))
+                throw std::invalid_argument("Invalid RPC datagram budget: " + std::to_string(size));
+
+            this->datagramBudget = size;
+        }
+
+        void setRPCTraceCapacity(int capacity) {
+            if (capacity < 0 || capacity > 1048576)
+                throw std::invalid_argument("Invalid RPC trace capacity: " + std::to_string(capacity));
+
+            this->traceCapacity = capacity;
+        }
+
+        void setRPCCaptureFile(const std::string& path);
+
+        void setMetricsPort(int port) {
+            if (port < 0 || port > 65535)
+                throw std::invalid_argument("Invalid metrics port: " + std::to_string(port));
+
+            this->metricsListeningPort = port;
+        }
+
         void addBootstrap(const std::string& idstr, const std::string& addr, int port) {
             auto id = Id(idstr);
             auto address = SocketAddress(addr, port);
@@ -137,6 +225,15 @@ public:
         std::string ip6 {};
         int port = 39001;
         std::string storagePath {};
+        int workers {0};
+        int cryptoWorkers {0};
+        int batchSize {0};
+        bool ioUring {false};
+        bool admissionControl {false};
+        int datagramBudget {0};
+        int traceCapacity {0};
+        std::string captureFile {};
+        int metricsListeningPort {0};
         std::vector<Sp<NodeInfo>> bootstrapNodes {};
         std::map<std::string, std::any> services {};
     };
@@ -146,6 +243,15 @@ private:
     SocketAddress addr6 {};
 
     std::string storagePath {};
+    int workers {0};
+    int cryptoWorkers {0};
+    int batchSize {0};
+    bool ioUring {false};
+    bool admissionControl {false};
+    int datagramBudget {0};
+    int traceCapacity {0};
+    std::string captureFile {};
+    int metricsListeningPort {0};
     std::vector<Sp<NodeInfo>> bootstrapNodes {};
     std::map<std::string, std::any> services {};
 };
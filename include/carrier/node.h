@@ -26,6 +26,7 @@
 #include <vector>
 #include <functional>
 #include <future>
+#include <ostream>
 
 #include "def.h"
 #include "types.h"
@@ -43,6 +44,8 @@ namespace elastos {
 namespace carrier {
 
 class RPCServer;
+class MetricsExporter;
+class Transport;
 class CryptoCache;
 class TokenManager;
 class DataStorage;
@@ -83,6 +86,15 @@ public:
         // statusListeners.remove(listener);
     }
 
+    // Replaces the UDP sockets of the node, e.g. with a SimulatedNetwork. Set before start()
+    void setTransport(Sp<Transport> transport) {
+        this->transport = transport;
+    }
+
+    Sp<Transport> getTransport() const {
+        return transport;
+    }
+
     void bootstrap(const NodeInfo& node);
     void start();
     void stop();
@@ -137,6 +149,12 @@ public:
     bool removePeer(const Id& peerId);
 
     std::string toString() const;
+
+    // Writes the recent packets of the RPC trace ring, if enabled by the configuration
+    void dumpTrace(std::ostream& out) const;
+
+    // Writes the recent packet stage spans in the Chrome trace event format, built with ENABLE_STAGE_TRACING
+    void dumpStageTrace(std::ostream& out) const;
 private:
     bool checkPersistence(const std::string&);
     void loadKey(const std::string&);
@@ -169,6 +187,8 @@ private:
     Sp<TokenManager> tokenManager {};
     Sp<DataStorage> storage {};
     Sp<RPCServer> server {};
+    Sp<Transport> transport {};
+    Sp<MetricsExporter> metricsExporter {};
     Sp<CryptoCache> cryptoContexts {};
     Sp<Logger> log {};
 
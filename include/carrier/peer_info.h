@@ -128,6 +128,9 @@ public:
 
     bool isValid() const;
 
+    // Queues the signature check on the batch instead of verifying it now
+    void addTo(Signature::BatchVerifier& batch) const;
+
     bool operator==(const PeerInfo& other) const;
 
     bool operator<(const PeerInfo& other) const {
@@ -257,6 +257,48 @@ public:
 
     static const uint32_t BYTES { 64 };
 
+    /*
+     * Verifies a number of (data, signature, public key) tuples and tells
+     * which of them failed, so a caller can drop the bad records and keep the
+     * others. Each tuple is checked on its own through the verified-signature
+     * cache, and a malformed signature is rejected without any curve
+     * operation.
+     */
+    class CARRIER_PUBLIC BatchVerifier {
+    public:
+        BatchVerifier() noexcept {}
+
+        void add(const Blob& data, const Blob& signature, const PublicKey& pk);
+
+        size_t size() const noexcept {
+            return entries.size();
+        }
+
+        // Returns true if all the tuples are valid
+        bool verify();
+
+        // The positions of the failed tuples after verify(), in the order added
+        const std::vector<size_t>& getFailures() const noexcept {
+            return failures;
+        }
+
+        void clear() noexcept {
+            entries.clear();
+            failures.clear();
+        }
+
+    private:
+        struct Entry {
+            std::vector<uint8_t> data;
+            std::array<uint8_t, BYTES> signature;
+            PublicKey pk;
+            bool wellFormed;
+        };
+
+        std::vector<Entry> entries {};
+        std::vector<size_t> failures {};
+    };
+
     Signature() noexcept {
         reset();
     }
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/random_generator.h"
+#include "admission_filter.h"
+
+namespace elastos {
+namespace carrier {
+
+static inline uint64_t mix(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+void AdmissionFilter::TokenBucket::refill(int rate, uint64_t now) noexcept {
+    int64_t burst = (int64_t)rate * BURST_SECONDS * 1000;
+    if (last == 0) {
+        tokens = burst;     // a new bucket starts full
+    } else if (now > last) {
+        tokens = std::min(burst, tokens + (int64_t)(now - last) * rate);
+    }
+    last = now;
+}
+
+bool AdmissionFilter::TokenBucket::take(int rate, uint64_t now) noexcept {
+    if (rate <= 0)
+        return true;
+
+    refill(rate, now);
+    if (tokens < 1000)
+        return false;
+
+    tokens -= 1000;
+    return true;
+}
+
+bool AdmissionFilter::TokenBucket::isFull(int rate, uint64_t now) const noexcept {
+    if (rate <= 0 || last == 0)
+        return true;
+
+    int64_t burst = (int64_t)rate * BURST_SECONDS * 1000;
+    return tokens + (int64_t)(now > last ? now - last : 0) * rate >= burst;
+}
+
+AdmissionFilter::AdmissionFilter(const Limits& limits)
+        : limits(limits), seed(RandomGenerator<uint64_t>()()), sources(SLOTS), senders(SLOTS) {
+}
+
+uint64_t AdmissionFilter::tagOf(const Id& id) const noexcept {
+    uint64_t h = seed;
+    for (size_t i = 0; i < ID_BYTES; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, id.data() + i, sizeof(word));
+        h = mix(h ^ word);
+    }
+    return h | 1;   // 0 marks the empty slots
+}
+
+uint64_t AdmissionFilter::tagOf(const SocketAddress& addr) const noexcept {
+    uint64_t h = mix(seed ^ addr.port());
+    auto bytes = addr.inaddr();
+    auto length = addr.inaddrLength();
+    for (size_t i = 0; i < length; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i, std::min(sizeof(word), length - i));
+        h = mix(h ^ word);
+    }
+    return h | 1;
+}
+
+bool AdmissionFilter::isIdle(const SourceSlot& slot, uint64_t now) const noexcept {
+    return slot.blockedUntil <= now
+        && (slot.failures == 0 || now >= slot.failureWindow + FAILURE_WINDOW)
+        && !isAuthenticated(slot, now)
+        && slot.bucket.isFull(limits.sourceRate, now);
+}
+
+bool AdmissionFilter::isAuthenticated(const SourceSlot& slot, uint64_t now) const noexcept {
+    return slot.lastAuthenticated != 0 && now < slot.lastAuthenticated + AUTHENTICATED_WINDOW;
+}
+
+AdmissionFilter::Verdict AdmissionFilter::admit(const Id& sender, const SocketAddress& from, uint64_t now) {
+    auto verdict = admitSource(from, now);
+    if (verdict == Verdict::ACCEPTED)
+        verdict = admitSender(sender, now);
+
+    switch (verdict) {
+    case Verdict::ACCEPTED:
+        accepted.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Verdict::BLOCKED:
+        blocked.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Verdict::SOURCE_LIMITED:
+        sourceLimited.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Verdict::SENDER_LIMITED:
+        senderLimited.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Verdict::KEY_LIMITED:
+        keyLimited.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+    return verdict;
+}
+
+AdmissionFilter::Verdict AdmissionFilter::admitSource(const SocketAddress& from, uint64_t now) {
+    auto tag = tagOf(from);
+    auto index = tag % SLOTS;
+
+    std::lock_guard<std::mutex> lk(sourceLocks[index % STRIPES]);
+    auto& slot = sources[index];
+    if (slot.tag != tag) {
+        if (slot.tag == 0 || isIdle(slot, now)) {
+            slot = SourceSlot {};
+            slot.tag = tag;
+        }
+        // otherwise share the occupant's bucket, but not its blocking
+    } else if (slot.blockedUntil > now) {
+        return Verdict::BLOCKED;
+    }
+
+    return slot.bucket.take(limits.sourceRate, now) ? Verdict::ACCEPTED : Verdict::SOURCE_LIMITED;
+}
+
+AdmissionFilter::Verdict AdmissionFilter::admitSender(const Id& sender, uint64_t now) {
+    auto tag = tagOf(sender);
+    auto index = tag % SLOTS;
+
+    std::lock_guard<std::mutex> lk(senderLocks[index % STRIPES]);
+    auto& slot = senders[index];
+    if (slot.tag != tag) {
+        // not seen recently, decrypting its packet derives a shared key
+        if (!takeKeyDerivation(now))
+            return Verdict::KEY_LIMITED;
+
+        if (slot.tag == 0 || slot.bucket.isFull(limits.senderRate, now)) {
+            slot = SenderSlot {};
+            slot.tag = tag;
+        }
+    }
+
+    return slot.bucket.take(limits.senderRate, now) ? Verdict::ACCEPTED : Verdict::SENDER_LIMITED;
+}
+
+bool AdmissionFilter::takeKeyDerivation(uint64_t now) {
+    std::lock_guard<std::mutex> lk(newSendersLock);
+    return newSenders.take(limits.newSenderRate, now);
+}
+
+void AdmissionFilter::failure(const SocketAddress& from, uint64_t now) {
+    failures.fetch_add(1, std::memory_order_relaxed);
+    if (limits.blocklistFailures <= 0)
+        return;
+
+    auto tag = tagOf(from);
+    auto index = tag % SLOTS;
+
+    std::lock_guard<std::mutex> lk(sourceLocks[index % STRIPES]);
+    auto& slot = sources[index];
+    if (slot.tag != tag) {
+        // never count the failures against a busy occupant
+        if (slot.tag != 0 && !isIdle(slot, now))
+            return;
+
+        slot = SourceSlot {};
+        slot.tag = tag;
+    }
+
+    // a real peer at the address, the failures are likely forged on its behalf
+    if (isAuthenticated(slot, now)) {
+        spared.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (slot.failures == 0 || now >= slot.failureWindow + FAILURE_WINDOW) {
+        slot.failureWindow = now;
+        slot.failures = 0;
+    }
+
+    if (++slot.failures >= limits.blocklistFailures) {
+        slot.blockedUntil = now + limits.blocklistDuration;
+        slot.failures = 0;
+        blocklisted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AdmissionFilter::success(const SocketAddress& from, uint64_t now) {
+    auto tag = tagOf(from);
+    auto index = tag % SLOTS;
+
+    std::lock_guard<std::mutex> lk(sourceLocks[index % STRIPES]);
+    auto& slot = sources[index];
+    if (slot.tag != tag) {
+        if (slot.tag != 0 && !isIdle(slot, now))
+            return;
+
+        slot = SourceSlot {};
+        slot.tag = tag;
+    }
+
+    slot.lastAuthenticated = now;
+    slot.failures = 0;
+    slot.blockedUntil = 0;
+}
+
+bool AdmissionFilter::isBlocked(const SocketAddress& from, uint64_t now) {
+    auto tag = tagOf(from);
+    auto index = tag % SLOTS;
+
+    std::lock_guard<std::mutex> lk(sourceLocks[index % STRIPES]);
+    auto& slot = sources[index];
+    return slot.tag == tag && slot.blockedUntil > now;
+}
+
+AdmissionFilter::Stats AdmissionFilter::getStats() const {
+    Stats stats;
+    stats.accepted = accepted.load(std::memory_order_relaxed);
+    stats.blocked = blocked.load(std::memory_order_relaxed);
+    stats.sourceLimited = sourceLimited.load(std::memory_order_relaxed);
+    stats.senderLimited = senderLimited.load(std::memory_order_relaxed);
+    stats.keyLimited = keyLimited.load(std::memory_order_relaxed);
+    stats.failures = failures.load(std::memory_order_relaxed);
+    stats.blocklisted = blocklisted.load(std::memory_order_relaxed);
+    stats.spared = spared.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AdmissionFilter::clear() {
+    for (size_t i = 0; i < STRIPES; i++) {
+        std::lock_guard<std::mutex> lk(sourceLocks[i]);
+        for (size_t j = i; j < SLOTS; j += STRIPES)
+            sources[j] = SourceSlot {};
+    }
+
+    for (size_t i = 0; i < STRIPES; i++) {
+        std::lock_guard<std::mutex> lk(senderLocks[i]);
+        for (size_t j = i; j < SLOTS; j += STRIPES)
+            senders[j] = SenderSlot {};
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(newSendersLock);
+        newSenders = TokenBucket {};
+    }
+
+    accepted = 0;
+    blocked = 0;
+    sourceLimited = 0;
+    senderLimited = 0;
+    keyLimited = 0;
+    failures = 0;
+    blocklisted = 0;
+    spared = 0;
+}
+
+} // namespace carrier
+} // namespace elastos
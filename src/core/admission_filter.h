@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "carrier/id.h"
+#include "carrier/socket_address.h"
+#include "constants.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Admission of the received datagrams before they are decrypted, only the
+ * cleartext sender id and the source address are looked at. Each source
+ * address and each sender id has a token bucket, the sources that keep
+ * sending packets failing to decrypt or parse are blocked for a while, and
+ * the senders not seen recently, which cost a key derivation, are capped
+ * globally per second. The source addresses can be spoofed, so the failures
+ * never count against a source that recently sent authenticated packets,
+ * forged garbage can't cut a node off from its real peers.
+ *
+ * The buckets live in fixed size tables indexed by hash, the memory doesn't
+ * grow with the number of the spoofed ids or addresses. A slot only goes to
+ * a new key once its occupant is idle, until then the colliding keys share
+ * the occupant's bucket, so a collision never loosens the limits. The slots
+ * are guarded by striped locks, it's safe to be called from the receiving
+ * threads.
+ */
+class AdmissionFilter {
+public:
+    enum class Verdict {
+        ACCEPTED,
+        BLOCKED,
+        SOURCE_LIMITED,
+        SENDER_LIMITED,
+        KEY_LIMITED
+    };
+
+    struct Limits {
+        int sourceRate {Constants::RPC_SOURCE_RATE_LIMIT};            // packets/s
+        int senderRate {Constants::RPC_SENDER_RATE_LIMIT};            // packets/s
+        int newSenderRate {Constants::RPC_NEW_SENDER_RATE_LIMIT};     // senders/s
+        int blocklistFailures {Constants::RPC_BLOCKLIST_FAILURES};
+        int blocklistDuration {Constants::RPC_BLOCKLIST_DURATION};    // ms
+    };
+
+    struct Stats {
+        uint64_t accepted {0};
+        uint64_t blocked {0};
+        uint64_t sourceLimited {0};
+        uint64_t senderLimited {0};
+        uint64_t keyLimited {0};
+        uint64_t failures {0};
+        uint64_t blocklisted {0};
+        uint64_t spared {0};
+    };
+
+    static const size_t SLOTS = 16384;
+    static const size_t STRIPES = 64;
+    static const int BURST_SECONDS = 2;
+    static const int FAILURE_WINDOW = 10 * 1000;    // ms
+    static const int AUTHENTICATED_WINDOW = 5 * 60 * 1000;    // ms
+
+    AdmissionFilter() : AdmissionFilter(Limits {}) {}
+    explicit AdmissionFilter(const Limits& limits);
+
+    AdmissionFilter(const AdmissionFilter&) = delete;
+    AdmissionFilter& operator=(const AdmissionFilter&) = delete;
+
+    Verdict admit(const Id& sender, const SocketAddress& from, uint64_t now);
+
+    // A packet from the source failed to decrypt or parse
+    void failure(const SocketAddress& from, uint64_t now);
+
+    // A packet from the source decrypted and parsed
+    void success(const SocketAddress& from, uint64_t now);
+
+    bool isBlocked(const SocketAddress& from, uint64_t now);
+
+    Stats getStats() const;
+
+    void clear();
+
+private:
+    // Tokens are kept in thousandths, the refill is exact at 1ms granularity
+    struct TokenBucket {
+        int64_t tokens {0};
+        uint64_t last {0};
+
+        void refill(int rate, uint64_t now) noexcept;
+        bool take(int rate, uint64_t now) noexcept;
+        bool isFull(int rate, uint64_t now) const noexcept;
+    };
+
+    struct SourceSlot {
+        uint64_t tag {0};
+        TokenBucket bucket {};
+        int failures {0};
+        uint64_t failureWindow {0};
+        uint64_t blockedUntil {0};
+        uint64_t lastAuthenticated {0};
+    };
+
+    struct SenderSlot {
+        uint64_t tag {0};
+        TokenBucket bucket {};
+    };
+
+    // Keyed by a random seed, the colliding ids or addresses can't be chosen
+    uint64_t tagOf(const Id& id) const noexcept;
+    uint64_t tagOf(const SocketAddress& addr) const noexcept;
+
+    bool isIdle(const SourceSlot& slot, uint64_t now) const noexcept;
+    bool isAuthenticated(const SourceSlot& slot, uint64_t now) const noexcept;
+
+    Verdict admitSource(const SocketAddress& from, uint64_t now);
+    Verdict admitSender(const Id& sender, uint64_t now);
+    bool takeKeyDerivation(uint64_t now);
+
+    Limits limits;
+    uint64_t seed;
+
+    std::vector<SourceSlot> sources;
+    std::array<std::mutex, STRIPES> sourceLocks {};
+
+    std::vector<SenderSlot> senders;
+    std::array<std::mutex, STRIPES> senderLocks {};
+
+    TokenBucket newSenders {};
+    std::mutex newSendersLock {};
+
+    std::atomic<uint64_t> accepted {0};
+    std::atomic<uint64_t> blocked {0};
+    std::atomic<uint64_t> sourceLimited {0};
+    std::atomic<uint64_t> senderLimited {0};
+    std::atomic<uint64_t> keyLimited {0};
+    std::atomic<uint64_t> failures {0};
+    std::atomic<uint64_t> blocklisted {0};
+    std::atomic<uint64_t> spared {0};
+};
+
+} // namespace carrier
+} // namespace elastos
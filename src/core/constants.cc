@@ -31,7 +31,20 @@ const int Constants::RPC_SERVER_REACHABILITY_TIMEOUT        = 60 * 1000;
 const int Constants::MAX_ACTIVE_CALLS                       = 256;
 const int Constants::RPC_CALL_TIMEOUT_MAX                   = 10 * 1000;
 const int Constants::RPC_CALL_TIMEOUT_BASELINE_MIN          = 100; // ms
+const int Constants::RPC_CALL_STALL_TIMEOUT                 = 2000; // ms
 const int Constants::RECEIVE_BUFFER_SIZE                    = 5 * 1024;
+const int Constants::RPC_WORKER_QUEUE_CAPACITY              = 4096;
+const int Constants::RPC_CRYPTO_QUEUE_CAPACITY              = 4096;
+const int Constants::RPC_SEND_RETRY_INTERVAL                = 10; // ms
+const int Constants::RPC_PACKET_POOL_SIZE                   = 1024;
+const int Constants::RPC_PACKET_BUFFER_SIZE                 = 2048;
+const int Constants::RPC_RECEIVE_POOL_SIZE                  = 64;
+const int Constants::RPC_OBJECT_POOL_SIZE                   = 1024;
+const int Constants::RPC_SOURCE_RATE_LIMIT                  = 256;
+const int Constants::RPC_SENDER_RATE_LIMIT                  = 256;
+const int Constants::RPC_NEW_SENDER_RATE_LIMIT              = 512;
+const int Constants::RPC_BLOCKLIST_FAILURES                 = 16;
+const int Constants::RPC_BLOCKLIST_DURATION                 = 60 * 1000;
 
 const int Constants::MAX_CONCURRENT_TASK_REQUESTS           = 10;
 const int Constants::MAX_ACTIVE_TASKS                       = 16;
@@ -59,10 +72,11 @@ const int Constants::TOKEN_TIMEOUT                          = 5 * 60 * 1000;
 const int Constants::MAX_PEER_AGE                           = 120 * 60 * 1000;
 const int Constants::MAX_VALUE_AGE                          = 120 * 60 * 1000;
 const int Constants::RE_ANNOUNCE_INTERVAL                   = 5 * 60 * 1000;
+const int Constants::SIGNATURE_CACHE_CAPACITY               = 32768;
 
 const std::string Constants::NODE_NAME                      = "Meerkat";
 const std::string Constants::NODE_SHORT_NAME                = "MK";
-const int Constants::NODE_VERSION                           = 1;
+const int Constants::NODE_VERSION                           = 2;
 const std::string Constants::ENVIRONMENT_PROPERTY           = "elastos.carrier.enviroment";
 
 }
@@ -42,7 +42,30 @@ struct Constants {
     static const int        MAX_ACTIVE_CALLS;
     static const int        RPC_CALL_TIMEOUT_MAX;
     static const int        RPC_CALL_TIMEOUT_BASELINE_MIN;
+    // stall timer until enough round trips were seen to estimate it
+    static const int        RPC_CALL_STALL_TIMEOUT;
     static const int        RECEIVE_BUFFER_SIZE;
+    // parsed messages waiting for the DHT thread when receive workers are enabled
+    static const int        RPC_WORKER_QUEUE_CAPACITY;
+    // raw datagrams waiting for the crypto workers
+    static const int        RPC_CRYPTO_QUEUE_CAPACITY;
+    // retry interval for the packets the socket couldn't take (EAGAIN)
+    static const int        RPC_SEND_RETRY_INTERVAL;
+    // pooled packet buffers, grown on demand for the larger packets
+    static const int        RPC_PACKET_POOL_SIZE;
+    static const int        RPC_PACKET_BUFFER_SIZE;
+    // decrypted packets are only held while parsing, one per receiving thread
+    static const int        RPC_RECEIVE_POOL_SIZE;
+    // recycled blocks per type for the parsed messages and their nodes
+    static const int        RPC_OBJECT_POOL_SIZE;
+    // admission before decryption: packets per second from a source address
+    // and from a sender id, the new senders needing a key derivation per
+    // second, and the decrypt or parse failures that get a source blocked
+    static const int        RPC_SOURCE_RATE_LIMIT;
+    static const int        RPC_SENDER_RATE_LIMIT;
+    static const int        RPC_NEW_SENDER_RATE_LIMIT;
+    static const int        RPC_BLOCKLIST_FAILURES;
+    static const int        RPC_BLOCKLIST_DURATION;
 
     ///////////////////////////////////////////////////////////////////////////
     // Task & Lookup constants
@@ -84,6 +107,8 @@ struct Constants {
     static const int        MAX_PEER_AGE;
     static const int        MAX_VALUE_AGE;
     static const int        RE_ANNOUNCE_INTERVAL;
+    // successful signature verifications remembered for the values and peers
+    static const int        SIGNATURE_CACHE_CAPACITY;
 
     ///////////////////////////////////////////////////////////////////////////
     // Node software name and version
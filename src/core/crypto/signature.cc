@@ -28,6 +28,7 @@
 #include <sodium.h>
 #include "carrier/signature.h"
 #include "crypto/hex.h"
+#include "crypto/signature_cache.h"
 
 namespace elastos {
 namespace carrier {
@@ -87,7 +88,29 @@ bool Signature::PublicKey::verify(const Blob& data, const Blob& signature) const
     if (signature.size() != Signature::BYTES)
         throw std::invalid_argument("Invalid signature length.");
 
-    return crypto_sign_verify_detached(signature.ptr(), data.ptr(), data.size(), bytes()) == 0;
+    return SignatureCache::global().verify(data, signature, *this);
+}
+
+void Signature::BatchVerifier::add(const Blob& data, const Blob& signature, const PublicKey& pk)
+{
+    Entry entry { std::vector<uint8_t>(data.cbegin(), data.cend()), {}, pk, signature.size() == BYTES };
+    if (entry.wellFormed)
+        std::memcpy(entry.signature.data(), signature.ptr(), BYTES);
+
+    entries.push_back(std::move(entry));
+}
+
+bool Signature::BatchVerifier::verify()
+{
+    failures.clear();
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const auto& entry = entries[i];
+        if (!entry.wellFormed || !SignatureCache::global().verify(entry.data, entry.signature, entry.pk))
+            failures.push_back(i);
+    }
+
+    return failures.empty();
 }
 
 Signature::KeyPair::KeyPair() noexcept
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include <sodium.h>
+#include "constants.h"
+#include "signature_cache.h"
+
+namespace elastos {
+namespace carrier {
+
+SignatureCache::SignatureCache(size_t capacity)
+{
+    buckets.resize(std::max<size_t>(1, (capacity + WAYS - 1) / WAYS));
+}
+
+SignatureCache& SignatureCache::global()
+{
+    static SignatureCache cache((size_t)Constants::SIGNATURE_CACHE_CAPACITY);
+    return cache;
+}
+
+SignatureCache::Digest SignatureCache::digest(const Blob& data, const Blob& signature, const Signature::PublicKey& pk)
+{
+    SHA256 sha;
+    sha.update(pk.blob());
+    sha.update(signature);
+    sha.update(data);
+
+    Digest digest;
+    Blob _digest {digest};
+    sha.digest(_digest);
+    return digest;
+}
+
+bool SignatureCache::verify(const Blob& data, const Blob& signature, const Signature::PublicKey& pk)
+{
+    if (!enabled)
+        return crypto_sign_verify_detached(signature.ptr(), data.ptr(), data.size(), pk.bytes()) == 0;
+
+    auto d = digest(data, signature, pk);
+    if (contains(d)) {
+        hits++;
+        return true;
+    }
+
+    misses++;
+    if (crypto_sign_verify_detached(signature.ptr(), data.ptr(), data.size(), pk.bytes()) != 0)
+        return false;
+
+    put(d);
+    return true;
+}
+
+SignatureCache::Bucket& SignatureCache::bucketOf(const Digest& digest, std::mutex*& lock)
+{
+    // the digest is uniformly distributed, any of its bytes make a good index
+    uint64_t index;
+    std::memcpy(&index, digest.data(), sizeof(index));
+    index %= buckets.size();
+
+    lock = &locks[index % STRIPES];
+    return buckets[index];
+}
+
+bool SignatureCache::contains(const Digest& digest)
+{
+    std::mutex* lock;
+    auto& bucket = bucketOf(digest, lock);
+
+    std::lock_guard<std::mutex> lk(*lock);
+    return std::find(bucket.entries.begin(), bucket.entries.end(), digest) != bucket.entries.end();
+}
+
+void SignatureCache::put(const Digest& digest)
+{
+    std::mutex* lock;
+    auto& bucket = bucketOf(digest, lock);
+
+    std::lock_guard<std::mutex> lk(*lock);
+    if (std::find(bucket.entries.begin(), bucket.entries.end(), digest) != bucket.entries.end())
+        return;
+
+    bucket.entries[bucket.next] = digest;
+    bucket.next = (bucket.next + 1) % WAYS;
+}
+
+void SignatureCache::clear()
+{
+    for (size_t i = 0; i < buckets.size(); i++) {
+        std::lock_guard<std::mutex> lk(locks[i % STRIPES]);
+        buckets[i] = Bucket {};
+    }
+}
+
+} // namespace carrier
+} // namespace elastos
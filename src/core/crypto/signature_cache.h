@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "carrier/blob.h"
+#include "carrier/signature.h"
+#include "shasum.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Remembers the signatures that verified successfully, so the same value or
+ * peer checked again by the DHT, the storage, the lookups or a re-announce
+ * skips the Ed25519 verification. An entry is the SHA-256 digest of the
+ * public key, the signature and the signed data, a hit is only possible for
+ * exactly the same tuple. The failures are never recorded.
+ *
+ * The table is set associative with a fixed number of buckets, a full bucket
+ * replaces its entries round robin. The buckets are guarded by striped locks.
+ */
+class SignatureCache {
+public:
+    using Digest = std::array<uint8_t, SHA256::BYTES>;
+
+    static const size_t WAYS = 4;
+    static const size_t STRIPES = 64;
+
+    explicit SignatureCache(size_t capacity);
+
+    SignatureCache(const SignatureCache&) = delete;
+    SignatureCache& operator=(const SignatureCache&) = delete;
+
+    // The cache used by Signature::PublicKey::verify and the batch verifier
+    static SignatureCache& global();
+
+    static Digest digest(const Blob& data, const Blob& signature, const Signature::PublicKey& pk);
+
+    /*
+     * Verifies the signature with libsodium unless the same tuple verified
+     * before, records it on success.
+     */
+    bool verify(const Blob& data, const Blob& signature, const Signature::PublicKey& pk);
+
+    bool contains(const Digest& digest);
+    void put(const Digest& digest);
+    void clear();
+
+    // Disabled, verify() always calls libsodium and records nothing
+    void setEnabled(bool enabled) noexcept {
+        this->enabled = enabled;
+    }
+
+    bool isEnabled() const noexcept {
+        return enabled;
+    }
+
+    size_t capacity() const noexcept {
+        return buckets.size() * WAYS;
+    }
+
+    uint64_t getHits() const noexcept {
+        return hits;
+    }
+
+    uint64_t getMisses() const noexcept {
+        return misses;
+    }
+
+private:
+    struct Bucket {
+        std::array<Digest, WAYS> entries {};
+        uint8_t next {0};
+    };
+
+    Bucket& bucketOf(const Digest& digest, std::mutex*& lock);
+
+    std::vector<Bucket> buckets {};
+    std::array<std::mutex, STRIPES> locks {};
+
+    std::atomic<bool> enabled {true};
+    std::atomic<uint64_t> hits {0};
+    std::atomic<uint64_t> misses {0};
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <cstring>
+
 #include "carrier/id.h"
 #include "utils/loading_cache.h"
 #include "constants.h"
@@ -30,12 +32,22 @@
 namespace elastos {
 namespace carrier {
 
-class CryptoCache : public LocadingCache<Id, CryptoContext> {
+// The ids are public keys, any of their bytes are already well distributed
+struct IdHash {
+    size_t operator()(const Id& id) const noexcept {
+        size_t hash;
+        std::memcpy(&hash, id.data(), sizeof(hash));
+        return hash;
+    }
+};
+
+class CryptoCache : public LocadingCache<Id, CryptoContext, IdHash> {
 public:
     static const int EXPIRED_CHECK_INTERVAL = 60 * 1000;
+    static const size_t MAX_ENTRIES = 16384;
 
     CryptoCache(CryptoBox::KeyPair _keypair)
-        : keypair(_keypair), LocadingCache(Constants::KBUCKET_OLD_AND_STALE_TIME) {}
+        : LocadingCache(Constants::KBUCKET_OLD_AND_STALE_TIME, MAX_ENTRIES), keypair(_keypair) {}
 
 private:
     CryptoContext load(const Id& key) override {
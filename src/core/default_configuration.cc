@@ -49,6 +49,10 @@ void Builder::setStoragePath(const std::string& path) {
     this->storagePath = !path.empty() ? expanduser(path) : path;
 }
 
+void Builder::setRPCCaptureFile(const std::string& path) {
+    this->captureFile = !path.empty() ? expanduser(path) : path;
+}
+
 void Builder::load(const std::string& filePath) {
     const auto& path = expanduser(filePath);
     if (path.empty())
@@ -86,6 +90,33 @@ void Builder::load(const std::string& filePath) {
     if (root.contains("dataDir"))
         setStoragePath(root["dataDir"].get<std::string>());
 
+    if (root.contains("rpcWorkers"))
+        setRPCWorkers(root["rpcWorkers"].get<int>());
+
+    if (root.contains("rpcCryptoWorkers"))
+        setRPCCryptoWorkers(root["rpcCryptoWorkers"].get<int>());
+
+    if (root.contains("rpcBatchSize"))
+        setRPCBatchSize(root["rpcBatchSize"].get<int>());
+
+    if (root.contains("rpcIoUring"))
+        setRPCIoUring(root["rpcIoUring"].get<bool>());
+
+    if (root.contains("rpcAdmissionControl"))
+        setRPCAdmissionControl(root["rpcAdmissionControl"].get<bool>());
+
+    if (root.contains("rpcDatagramBudget"))
+        setRPCDatagramBudget(root["rpcDatagramBudget"].get<int>());
+
+    if (root.contains("rpcTraceCapacity"))
+        setRPCTraceCapacity(root["rpcTraceCapacity"].get<int>());
+
+    if (root.contains("rpcCaptureFile"))
+        setRPCCaptureFile(root["rpcCaptureFile"].get<std::string>());
+
+    if (root.contains("metricsPort"))
+        setMetricsPort(root["metricsPort"].get<int>());
+
     if (root.contains("logger")) {
         auto logSettings = root["logger"].get<nlohmann::json>();
         Logger::setDefaultSettings(jsonToAny(logSettings));
@@ -142,6 +173,15 @@ void Builder::reset() {
     ip6 = {};
     port = 39001;
     storagePath = {};
+    workers = 0;
+    cryptoWorkers = 0;
+    batchSize = 0;
+    ioUring = false;
+    admissionControl = false;
+    datagramBudget = 0;
+    traceCapacity = 0;
+    captureFile = {};
+    metricsListeningPort = 0;
     bootstrapNodes.clear();
     services.clear();
 }
@@ -154,6 +194,15 @@ Sp<Configuration> Builder::build() {
         ip6 = getLocalIPv6();
 
     auto dataStorage = std::make_shared<DefaultConfiguration>(ip4, ip6,  port, storagePath, bootstrapNodes, services);
+    dataStorage->workers = workers;
+    dataStorage->cryptoWorkers = cryptoWorkers;
+    dataStorage->batchSize = batchSize;
+    dataStorage->ioUring = ioUring;
+    dataStorage->admissionControl = admissionControl;
+    dataStorage->datagramBudget = datagramBudget;
+    dataStorage->traceCapacity = traceCapacity;
+    dataStorage->captureFile = captureFile;
+    dataStorage->metricsListeningPort = metricsListeningPort;
     return std::static_pointer_cast<Configuration>(dataStorage);
 }
 
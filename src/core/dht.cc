@@ -29,6 +29,7 @@
 
 #include "utils/time.h"
 #include "utils/log.h"
+#include "utils/object_pool.h"
 #include "task/node_lookup.h"
 #include "task/task_manager.h"
 #include "task/value_lookup.h"
@@ -55,6 +56,7 @@
 #include "rpccall.h"
 #include "routing_table.h"
 #include "data_storage.h"
+#include "stage_tracer.h"
 #include "kclosest_nodes.h"
 #include "dht.h"
 
@@ -62,7 +64,7 @@ namespace elastos {
 namespace carrier {
 
 DHT::DHT(Type _type, const Node& _node, const SocketAddress& _addr)
-    :type(_type), node(_node), addr(_addr), bootstrapping(false) {
+    :type(_type), node(_node), addr(_addr), taskMan(_type == Type::IPV4 ? "ipv4" : "ipv6"), bootstrapping(false) {
 
     log = Logger::get("dht");
 }
@@ -292,7 +294,8 @@ void DHT::received(Sp<Message> msg) {
     bool bogon = false;
 
 #ifdef CARRIER_DEVELOPMENT
-    bogon = !addr.isAnyUnicast();
+    // the local clusters of the tests and benchmarks run on the loopback addresses
+    bogon = !addr.isAnyUnicast() && !addr.isLoopback();
 #else
     bogon = addr.isBogon();
 #endif
@@ -411,14 +414,16 @@ void DHT::onError(Sp<Message> msg) {
 }
 
 void DHT::onPing(const Sp<Message>& msg) {
-    auto response = std::make_shared<PingResponse>(msg->getTxid());
+    auto response = makePooled<PingResponse>(msg->getTxid());
+    response->setCompact(msg->isCompact());
     response->setRemote(msg->getId(), msg->getOrigin());
     rpcServer->sendMessage(response);
 }
 
 void DHT::onFindNode(const Sp<Message>& msg) {
     auto request = std::dynamic_pointer_cast<FindNodeRequest>(msg);
-    auto response = std::make_shared<FindNodeResponse>(msg->getTxid());
+    auto response = makePooled<FindNodeResponse>(msg->getTxid());
+    response->setCompact(request->isCompact());
 
     int want4 = request->doesWant4() ? Constants::MAX_ENTRIES_PER_BUCKET : 0;
     int want6 = request->doesWant6() ? Constants::MAX_ENTRIES_PER_BUCKET : 0;
@@ -429,6 +434,7 @@ void DHT::onFindNode(const Sp<Message>& msg) {
         response->setToken(token);
     }
 
+    fitResponse(*response);
     response->setRemote(request->getId(), request->getOrigin());
     rpcServer->sendMessage(response);
 }
@@ -436,13 +442,15 @@ void DHT::onFindNode(const Sp<Message>& msg) {
 void DHT::onFindValue(const Sp<Message>& msg) {
     auto request = std::dynamic_pointer_cast<FindValueRequest>(msg);
 
-    auto response = std::make_shared<FindValueResponse>(msg->getTxid());
+    auto response = makePooled<FindValueResponse>(msg->getTxid());
 
     auto token = tokenManager->generateToken(request->getId(), request->getOrigin(), node.getId());
     response->setToken(token);
 
     auto hasValue {false};
+    CARRIER_STAGE_MARK(storageStart);
     auto value = node.getStorage()->getValue(request->getTarget());
+    CARRIER_STAGE_END(STORAGE, msg->getMethod(), storageStart);
     if (value != nullptr) {
         if (request->getSequenceNumber() < 0 || value->getSequenceNumber() < 0
                 || request->getSequenceNumber() <= value->getSequenceNumber()) {
@@ -457,6 +465,7 @@ void DHT::onFindValue(const Sp<Message>& msg) {
         populateClosestNodes(response, request->getTarget(), want4, want6);
     }
 
+    fitResponse(*response);
     response->setRemote(request->getId(), request->getOrigin());
     rpcServer->sendMessage(response);
 }
@@ -471,21 +480,23 @@ void DHT::onStoreValue(const Sp<Message>& msg) {
         return;
     }
 
-    if (!value.isValid()) {
+    if (!request->isSignatureValid()) {
         sendError(request, ErrorCode::ProtocolError, "Invalid value");
         return;
     }
 
+    CARRIER_STAGE_MARK(storageStart);
     node.getStorage()->putValue(value, request->getExpectedSequenceNumber());
+    CARRIER_STAGE_END(STORAGE, msg->getMethod(), storageStart);
 
-    auto response = std::make_shared<StoreValueResponse>(request->getTxid());
+    auto response = makePooled<StoreValueResponse>(request->getTxid());
     response->setRemote(request->getId(), request->getOrigin());
     rpcServer->sendMessage(response);
 }
 
 void DHT::onFindPeers(const Sp<Message>& msg) {
     auto request = std::static_pointer_cast<FindPeerRequest>(msg);
-    auto response = std::make_shared<FindPeerResponse>(msg->getTxid());
+    auto response = makePooled<FindPeerResponse>(msg->getTxid());
 
     auto storage = node.getStorage();
     auto target = request->getTarget();
@@ -493,7 +504,9 @@ void DHT::onFindPeers(const Sp<Message>& msg) {
     response->setToken(token);
 
     bool hasPeers {false};
+    CARRIER_STAGE_MARK(storageStart);
     auto peers = storage->getPeer(target, 8);
+    CARRIER_STAGE_END(STORAGE, msg->getMethod(), storageStart);
     if (!peers.empty()) {
         response->setPeers(peers);
         hasPeers = true;
@@ -505,6 +518,7 @@ void DHT::onFindPeers(const Sp<Message>& msg) {
         populateClosestNodes(response, request->getTarget(), want4, want6);
     }
 
+    fitResponse(*response);
     response->setRemote(request->getId(), request->getOrigin());
     rpcServer->sendMessage(response);
 }
@@ -514,7 +528,7 @@ void DHT::onAnnouncePeer(const Sp<Message>& msg) {
     bool bogon {false};
 
 #ifdef CARRIER_DEVELOPMENT
-    bogon = !request->getOrigin().isAnyUnicast();
+    bogon = !request->getOrigin().isAnyUnicast() && !request->getOrigin().isLoopback();
 #else
     bogon = request->getOrigin().isBogon();
 #endif
@@ -533,9 +547,11 @@ void DHT::onAnnouncePeer(const Sp<Message>& msg) {
     auto peer = request->getPeer();
     log->debug("Received an announce peer request from {}, saving peer {}", request->getOrigin().toString(),
                     request->getTarget());
+    CARRIER_STAGE_MARK(storageStart);
     node.getStorage()->putPeer(peer);
+    CARRIER_STAGE_END(STORAGE, msg->getMethod(), storageStart);
 
-    auto response = std::make_shared<AnnouncePeerResponse>(request->getTxid());
+    auto response = makePooled<AnnouncePeerResponse>(request->getTxid());
     response->setRemote(request->getId(), request->getOrigin());
     rpcServer->sendMessage(response);
 }
@@ -747,6 +763,16 @@ void DHT::populateClosestNodes(Sp<LookupResponse> response, const Id& target, in
     }
 }
 
+/*
+ * Trims the node and peer lists to the datagram budget, the packet adds the
+ * sender id and the MAC to the serialized message.
+ */
+void DHT::fitResponse(LookupResponse& response) {
+    int budget = rpcServer->getDatagramBudget();
+    if (budget > 0)
+        response.fitSize(budget - ID_BYTES - CryptoBox::MAC_BYTES);
+}
+
 std::string DHT::toString() const {
     std::string str {};
 
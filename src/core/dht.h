@@ -174,6 +174,7 @@ private:
     void onAnnouncePeer(const Sp<Message>&);
 
     void populateClosestNodes(Sp<LookupResponse> r, const Id& target, int v4, int v6);
+    void fitResponse(LookupResponse& response);
 
 private:
     Type type;
@@ -185,7 +186,7 @@ private:
     SocketAddress addr;
 
     RoutingTable routingTable {*this};
-    TaskManager taskMan {};
+    TaskManager taskMan;
 
     std::vector<Sp<NodeInfo>> bootstrapNodes = {};
     std::map<SocketAddress, Id> knownNodes = {};
@@ -25,6 +25,7 @@
 #include "utils/list.h"
 #include "kbucket.h"
 #include "messages/message.h"
+#include "rpccall.h"
 
 namespace elastos {
 namespace carrier {
@@ -157,7 +158,7 @@ void KBucket::_notifyOfResponse(Sp<Message>& msg) {
 
     for (auto& entry: getEntries()) {
         if (entry->getId() == msg->getId()) {
-            entry->signalResponse();
+            entry->signalResponse(msg->getAssociatedCall()->getRTT());
             return;
         }
     }
@@ -59,6 +59,9 @@ void KBucketEntry::merge(Sp<KBucketEntry> other) {
 
     if (other->getFailedRequests() > 0)
         failedRequests = std::min(failedRequests, other->getFailedRequests());
+
+    if (other->rtt.getSamples() > rtt.getSamples())
+        rtt = other->rtt;
 }
 
 bool KBucketEntry::withinBackoffWindow(uint64_t now) const {
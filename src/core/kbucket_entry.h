@@ -28,6 +28,7 @@
 #include "carrier/node_info.h"
 #include "utils/time.h"
 #include "constants.h"
+#include "rtt_estimator.h"
 
 namespace elastos {
 namespace carrier {
@@ -128,6 +129,15 @@ public:
         reachable = true;
     }
 
+    void signalResponse(int rtt) noexcept {
+        signalResponse();
+        this->rtt.update(rtt);
+    }
+
+    const RTTEstimator& getRTTEstimator() const noexcept {
+        return rtt;
+    }
+
     void signalRequest() noexcept {
         lastSend = currentTimeMillis();
     }
@@ -183,6 +193,8 @@ private:
 
     bool reachable {false};
     int failedRequests {0};
+
+    RTTEstimator rtt {};
 };
 
 } // namespace carrier
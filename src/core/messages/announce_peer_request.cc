@@ -25,50 +25,56 @@
 
 #include "crypto/hex.h"
 #include "announce_peer_request.h"
-#include "serializers.h"
 
 namespace elastos {
 namespace carrier {
 
-void AnnouncePeerRequest::serializeInternal(nlohmann::json& root) const {
-    nlohmann::json object = {
-        {Message::KEY_REQ_TOKEN, token},
-        {Message::KEY_REQ_TARGET, peerId},
-        {Message::KEY_REQ_PORT, port},
-        {Message::KEY_REQ_SIGNATURE, nlohmann::json::binary_t {signature}}
-    };
-
-    if (nodeId != getId()) {
-        object[Message::KEY_REQ_PROXY_ID] = nodeId;
-    }
+void AnnouncePeerRequest::serializeInternal(CborWriter& writer) const {
+    bool delegated = nodeId != getId();
 
+    // alt, p, sig, t, tok, x
+    writer.writeMap(4 + !alternativeURL.empty() + delegated);
     if (!alternativeURL.empty()) {
-        object[Message::KEY_REQ_ALT] = alternativeURL;
+        writer.writeText(Message::KEY_REQ_ALT);
+        writer.writeText(alternativeURL);
+    }
+    writer.writeText(Message::KEY_REQ_PORT);
+    writer.writeInteger(port);
+    writer.writeText(Message::KEY_REQ_SIGNATURE);
+    writer.writeBytes(signature);
+    writer.writeText(Message::KEY_REQ_TARGET);
+    writer.writeBytes(peerId.blob());
+    writer.writeText(Message::KEY_REQ_TOKEN);
+    writer.writeInteger(token);
+    if (delegated) {
+        writer.writeText(Message::KEY_REQ_PROXY_ID);
+        writer.writeBytes(nodeId.blob());
     }
-
-    Message::serializeInternal(root);
-    root[getKeyString()] = object;
 }
 
-void AnnouncePeerRequest::parse(const std::string& fieldName, nlohmann::json& object) {
-    if (fieldName != Message::KEY_REQUEST || !object.is_object())
+void AnnouncePeerRequest::parse(std::string_view fieldName, CborReader& reader) {
+    if (fieldName != Message::KEY_REQUEST || !reader.isMap())
         throw std::invalid_argument("Invalid " + std::to_string((int)getMethod()) + "reqeust message");
 
-    for (const auto& [key, value] : object.items()) {
-        if (key == Message::KEY_REQ_TARGET)
-            value.get_to(peerId);
-        else if(key == Message::KEY_REQ_PROXY_ID)
-            value.get_to(nodeId);
-        else if(key == Message::KEY_REQ_PORT)
-            value.get_to(port);
-        else if(key == Message::KEY_REQ_ALT)
-            value.get_to(alternativeURL);
-        else if(key == Message::KEY_REQ_SIGNATURE)
-            signature = value.get_binary();
-        else if(key == Message::KEY_REQ_TOKEN)
-            value.get_to(token);
-        else
-            throw std::invalid_argument("Invalid message with unkown key: " + key);
+    auto object = reader.enterMap();
+    while (reader.hasNext(object)) {
+        auto key = reader.readText();
+        if (key == Message::KEY_REQ_TARGET) {
+            peerId = Id(reader.readBytes());
+        } else if(key == Message::KEY_REQ_PROXY_ID) {
+            nodeId = Id(reader.readBytes());
+        } else if(key == Message::KEY_REQ_PORT) {
+            port = (uint16_t)reader.readInteger();
+        } else if(key == Message::KEY_REQ_ALT) {
+            alternativeURL = reader.readText();
+        } else if(key == Message::KEY_REQ_SIGNATURE) {
+            auto bytes = reader.readBytes();
+            signature.assign(bytes.cbegin(), bytes.cend());
+        } else if(key == Message::KEY_REQ_TOKEN) {
+            token = (int)reader.readInteger();
+        } else {
+            throw std::invalid_argument("Invalid message with unkown key: " + std::string(key));
+        }
     }
 }
 
@@ -74,8 +74,11 @@ public:
     int estimateSize() const override;
 
 protected:
-    void serializeInternal(nlohmann::json& root) const override;
-    void parse(const std::string& fieldName, nlohmann::json& object) override;
+    bool hasBody() const override {
+        return true;
+    }
+    void serializeInternal(CborWriter& writer) const override;
+    void parse(std::string_view fieldName, CborReader& reader) override;
     void toString(std::stringstream& ss) const override;
 
 private:
@@ -27,24 +27,25 @@
 namespace elastos {
 namespace carrier {
 
-void ErrorMessage::serializeInternal(nlohmann::json& root) const {
-    nlohmann::json object = {
-        {Message::KEY_ERR_CODE, code},
-        {Message::KEY_ERR_MESSAGE, message}
-    };
-    Message::serializeInternal(root);
-    root[getKeyString()] = object;
+void ErrorMessage::serializeInternal(CborWriter& writer) const {
+    writer.writeMap(2);
+    writer.writeText(Message::KEY_ERR_CODE);
+    writer.writeInteger(code);
+    writer.writeText(Message::KEY_ERR_MESSAGE);
+    writer.writeText(message);
 }
 
-void ErrorMessage::parse(const std::string& fieldName, nlohmann::json& object) {
-    if (fieldName != Message::KEY_ERROR || !object.is_object())
+void ErrorMessage::parse(std::string_view fieldName, CborReader& reader) {
+    if (fieldName != Message::KEY_ERROR || !reader.isMap())
         throw std::invalid_argument("Invalid request message");
 
-    for (const auto& [key, value]: object.items()) {
+    auto object = reader.enterMap();
+    while (reader.hasNext(object)) {
+        auto key = reader.readText();
         if (key == Message::KEY_ERR_CODE) {
-            value.get_to(code);
+            code = (int)reader.readInteger();
         } else if(key == Message::KEY_ERR_MESSAGE) {
-            value.get_to(message);
+            message = reader.readText();
         } else {
             throw std::invalid_argument("Invalid " + getMethodString() + " request message");
         }
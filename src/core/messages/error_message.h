@@ -22,7 +22,6 @@
 
 #pragma once
 
-#include <nlohmann/json.hpp>
 #include "message.h"
 
 namespace elastos {
@@ -50,8 +49,11 @@ public:
     }
 
 protected:
-    void serializeInternal(nlohmann::json& root) const override;
-    void parse(const std::string& fieldName, nlohmann::json& object) override;
+    bool hasBody() const override {
+        return true;
+    }
+    void serializeInternal(CborWriter& writer) const override;
+    void parse(std::string_view fieldName, CborReader& reader) override;
     void toString(std::stringstream& ss) const override;
 
 private:
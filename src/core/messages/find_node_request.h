@@ -46,6 +46,11 @@ public:
     bool doesWantToken() const override {
         return LookupRequest::doesWantToken();
     }
+
+protected:
+    bool hasCompactForm() const override {
+        return true;
+    }
 };
 
 } // namespace carrier
@@ -31,6 +31,11 @@ class FindNodeResponse : public LookupResponse {
 public:
     FindNodeResponse(int txid) : LookupResponse(Message::Method::FIND_NODE, txid) {}
     FindNodeResponse() : FindNodeResponse(0) {}
+
+protected:
+    bool hasCompactForm() const override {
+        return true;
+    }
 };
 
 }
@@ -22,7 +22,6 @@
 
 #include <sstream>
 
-#include "serializers.h"
 #include "find_peer_response.h"
 
 namespace elastos {
@@ -43,57 +42,103 @@ int FindPeerResponse::estimateSize() const {
     return size;
 }
 
-void FindPeerResponse::_serialize(nlohmann::json& json) const {
-    if (peers.empty())
-        return;
-
-    auto array = nlohmann::json::array();
-    array.push_back(peers.front().getId());
-    for (const auto& peer: peers) {
-        auto ar = nlohmann::json::array();
-        ar.push_back(peer.getNodeId());
-        if (peer.isDelegated())
-            ar.push_back(peer.getOrigin());
-        else
-            ar.push_back(nullptr);
-        ar.push_back(peer.getPort());
-        if (peer.hasAlternativeURL())
-            ar.push_back(peer.getAlternativeURL());
+bool FindPeerResponse::fitSize(int maxSize) {
+    // the peers are the answer, one is kept at least
+    while (estimateSize() > maxSize && peers.size() > 1)
+        peers.pop_back();
+
+    return LookupResponse::fitSize(maxSize);
+}
+
+bool FindPeerResponse::verifySignatures() const {
+    Signature::BatchVerifier batch;
+    for (const auto& peer : peers)
+        peer.addTo(batch);
+
+    bool valid = batch.verify();
+    invalidPeers = batch.getFailures();
+    return valid;
+}
+
+std::list<PeerInfo> FindPeerResponse::getValidPeers() {
+    if (isSignatureValid())
+        return peers;
+
+    std::list<PeerInfo> valid {};
+    size_t index = 0;
+    auto invalid = invalidPeers.cbegin();
+    for (const auto& peer : peers) {
+        if (invalid != invalidPeers.cend() && *invalid == index)
+            ++invalid;
         else
-            ar.push_back(nullptr);
-        ar.push_back(nlohmann::json::binary_t(peer.getSignature()));
+            valid.push_back(peer);
+        index++;
+    }
+
+    return valid;
+}
+
+void FindPeerResponse::serializeInternal(CborWriter& writer) const {
+    // n4, n6, p, tok
+    writer.writeMap(getLookupEntries() + !peers.empty());
+    serializeNodes(writer);
 
-        array.push_back(ar);
+    if (!peers.empty()) {
+        writer.writeText(Message::KEY_RES_PEERS);
+        writer.writeArray(peers.size() + 1);
+        writer.writeBytes(peers.front().getId().blob());
+        for (const auto& peer: peers) {
+            writer.writeArray(5);
+            writer.writeBytes(peer.getNodeId().blob());
+            if (peer.isDelegated())
+                writer.writeBytes(peer.getOrigin().blob());
+            else
+                writer.writeNull();
+            writer.writeInteger(peer.getPort());
+            if (peer.hasAlternativeURL())
+                writer.writeText(peer.getAlternativeURL());
+            else
+                writer.writeNull();
+            writer.writeBytes(peer.getSignature());
+        }
     }
 
-    json[Message::KEY_RES_PEERS] = array;
+    serializeToken(writer);
 }
 
-void FindPeerResponse::_parse(const std::string& fieldName, nlohmann::json& object) {
-    if (!object.is_array())
+void FindPeerResponse::_parse(std::string_view fieldName, CborReader& reader) {
+    if (!reader.isArray())
         throw std::invalid_argument("Invalid response peers message");
 
     if (fieldName != KEY_RES_PEERS)
         throw std::invalid_argument("invalid find peer response message");
 
     Blob peerId {};
-    for (nlohmann::json::iterator it = object.begin(); it != object.end(); ++it) {
-        if (!it->is_array()) {
-            peerId = it->get_binary();
+    auto array = reader.enterArray();
+    while (reader.hasNext(array)) {
+        if (!reader.isArray()) {
+            peerId = reader.readBytes();
         } else {
-            auto id = it->at(0).get_binary();
+            auto peer = reader.enterArray();
+            reader.expectNext(peer);
+            auto id = reader.readBytes();
 
+            reader.expectNext(peer);
             Blob origin {};
-            if (!it->at(1).is_null())
-                origin =it->at(1).get_binary();
+            if (!reader.readNull())
+                origin = reader.readBytes();
 
-            auto port = it->at(2).get<uint16_t>();
+            reader.expectNext(peer);
+            auto port = (uint16_t)reader.readInteger();
 
+            reader.expectNext(peer);
             std::string alt {};
-            if (!it->at(3).is_null())
-                alt = it->at(3).get<std::string>();
+            if (!reader.readNull())
+                alt = reader.readText();
 
-            auto sig = it->at(4).get_binary();
+            reader.expectNext(peer);
+            auto sig = reader.readBytes();
+            reader.skipRemaining(peer);
 
             auto pi = PeerInfo::of(peerId, {}, id, origin, port, alt, sig);
             peers.emplace_back(pi);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <list>
+#include <vector>
 #include "lookup_response.h"
 #include "carrier/peer_info.h"
 
@@ -46,15 +47,21 @@ public:
         return !peers.empty();
     }
 
+    // The peers with a valid signature, checked once with the message
+    std::list<PeerInfo> getValidPeers();
+
     int estimateSize() const override;
+    bool fitSize(int maxSize) override;
 
 protected:
-    void _serialize(nlohmann::json& json) const override;
-    void _parse(const std::string& fieldName, nlohmann::json& object) override;
+    void serializeInternal(CborWriter& writer) const override;
+    void _parse(std::string_view fieldName, CborReader& reader) override;
     void _toString(std::stringstream& ss) const override;
+    bool verifySignatures() const override;
 
 private:
     std::list<PeerInfo> peers {};
+    mutable std::vector<size_t> invalidPeers {};    // positions in peers
 };
 
 }
@@ -20,21 +20,27 @@
  * SOFTWARE.
  */
 
+#include <sstream>
+
 #include "find_value_request.h"
 
 namespace elastos {
 namespace carrier {
 
-void FindValueRequest::_serialize(nlohmann::json& object) const {
-    if (sequenceNumber >= 0)
-        object[Message::KEY_RES_SEQ] = sequenceNumber;
+void FindValueRequest::serializeInternal(CborWriter& writer) const {
+    writer.writeMap(sequenceNumber >= 0 ? 3 : 2);
+    if (sequenceNumber >= 0) {
+        writer.writeText(Message::KEY_RES_SEQ);
+        writer.writeInteger(sequenceNumber);
+    }
+    serializeLookup(writer);
 }
 
-void FindValueRequest::_parse(const std::string& fieldName, nlohmann::json& object) {
+void FindValueRequest::_parse(std::string_view fieldName, CborReader& reader) {
     if (fieldName != Message::KEY_RES_SEQ)
-        throw std::invalid_argument(std::string("Unknown field: ") + fieldName);
+        throw std::invalid_argument(std::string("Unknown field: ") + std::string(fieldName));
 
-    object.get_to(sequenceNumber);
+    sequenceNumber = (int)reader.readInteger();
 }
 
 void FindValueRequest::_toString(std::stringstream& ss) const {
@@ -50,8 +50,8 @@ public:
     }
 
 protected:
-    void _serialize(nlohmann::json& object) const override;
-    void _parse(const std::string& fieldName, nlohmann::json &object) override;
+    void serializeInternal(CborWriter& writer) const override;
+    void _parse(std::string_view fieldName, CborReader& reader) override;
     void _toString(std::stringstream& ss) const override;
 
 private:
@@ -20,11 +20,8 @@
  * SOFTWARE.
  */
 
-#include <nlohmann/json.hpp>
-
 #include "crypto/hex.h"
 #include "message.h"
-#include "serializers.h"
 #include "find_value_response.h"
 
 namespace elastos {
@@ -49,39 +46,65 @@ Value FindValueResponse::getValue() const {
         signature.has_value() ? signature.value(): Blob(), Blob(value));
 }
 
-void FindValueResponse::_serialize(nlohmann::json& object) const {
-    if (publicKey.has_value()) {
-        object[Message::KEY_RES_PUBLICKEY] = publicKey.value();
-
-        if (recipient.has_value())
-            object[Message::KEY_RES_RECIPIENT] = recipient.value();
+bool FindValueResponse::verifySignatures() const {
+    return value.empty() || getValue().isValid();
+}
 
-        object[Message::KEY_RES_NONCE] = nlohmann::json::binary_t {{nonce.value().cbegin(), nonce.value().cend()}};
-        if (sequenceNumber >= 0)
-            object[Message::KEY_RES_SEQ] = sequenceNumber;
+void FindValueResponse::serializeInternal(CborWriter& writer) const {
+    bool hasPublicKey = publicKey.has_value();
+    int entries = getLookupEntries() + !value.empty();
+    if (hasPublicKey)
+        entries += 3 + recipient.has_value() + (sequenceNumber >= 0);
+
+    // k, n, n4, n6, rec, seq, sig, tok, v
+    writer.writeMap(entries);
+    if (hasPublicKey) {
+        writer.writeText(Message::KEY_RES_PUBLICKEY);
+        writer.writeBytes(publicKey.value().blob());
+        writer.writeText(Message::KEY_RES_NONCE);
+        writer.writeBytes(nonce.value().blob());
+    }
 
-        object[Message::KEY_RES_SIGNATURE] = nlohmann::json::binary_t {signature.value()};
+    serializeNodes(writer);
+
+    if (hasPublicKey) {
+        if (recipient.has_value()) {
+            writer.writeText(Message::KEY_RES_RECIPIENT);
+            writer.writeBytes(recipient.value().blob());
+        }
+        if (sequenceNumber >= 0) {
+            writer.writeText(Message::KEY_RES_SEQ);
+            writer.writeInteger(sequenceNumber);
+        }
+        writer.writeText(Message::KEY_RES_SIGNATURE);
+        writer.writeBytes(signature.value());
     }
 
-    if (!value.empty())
-        object[Message::KEY_RES_VALUE] = nlohmann::json::binary_t {value};
+    serializeToken(writer);
+
+    if (!value.empty()) {
+        writer.writeText(Message::KEY_RES_VALUE);
+        writer.writeBytes(value);
+    }
 }
 
-void FindValueResponse::_parse(const std::string& fieldName, nlohmann::json& object) {
+void FindValueResponse::_parse(std::string_view fieldName, CborReader& reader) {
     if (fieldName == Message::KEY_RES_PUBLICKEY) {
-        publicKey = object.get<Id>();
+        publicKey = Id(reader.readBytes());
     } else if (fieldName == Message::KEY_RES_RECIPIENT) {
-        recipient = object.get<Id>();
+        recipient = Id(reader.readBytes());
     } else if (fieldName == Message::KEY_RES_NONCE) {
-        nonce = CryptoBox::Nonce(Blob(object.get_binary()));
+        nonce = CryptoBox::Nonce(reader.readBytes(CryptoBox::Nonce::BYTES));
     } else if (fieldName == Message::KEY_RES_SEQ) {
-        sequenceNumber = object.get<int>();
+        sequenceNumber = (int)reader.readInteger();
     } else if (fieldName == Message::KEY_RES_SIGNATURE) {
-        signature = object.get_binary();
+        auto bytes = reader.readBytes();
+        signature = std::vector<uint8_t>(bytes.cbegin(), bytes.cend());
     } else if (fieldName == Message::KEY_RES_VALUE) {
-        value = object.get_binary();
+        auto bytes = reader.readBytes();
+        value.assign(bytes.cbegin(), bytes.cend());
     } else {
-        throw std::invalid_argument("Unknown field: " + fieldName);
+        throw std::invalid_argument("Unknown field: " + std::string(fieldName));
     }
 }
 
@@ -56,9 +56,10 @@ public:
     }
 
 protected:
-    void _serialize(nlohmann::json& object) const override;
-    void _parse(const std::string& field, nlohmann::json& object) override;
+    void serializeInternal(CborWriter& writer) const override;
+    void _parse(std::string_view field, CborReader& reader) override;
     void _toString(std::stringstream& ss) const override;
+    bool verifySignatures() const override;
 
 private:
     std::optional<Id> publicKey {};
@@ -22,7 +22,6 @@
 
 #include <sstream>
 
-#include "serializers.h"
 #include "lookup_request.h"
 
 namespace elastos {
@@ -38,32 +37,45 @@ void LookupRequest::setWant(int want) {
     wantToken = (want & 0x04);
 }
 
-void LookupRequest::serializeInternal(nlohmann::json& root) const {
-    nlohmann::json json = {
-        {Message::KEY_REQ_TARGET, target},
-        {Message::KEY_REQ_WANT, getWant()}
-    };
-    _serialize(json);
+void LookupRequest::serializeLookup(CborWriter& writer) const {
+    writer.writeText(Message::KEY_REQ_TARGET);
+    writer.writeBytes(target.blob());
+    writer.writeText(Message::KEY_REQ_WANT);
+    writer.writeInteger(getWant());
+}
 
-    Message::serializeInternal(root);
-    root[getKeyString()] = json;
+void LookupRequest::serializeInternal(CborWriter& writer) const {
+    writer.writeMap(2);
+    serializeLookup(writer);
 }
 
-void LookupRequest::parse(const std::string& fieldName, nlohmann::json& object) {
-    if (fieldName != Message::KEY_REQUEST || !object.is_object())
+void LookupRequest::parse(std::string_view fieldName, CborReader& reader) {
+    if (fieldName != Message::KEY_REQUEST || !reader.isMap())
         throw std::invalid_argument("Invalid request message");
 
-    for (const auto& [key, value]: object.items()) {
+    auto object = reader.enterMap();
+    while (reader.hasNext(object)) {
+        auto key = reader.readText();
         if (key == Message::KEY_REQ_TARGET) {
-            value.get_to(target);
+            target = Id(reader.readBytes());
         } else if(key == Message::KEY_REQ_WANT) {
-            setWant(value.get<int>());
+            setWant((int)reader.readInteger());
         } else {
-            _parse(key, value);
+            _parse(key, reader);
         }
     }
 }
 
+void LookupRequest::serializeCompact(CompactWriter& writer) const {
+    writer.writeBytes(target.blob());
+    writer.writeUInt8(getWant());
+}
+
+void LookupRequest::parseCompact(CompactReader& reader) {
+    target = Id(reader.readBytes(Id::BYTES));
+    setWant(reader.readUInt8());
+}
+
 #ifdef MSG_PRINT_DETAIL
 void LookupRequest::toString(std::stringstream& ss) const {
     ss << "\n" << "Request: \n    Target: " << target << "\n    Want: "
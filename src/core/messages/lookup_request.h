@@ -70,10 +70,22 @@ protected:
     int getWant() const;
     void setWant(int want);
 
-    virtual void _serialize(nlohmann::json& root) const {}
-    void serializeInternal(nlohmann::json& root) const override;
-    virtual void _parse(const std::string& fieldName, nlohmann::json &object) {}
-    void parse(const std::string& fieldName, nlohmann::json &object) override;
+    bool hasBody() const override {
+        return true;
+    }
+
+    // Writes the target and want entries, "t" and "w" sort after the others
+    void serializeLookup(CborWriter& writer) const;
+    void serializeInternal(CborWriter& writer) const override;
+
+    virtual void _parse(std::string_view fieldName, CborReader& reader) {
+        reader.skip();
+    }
+    void parse(std::string_view fieldName, CborReader& reader) override;
+
+    // The target and the want flags, for the subclasses having a compact form
+    void serializeCompact(CompactWriter& writer) const override;
+    void parseCompact(CompactReader& reader) override;
 
     virtual void _toString(std::stringstream& ss) const {}
     void toString(std::stringstream &ss) const override;
@@ -21,9 +21,10 @@
 */
 
 #include <sstream>
+#include <algorithm>
 
 #include "lookup_response.h"
-#include "serializers.h"
+#include "utils/object_pool.h"
 
 namespace elastos {
 namespace carrier {
@@ -54,56 +55,131 @@ int LookupResponse::estimateSize() const {
     return size;
 }
 
-void LookupResponse::serializeInternal(nlohmann::json& root) const {
-    nlohmann::json object = nlohmann::json::object();
-    for (const auto& pair: {
-        std::make_pair(std::ref(KEY_RES_NODES4), std::ref(nodes4)),
-        std::make_pair(std::ref(KEY_RES_NODES6), std::ref(nodes6))
-    }) {
-        if (!pair.second.empty())
-            serializeNodes(object, pair.first, pair.second);
+bool LookupResponse::fitSize(int maxSize) {
+    while (estimateSize() > maxSize && !(nodes4.empty() && nodes6.empty())) {
+        // keep both families as long as possible, trim the longer list first
+        auto& nodes = nodes4.size() > nodes6.size() ? nodes4 : nodes6;
+        nodes.pop_back();
     }
 
-    if (token != 0)
-        object[KEY_RES_TOKEN] = token;
+    return estimateSize() <= maxSize;
+}
+
+void LookupResponse::serializeNodes(CborWriter& writer) const {
+    if (!nodes4.empty())
+        serializeNodes(writer, KEY_RES_NODES4, nodes4);
+    if (!nodes6.empty())
+        serializeNodes(writer, KEY_RES_NODES6, nodes6);
+}
 
-    _serialize(object);
-    Message::serializeInternal(root);
-    root[getKeyString()] = object;
+void LookupResponse::serializeToken(CborWriter& writer) const {
+    if (token != 0) {
+        writer.writeText(KEY_RES_TOKEN);
+        writer.writeInteger(token);
+    }
+}
+
+void LookupResponse::serializeInternal(CborWriter& writer) const {
+    writer.writeMap(getLookupEntries());
+    serializeNodes(writer);
+    serializeToken(writer);
 }
 
-void LookupResponse::parse(const std::string& fieldName, nlohmann::json& object) {
-    if (fieldName != KEY_RESPONSE || !object.is_object())
+void LookupResponse::parse(std::string_view fieldName, CborReader& reader) {
+    if (fieldName != KEY_RESPONSE || !reader.isMap())
         throw std::invalid_argument("Invalid lookup response message");
 
-    for (const auto& [key, value] : object.items()) {
+    auto object = reader.enterMap();
+    while (reader.hasNext(object)) {
+        auto key = reader.readText();
         if (key == KEY_RES_NODES4) {
-            parseNodes(value, nodes4);
+            parseNodes(reader, nodes4);
         } else if (key == KEY_RES_NODES6) {
-            parseNodes(value, nodes6);
+            parseNodes(reader, nodes6);
         } else if (key == KEY_RES_TOKEN) {
-            value.get_to(token);
+            token = (int)reader.readInteger();
         } else {
-            _parse(key, value);
+            _parse(key, reader);
         }
     }
 }
 
-void LookupResponse::serializeNodes(nlohmann::json& object, const std::string& fieldName, const std::list<Sp<NodeInfo>>& nodes) const {
-    nlohmann::json jsonNodes;
+void LookupResponse::serializeNodes(CborWriter& writer, const std::string& fieldName, const std::list<Sp<NodeInfo>>& nodes) {
+    writer.writeText(fieldName);
+    writer.writeArray(nodes.size());
     for (const auto& node: nodes) {
-        jsonNodes.push_back(*node);
+        const auto& addr = node->getAddress();
+        writer.writeArray(3);
+        writer.writeBytes(node->getId().blob());
+        writer.writeBytes({addr.inaddr(), addr.inaddrLength()});
+        writer.writeInteger(addr.port());
     }
-
-    object[fieldName] = jsonNodes;
 }
 
-void LookupResponse::parseNodes(const nlohmann::json &object, std::list<Sp<NodeInfo>>& nodes) {
-    if (!object.is_array())
+void LookupResponse::parseNodes(CborReader& reader, std::list<Sp<NodeInfo>>& nodes) {
+    if (!reader.isArray())
         throw std::invalid_argument("Invalid response nodes message");
 
-    for (const auto& elem : object) {
-        nodes.emplace_back(std::make_shared<NodeInfo>(elem.get<NodeInfo>()));
+    auto array = reader.enterArray();
+    while (reader.hasNext(array)) {
+        auto node = reader.enterArray();
+        reader.expectNext(node);
+        auto id = reader.readBytes();
+        reader.expectNext(node);
+        auto ip = reader.readBytes();
+        reader.expectNext(node);
+        auto port = (int)reader.readInteger();
+        reader.skipRemaining(node);
+
+        nodes.emplace_back(makePooled<NodeInfo>(id, ip, port));
+    }
+}
+
+/*
+ * The token, then the IPv4 and the IPv6 nodes, each list as a count byte
+ * followed by the id, the address and the port of the nodes.
+ */
+void LookupResponse::serializeCompact(CompactWriter& writer) const {
+    writer.writeUInt32(token);
+    serializeCompactNodes(writer, nodes4, 4);
+    serializeCompactNodes(writer, nodes6, 16);
+}
+
+void LookupResponse::parseCompact(CompactReader& reader) {
+    token = (int)reader.readUInt32();
+    parseCompactNodes(reader, nodes4, 4);
+    parseCompactNodes(reader, nodes6, 16);
+}
+
+void LookupResponse::serializeCompactNodes(CompactWriter& writer, const std::list<Sp<NodeInfo>>& nodes, size_t addrLength) {
+    // the address length is implied by the list, skip the misplaced ones
+    auto matches = [addrLength](const Sp<NodeInfo>& node) {
+        return node->getAddress().inaddrLength() == addrLength;
+    };
+    auto count = std::min<size_t>(std::count_if(nodes.cbegin(), nodes.cend(), matches), 255);
+
+    writer.writeUInt8((uint8_t)count);
+    for (const auto& node: nodes) {
+        if (count == 0)
+            break;
+        if (!matches(node))
+            continue;
+
+        const auto& addr = node->getAddress();
+        writer.writeBytes(node->getId().blob());
+        writer.writeBytes({addr.inaddr(), addrLength});
+        writer.writeUInt16(addr.port());
+        count--;
+    }
+}
+
+void LookupResponse::parseCompactNodes(CompactReader& reader, std::list<Sp<NodeInfo>>& nodes, size_t addrLength) {
+    int count = reader.readUInt8();
+    for (int i = 0; i < count; i++) {
+        auto id = reader.readBytes(Id::BYTES);
+        auto ip = reader.readBytes(addrLength);
+        auto port = reader.readUInt16();
+        nodes.emplace_back(makePooled<NodeInfo>(id, ip, port));
     }
 }
 
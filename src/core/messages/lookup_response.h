@@ -61,18 +61,46 @@ public:
 
     int estimateSize() const override;
 
+    /*
+     * Drops the farthest nodes until the estimated size fits in maxSize,
+     * the node lists are ordered by the distance to the target. Returns
+     * false if the message still doesn't fit.
+     */
+    virtual bool fitSize(int maxSize);
+
 protected:
-    virtual void _serialize(nlohmann::json& json) const {}
-    virtual void _parse(const std::string& fieldName, nlohmann::json &object) {}
+    virtual void _parse(std::string_view fieldName, CborReader& reader) {
+        reader.skip();
+    }
     virtual void _toString(std::stringstream& str) const {}
 
-    void serializeInternal(nlohmann::json& root) const override;
-    void parse(const std::string& fieldName, nlohmann::json& object) override;
+    bool hasBody() const override {
+        return true;
+    }
+
+    // The entries written by serializeNodes() and serializeToken()
+    int getLookupEntries() const {
+        return !nodes4.empty() + !nodes6.empty() + (token != 0);
+    }
+
+    // "n4" and "n6", the subclasses interleave their own fields by the key order
+    void serializeNodes(CborWriter& writer) const;
+    // "tok"
+    void serializeToken(CborWriter& writer) const;
+
+    void serializeInternal(CborWriter& writer) const override;
+    void parse(std::string_view fieldName, CborReader& reader) override;
     void toString(std::stringstream& str) const override;
 
+    // The token and the node lists, for the subclasses having a compact form
+    void serializeCompact(CompactWriter& writer) const override;
+    void parseCompact(CompactReader& reader) override;
+
 private:
-    void serializeNodes(nlohmann::json &object, const std::string& fieldName, const std::list<Sp<NodeInfo>>& nodes) const;
-    void parseNodes(const nlohmann::json &object, std::list<Sp<NodeInfo>>& nodes);
+    static void serializeNodes(CborWriter& writer, const std::string& fieldName, const std::list<Sp<NodeInfo>>& nodes);
+    static void parseNodes(CborReader& reader, std::list<Sp<NodeInfo>>& nodes);
+    static void serializeCompactNodes(CompactWriter& writer, const std::list<Sp<NodeInfo>>& nodes, size_t addrLength);
+    static void parseCompactNodes(CompactReader& reader, std::list<Sp<NodeInfo>>& nodes, size_t addrLength);
 
     std::list<Sp<NodeInfo>> nodes4 {};
     std::list<Sp<NodeInfo>> nodes6 {};
@@ -34,6 +34,7 @@
 #include "find_peer_response.h"
 #include "find_value_response.h"
 #include "store_value_response.h"
+#include "utils/object_pool.h"
 
 namespace elastos {
 namespace carrier {
@@ -125,7 +126,7 @@ const std::string& Message::getKeyString() const {
     return keyMap[getType()];
 }
 
-const std::string& Message::getTypeString() const {
+const std::string& Message::typeString(Type type) {
     static std::unordered_map<Message::Type, std::string> nameMap = {
 #ifdef MSG_PRINT_DETAIL
         { Type::REQUEST, "request" },
@@ -137,10 +138,10 @@ const std::string& Message::getTypeString() const {
         { Type::ERR, KEY_ERROR }
 #endif
     };
-    return nameMap[getType()];
+    return nameMap[type];
 }
 
-const std::string& Message::getMethodString() const {
+const std::string& Message::methodString(Method method) {
     static std::unordered_map<Message::Method, std::string> nameMap = {
         { Method::UNKNOWN, "unknown" },
         { Method::PING, "ping" },
@@ -150,68 +151,117 @@ const std::string& Message::getMethodString() const {
         { Method::STORE_VALUE, "store_value" },
         { Method::FIND_VALUE, "find_value" }
     };
-    return nameMap[getMethod()];
+    return nameMap[method];
+}
+
+bool Message::supportsCompact(int version) {
+    static const int name = []() {
+        auto shortName = Constants::NODE_SHORT_NAME;
+        return Version::build(shortName, 0);
+    }();
+
+    return (version & 0xffff0000) == name && (version & 0xffff) >= COMPACT_MIN_VERSION;
 }
 
 Sp<Message> Message::parse(const uint8_t* buf, size_t buflen) {
-    auto root = nlohmann::json::from_cbor(std::vector<uint8_t>{buf, buf + buflen});
-    if (!root.is_object())
+    if (buflen > 0 && buf[0] == COMPACT_FORMAT)
+        return parseCompact(buf, buflen);
+
+    CborReader reader(buf, buflen);
+    if (!reader.isMap())
         throw std::runtime_error("Invalid message: not a CBOR object");
 
-    auto type = root.find(KEY_TYPE);
-    if (type == root.end()) {
-        throw std::runtime_error("Invalid message: missing type field");
+    // The sorted keys put the body before the type, look the type up first
+    int type = -1;
+    {
+        CborReader scanner(reader);
+        auto root = scanner.enterMap();
+        while (scanner.hasNext(root)) {
+            if (scanner.readText() == KEY_TYPE) {
+                type = (uint8_t)scanner.readInteger();
+                break;
+            }
+            scanner.skip();
+        }
     }
 
-    auto message = Message::createMessage(type->get<uint8_t>());
-    for (const auto& [key, value]: root.items()) {
+    if (type < 0)
+        throw std::runtime_error("Invalid message: missing type field");
+
+    auto message = Message::createMessage(type);
+    auto root = reader.enterMap();
+    while (reader.hasNext(root)) {
+        auto key = reader.readText();
         if (key == KEY_TXID) {
-            value.get_to(message->txid);
+            message->txid = (int)reader.readInteger();
         } else if (key == KEY_VERSION) {
-            value.get_to(message->version);
+            message->version = (int)reader.readInteger();
         } else if (key == KEY_REQUEST || key == KEY_RESPONSE || key == KEY_ERROR) {
-            message->parse(key, value);
+            message->parse(key, reader);
+        } else {
+            reader.skip();
         }
     }
+
+    if (!reader.atEnd())
+        throw std::runtime_error("Invalid message: unexpected trailing data");
+
     return message;
 }
 
-Sp<Message> Message::createMessage(int messageType) {
-    static const std::map<Method, std::function<Sp<Message>()>> reqFactory = {
-        { Method::PING, []{ return std::make_shared<PingRequest>(); }},
-        { Method::FIND_NODE, []{ return std::make_shared<FindNodeRequest>(); }},
-        { Method::ANNOUNCE_PEER, []{ return std::make_shared<AnnouncePeerRequest>(); }},
-        { Method::FIND_PEER, []{ return std::make_shared<FindPeerRequest>(); }},
-        { Method::STORE_VALUE, []{ return std::make_shared<StoreValueRequest>(); }},
-        { Method::FIND_VALUE, []{ return std::make_shared<FindValueRequest>(); }}
-    };
-    static const std::map<Method, std::function<Sp<Message>()>> rspFactory = {
-        { Method::PING, []{ return std::make_shared<PingResponse>(); }},
-        { Method::FIND_NODE, []{ return std::make_shared<FindNodeResponse>(); }},
-        { Method::ANNOUNCE_PEER, []{ return std::make_shared<AnnouncePeerResponse>(); }},
-        { Method::FIND_PEER, []{ return std::make_shared<FindPeerResponse>(); }},
-        { Method::STORE_VALUE, []{ return std::make_shared<StoreValueResponse>(); }},
-        { Method::FIND_VALUE, []{ return std::make_shared<FindValueResponse>(); }}
-    };
+/*
+ * The compact layout: the format byte, the type byte, the txid and the
+ * version as 32 bits integers, then the body of the message type.
+ */
+Sp<Message> Message::parseCompact(const uint8_t* buf, size_t buflen) {
+    CompactReader reader(buf, buflen);
+    reader.readUInt8();
+
+    auto message = Message::createMessage(reader.readUInt8());
+    if (!message->hasCompactForm())
+        throw std::runtime_error("Invalid message: no compact form for " + message->getMethodString());
+
+    message->txid = (int)reader.readUInt32();
+    message->version = (int)reader.readUInt32();
+    message->parseCompact(reader);
+    message->compact = true;
+
+    if (!reader.atEnd())
+        throw std::runtime_error("Invalid message: unexpected trailing data");
 
+    return message;
+}
+
+// The parsed messages rarely outlive the packet handling, they come from the object pools
+Sp<Message> Message::createMessage(int messageType) {
     auto type = ofType(messageType);
     auto method = ofMethod(messageType);
 
     switch (type) {
-    case Type::REQUEST: {
-        auto reqCreator = reqFactory.find(method);
-        if (reqCreator == reqFactory.end())
+    case Type::REQUEST:
+        switch (method) {
+        case Method::PING:          return makePooled<PingRequest>();
+        case Method::FIND_NODE:     return makePooled<FindNodeRequest>();
+        case Method::ANNOUNCE_PEER: return makePooled<AnnouncePeerRequest>();
+        case Method::FIND_PEER:     return makePooled<FindPeerRequest>();
+        case Method::STORE_VALUE:   return makePooled<StoreValueRequest>();
+        case Method::FIND_VALUE:    return makePooled<FindValueRequest>();
+        default:
             throw std::invalid_argument("Invalid request method: " + std::to_string(static_cast<int>(method)));
-        return reqCreator->second();
-    }
-    case Type::RESPONSE: {
-        auto rspCreator = rspFactory.find(method);
-        if (rspCreator == rspFactory.end())
+        }
+    case Type::RESPONSE:
+        switch (method) {
+        case Method::PING:          return makePooled<PingResponse>();
+        case Method::FIND_NODE:     return makePooled<FindNodeResponse>();
+        case Method::ANNOUNCE_PEER: return makePooled<AnnouncePeerResponse>();
+        case Method::FIND_PEER:     return makePooled<FindPeerResponse>();
+        case Method::STORE_VALUE:   return makePooled<StoreValueResponse>();
+        case Method::FIND_VALUE:    return makePooled<FindValueResponse>();
+        default:
             throw std::invalid_argument("Invalid response method: " + std::to_string(static_cast<int>(method)));
-        return rspCreator->second();
-    }
+        }
     case Type::ERR: {
-        return std::make_shared<ErrorMessage>(method);
+        return makePooled<ErrorMessage>(method);
     }
     default: {
         throw std::invalid_argument("INTERNAL ERROR: should never happen.");
@@ -252,19 +302,41 @@ Message::operator std::string() const {
 }
 #endif
 
-void Message::serializeInternal(nlohmann::json& root) const {
-    root[KEY_TYPE] = type;
-    root[KEY_TXID] = txid;
-    root[KEY_VERSION] = version;
+std::vector<uint8_t> Message::serialize() const {
+    std::vector<uint8_t> buffer {};
+    buffer.reserve(estimateSize());
+    serialize(buffer);
+    return buffer;
 }
 
-std::vector<uint8_t> Message::serialize() const {
-    nlohmann::json root = nlohmann::json::object();
-    serializeInternal(root);
-    return nlohmann::json::to_cbor(root);
+void Message::serialize(std::vector<uint8_t>& buffer) const {
+    if (isCompact()) {
+        CompactWriter writer(buffer);
+        writer.writeUInt8(COMPACT_FORMAT);
+        writer.writeUInt8(type);
+        writer.writeUInt32(txid);
+        writer.writeUInt32(version);
+        serializeCompact(writer);
+        return;
+    }
+
+    CborWriter writer(buffer);
+
+    // the body keys "e", "q" and "r" sort before the others
+    bool body = hasBody();
+    writer.writeMap(body ? 4 : 3);
+    if (body) {
+        writer.writeText(getKeyString());
+        serializeInternal(writer);
+    }
+
+    writer.writeText(KEY_TXID);
+    writer.writeInteger(txid);
+    writer.writeText(KEY_VERSION);
+    writer.writeInteger(version);
+    writer.writeText(KEY_TYPE);
+    writer.writeInteger(type);
 }
 
 }
 }
-
-
@@ -24,13 +24,18 @@
 
 #include <vector>
 #include <memory>
-#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <string_view>
 #include <map>
 
 #include "constants.h"
+#include "utils/cbor.h"
+#include "utils/compact.h"
 #include "carrier/socket_address.h"
 #include "carrier/id.h"
 #include "carrier/version.h"
+#include "utils/log.h"
 
 // #define MSG_PRINT_DETAIL 1
 
@@ -87,6 +92,11 @@ public:
 
     static const int BASE_SIZE = 56;
 
+    // first byte of the compact encoded messages, never a valid CBOR message head
+    static const int COMPACT_FORMAT = 0x02;
+    // the node version of this implementation from which the compact encoding is understood
+    static const int COMPACT_MIN_VERSION = 2;
+
 public:
     enum class Method {
         UNKNOWN     = 0x00,
@@ -112,8 +122,24 @@ public:
         return ofType(type);
     }
 
-    const std::string& getMethodString() const;
-    const std::string& getTypeString() const;
+    const std::string& getMethodString() const {
+        return methodString(getMethod());
+    }
+
+    const std::string& getTypeString() const {
+        return typeString(getType());
+    }
+
+    // the type byte packs the type and the method
+    int getTypeBits() const {
+        return type;
+    }
+
+    static Type ofType(int messageType);
+    static Method ofMethod(int messageType);
+
+    static const std::string& methodString(Method method);
+    static const std::string& typeString(Type type);
     const std::string& getKeyString() const;
 
     void setId(const Id& id) noexcept {
@@ -173,11 +199,42 @@ public:
         return associatedCall;
     }
 
+    /*
+     * Checks the signatures of the values or peers carried by the message,
+     * the result is kept. The RPC server checks them on its crypto workers,
+     * the DHT thread then gets the result without verifying again.
+     */
+    bool isSignatureValid() {
+        if (signatureState == SignatureState::UNCHECKED)
+            signatureState = verifySignatures() ? SignatureState::VALID : SignatureState::INVALID;
+
+        return signatureState == SignatureState::VALID;
+    }
+
+    /*
+     * The compact encoding replaces the CBOR map by a fixed binary layout
+     * for the hot methods, PING and FIND_NODE. It's only used with the
+     * peers advertising a version that understands it, the other messages
+     * are always CBOR encoded.
+     */
+    void setCompact(bool compact) noexcept {
+        this->compact = compact;
+    }
+
+    bool isCompact() const {
+        return compact && hasCompactForm();
+    }
+
+    static bool supportsCompact(int version);
+
     static Sp<Message> parse(const uint8_t* buf, size_t buflen);
 
     operator std::string() const;
     std::vector<uint8_t> serialize() const;
 
+    // Appends the serialized message to the buffer
+    void serialize(std::vector<uint8_t>& buffer) const;
+
     virtual int estimateSize() const {
         return BASE_SIZE;
     }
@@ -199,14 +256,36 @@ protected:
 
     // explicit Message(const Message&) = delete;
 
-    virtual void parse(const std::string& fieldName, nlohmann::json& object) {}
+    /*
+     * The body of the message is written under the key of its type, the
+     * messages without one only carry the type, the txid and the version.
+     * The body is a map, its keys must be written in the byte-wise sorted
+     * order to stay byte compatible with the JSON based encoding.
+     */
+    virtual bool hasBody() const {
+        return false;
+    }
+    virtual void serializeInternal(CborWriter& writer) const {}
+
+    // Parses the value of the top level field, the reader is positioned on it
+    virtual void parse(std::string_view fieldName, CborReader& reader) {
+        reader.skip();
+    }
+    virtual bool verifySignatures() const {
+        return true;
+    }
     virtual void toString(std::stringstream& ss) const {}
-    virtual void serializeInternal(nlohmann::json& root) const;
+
+    // The body of the compact form, behind the type, the txid and the version
+    virtual bool hasCompactForm() const {
+        return false;
+    }
+    virtual void serializeCompact(CompactWriter& writer) const {}
+    virtual void parseCompact(CompactReader& reader) {}
 
 private:
     static Sp<Message> createMessage(int type);
-    static Type ofType(int messageType);
-    static Method ofMethod(int messageType);
+    static Sp<Message> parseCompact(const uint8_t* buf, size_t buflen);
 
     static const int MSG_TYPE_MASK;
     static const int MSG_METHOD_MASK;
@@ -219,10 +298,35 @@ private:
 
     RPCCall* associatedCall = nullptr;
 
+    enum class SignatureState {
+        UNCHECKED,
+        VALID,
+        INVALID
+    };
+    SignatureState signatureState {SignatureState::UNCHECKED};
+
     int type {0};
     int txid {0};
     int version {0};
+    bool compact {false};
 };
 
 } // namespace carrier
 } // namespace elastos
+
+/*
+ * Formats the messages only when the log record is emitted, pass the message
+ * itself rather than static_cast<std::string>(*msg) to the loggers.
+ */
+template <typename T>
+struct fmt::formatter<T, char, std::enable_if_t<std::is_base_of_v<elastos::carrier::Message, T>>> {
+    constexpr auto parse(format_parse_context& ctx) -> decltype(ctx.begin()) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const elastos::carrier::Message& msg, FormatContext& ctx) const -> decltype(ctx.out()) {
+        auto str = static_cast<std::string>(msg);
+        return std::copy(str.begin(), str.end(), ctx.out());
+    }
+};
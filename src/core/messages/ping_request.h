@@ -30,6 +30,11 @@ namespace carrier {
 class PingRequest : public Message {
 public:
     PingRequest() : Message(Message::Type::REQUEST, Message::Method::PING) {}
+
+protected:
+    bool hasCompactForm() const override {
+        return true;
+    }
 };
 
 } // namespace carrier
@@ -32,6 +32,11 @@ public:
     PingResponse(int txid)
         : Message(Message::Type::RESPONSE, Message::Method::PING, txid) {}
     PingResponse(): PingResponse(0) {}
+
+protected:
+    bool hasCompactForm() const override {
+        return true;
+    }
 };
 
 }
@@ -23,7 +23,6 @@
 #include <sstream>
 
 #include "crypto/hex.h"
-#include "serializers.h"
 #include "store_value_request.h"
 
 namespace elastos {
@@ -48,51 +47,71 @@ Value StoreValueRequest::getValue() const {
         signature.has_value() ? signature.value() : Blob(), value);
 }
 
-void StoreValueRequest::serializeInternal(nlohmann::json& root) const {
-    nlohmann::json object = nlohmann::json::object();
+bool StoreValueRequest::verifySignatures() const {
+    return getValue().isValid();
+}
+
+void StoreValueRequest::serializeInternal(CborWriter& writer) const {
+    int entries = 2;
+    if (isMutable())
+        entries += 3 + isEncrypted() + (sequenceNumber >= 0) + (expectedSequenceNumber >= 0);
 
-    object[Message::KEY_REQ_TOKEN] = token;
+    // cas, k, n, rec, seq, sig, tok, v
+    writer.writeMap(entries);
     if (isMutable()) {
-        object[Message::KEY_REQ_PUBLICKEY] = publicKey.value();
-        if (isEncrypted())
-            object[Message::KEY_REQ_RECIPIENT] = recipient.value();
-        object[Message::KEY_REQ_NONCE] = nlohmann::json::binary_t {{nonce.value().cbegin(), nonce.value().cend()}};
-        object[Message::KEY_REQ_SIGNATURE] = nlohmann::json::binary_t {signature.value()};
-        if (sequenceNumber >= 0)
-            object[Message::KEY_REQ_SEQ] = sequenceNumber;
-        if (expectedSequenceNumber >= 0)
-            object[Message::KEY_REQ_CAS] = expectedSequenceNumber;
+        if (expectedSequenceNumber >= 0) {
+            writer.writeText(Message::KEY_REQ_CAS);
+            writer.writeInteger(expectedSequenceNumber);
+        }
+        writer.writeText(Message::KEY_REQ_PUBLICKEY);
+        writer.writeBytes(publicKey.value().blob());
+        writer.writeText(Message::KEY_REQ_NONCE);
+        writer.writeBytes(nonce.value().blob());
+        if (isEncrypted()) {
+            writer.writeText(Message::KEY_REQ_RECIPIENT);
+            writer.writeBytes(recipient.value().blob());
+        }
+        if (sequenceNumber >= 0) {
+            writer.writeText(Message::KEY_REQ_SEQ);
+            writer.writeInteger(sequenceNumber);
+        }
+        writer.writeText(Message::KEY_REQ_SIGNATURE);
+        writer.writeBytes(signature.value());
     }
 
-    object[Message::KEY_REQ_VALUE] = nlohmann::json::binary_t {value};
-
-    Message::serializeInternal(root);
-    root[getKeyString()] = object;
+    writer.writeText(Message::KEY_REQ_TOKEN);
+    writer.writeInteger(token);
+    writer.writeText(Message::KEY_REQ_VALUE);
+    writer.writeBytes(value);
 }
 
-void StoreValueRequest::parse(const std::string& fieldName, nlohmann::json& object) {
-    if (fieldName != Message::KEY_REQUEST || !object.is_object())
+void StoreValueRequest::parse(std::string_view fieldName, CborReader& reader) {
+    if (fieldName != Message::KEY_REQUEST || !reader.isMap())
         throw std::invalid_argument("Invalid request message");
 
-    for (const auto& [key, object] : object.items()) {
+    auto object = reader.enterMap();
+    while (reader.hasNext(object)) {
+        auto key = reader.readText();
         if (key == Message::KEY_REQ_PUBLICKEY) {
-            publicKey = object.get<Id>();
+            publicKey = Id(reader.readBytes());
         } else if (key == Message::KEY_REQ_RECIPIENT) {
-            recipient = object.get<Id>();
+            recipient = Id(reader.readBytes());
         } else if (key == Message::KEY_REQ_NONCE) {
-            nonce = CryptoBox::Nonce(Blob(object.get_binary()));
+            nonce = CryptoBox::Nonce(reader.readBytes(CryptoBox::Nonce::BYTES));
         } else if (key == Message::KEY_REQ_SIGNATURE) {
-           signature = object.get_binary();
+            auto bytes = reader.readBytes();
+            signature = std::vector<uint8_t>(bytes.cbegin(), bytes.cend());
         } else if (key == Message::KEY_REQ_SEQ) {
-            sequenceNumber = object.get<uint16_t>();
+            sequenceNumber = (int)reader.readInteger();
         } else if (key == Message::KEY_REQ_CAS) {
-            object.get_to(expectedSequenceNumber);
+            expectedSequenceNumber = (int)reader.readInteger();
         } else if (key == Message::KEY_REQ_TOKEN) {
-            object.get_to(token);
+            token = (int)reader.readInteger();
         } else if (key == Message::KEY_RES_VALUE) {
-            value = object.get_binary();
+            auto bytes = reader.readBytes();
+            value.assign(bytes.cbegin(), bytes.cend());
         } else {
-            throw std::invalid_argument("Unknown field: " + key);
+            throw std::invalid_argument("Unknown field: " + std::string(key));
         }
     }
 }
@@ -80,8 +80,12 @@ public:
     }
 
 protected:
-    void serializeInternal(nlohmann::json& root) const override;
-    void parse(const std::string& fieldName, nlohmann::json& object) override;
+    bool hasBody() const override {
+        return true;
+    }
+    void serializeInternal(CborWriter& writer) const override;
+    void parse(std::string_view fieldName, CborReader& reader) override;
+    bool verifySignatures() const override;
     void toString(std::stringstream& str) const override;
 
 private:
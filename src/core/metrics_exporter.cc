@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef HAVE_METRICS_EXPORTER
+#include <httplib.h>
+#endif
+
+#include "utils/metrics.h"
+#include "metrics_exporter.h"
+
+namespace elastos {
+namespace carrier {
+
+#ifdef HAVE_METRICS_EXPORTER
+
+MetricsExporter::MetricsExporter(int port): port(port) {
+    log = Logger::get("MetricsExporter");
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::isAvailable() {
+    return true;
+}
+
+bool MetricsExporter::start() {
+    server = std::make_unique<httplib::Server>();
+    server->Get("/metrics", [](const httplib::Request&, httplib::Response& response) {
+        response.set_content(Metrics::scrape(), "text/plain; version=0.0.4");
+    });
+
+    if (!server->bind_to_port("127.0.0.1", port)) {
+        log->error("Failed to bind the metrics endpoint to 127.0.0.1:{}", port);
+        server.reset();
+        return false;
+    }
+
+    thread = std::thread([this]() {
+        server->listen_after_bind();
+    });
+
+    log->info("Metrics endpoint listening on http://127.0.0.1:{}/metrics", port);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (server == nullptr)
+        return;
+
+    server->stop();
+    if (thread.joinable())
+        thread.join();
+
+    server.reset();
+}
+
+#else
+
+MetricsExporter::MetricsExporter(int port): port(port) {
+    log = Logger::get("MetricsExporter");
+}
+
+MetricsExporter::~MetricsExporter() {
+}
+
+bool MetricsExporter::isAvailable() {
+    return false;
+}
+
+bool MetricsExporter::start() {
+    log->warn("Metrics endpoint on port {} ignored, the library is built without ENABLE_METRICS", port);
+    return false;
+}
+
+void MetricsExporter::stop() {
+}
+
+#endif
+
+} // namespace carrier
+} // namespace elastos
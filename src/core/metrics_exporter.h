@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <memory>
+#include <thread>
+
+#include "utils/log.h"
+
+namespace httplib {
+class Server;
+}
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Serves the metrics registry in the Prometheus text format on GET /metrics.
+ * The HTTP server runs on its own thread and is only bound to the loopback
+ * address, the scrapes never touch the DHT thread. Requires the library built
+ * with ENABLE_METRICS, otherwise start() only logs a warning.
+ */
+class MetricsExporter {
+public:
+    MetricsExporter(int port);
+    ~MetricsExporter();
+
+    bool start();
+    void stop();
+
+    static bool isAvailable();
+
+private:
+    int port;
+#ifdef HAVE_METRICS_EXPORTER
+    std::unique_ptr<httplib::Server> server {};
+    std::thread thread {};
+#endif
+
+    Sp<Logger> log;
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -32,6 +32,8 @@
 #include "carrier/node_status.h"
 #include "exceptions/state_error.h"
 #include "sqlite_storage.h"
+#include "metrics_exporter.h"
+#include "stage_tracer.h"
 #include "crypto_cache.h"
 #include "dht.h"
 
@@ -256,6 +258,12 @@ void Node::start() {
         persistentAnnounce();
     }, 60000, Constants::RE_ANNOUNCE_INTERVAL);
     scheduledActions.emplace_back(job);
+
+    if (config->metricsPort() > 0) {
+        metricsExporter = std::make_shared<MetricsExporter>(config->metricsPort());
+        if (!metricsExporter->start())
+            metricsExporter.reset();
+    }
 }
 
 void Node::stop() {
@@ -264,16 +272,21 @@ void Node::stop() {
 
     log->info("Carrier Kademlia node {} is stopping...", static_cast<std::string>(id));
 
+    if (metricsExporter != nullptr) {
+        metricsExporter->stop();
+        metricsExporter.reset();
+    }
+
+    // the scheduler is not thread safe, cancel the jobs once the server is stopped
+    if (server != nullptr)
+        server->stop();
+
     for (auto any : scheduledActions) {
         auto job = std::any_cast<Sp<Scheduler::Job>>(any);
         job->cancel();
     }
     scheduledActions.clear();
-
-    if (server != nullptr) {
-        server->stop();
-        server.reset();
-    }
+    server.reset();
 
     if (dht4 != nullptr) {
         dht4->stop();
@@ -589,22 +602,22 @@ void Node::setupCryptoBoxesCache() {
 
 std::vector<uint8_t> Node::encrypt(const Id& recipient, const Blob& plain) const {
     auto ctx = cryptoContexts->get(recipient);
-    return ctx.encrypt(plain);
+    return ctx->encrypt(plain);
 }
 
 std::vector<uint8_t> Node::decrypt(const Id& sender, const Blob& cipher) const {
     auto ctx = cryptoContexts->get(sender);
-    return ctx.decrypt(cipher);
+    return ctx->decrypt(cipher);
 }
 
 void Node::encrypt(const Id& recipient, Blob& cipher, const Blob& plain) const {
     auto ctx = cryptoContexts->get(recipient);
-    ctx.encrypt(cipher, plain);
+    ctx->encrypt(cipher, plain);
 }
 
 void Node::decrypt(const Id& sender, Blob& plain, const Blob& cipher) const {
     auto ctx = cryptoContexts->get(sender);
-    ctx.decrypt(plain, cipher);
+    ctx->decrypt(plain, cipher);
 }
 
 std::vector<uint8_t> Node::sign(const Blob& data) const {
@@ -624,6 +637,15 @@ Sp<DHT> Node::getDHT(int type) const noexcept {
     return type == DHT::Type::IPV4 ? dht4 : dht6;
 }
 
+void Node::dumpTrace(std::ostream& out) const {
+    if (server != nullptr)
+        server->dumpTrace(out);
+}
+
+void Node::dumpStageTrace(std::ostream& out) const {
+    StageTracer::dumpChromeTrace(out);
+}
+
 std::string Node::toString() const {
     std::string str {};
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "packet_capture.h"
+
+namespace elastos {
+namespace carrier {
+
+static const char MAGIC[] = { 'C', 'C', 'A', 'P' };
+static const uint8_t FLAG_OUTBOUND = 0x01;
+static const uint8_t FLAG_IPV6 = 0x02;
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static void putBigEndian(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--)
+        out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+static bool getByte(std::ifstream& in, uint8_t& byte) {
+    char c;
+    if (!in.get(c))
+        return false;
+    byte = (uint8_t)c;
+    return true;
+}
+
+static void getBytes(std::ifstream& in, uint8_t* data, size_t size) {
+    if (size > 0 && !in.read((char*)data, size))
+        throw std::runtime_error("Truncated capture record");
+}
+
+static uint64_t getVarint(std::ifstream& in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte;
+        if (!getByte(in, byte))
+            throw std::runtime_error("Truncated capture record");
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw std::runtime_error("Malformed capture record");
+}
+
+static uint64_t getBigEndian(std::ifstream& in, int bytes) {
+    uint8_t data[8];
+    getBytes(in, data, bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+uint64_t PacketCapture::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+PacketCapture::PacketCapture(const std::string& path, const Id& nodeId)
+    : out(path, std::ios::binary | std::ios::trunc) {
+    if (!out)
+        throw std::runtime_error("Can't create the capture file " + path);
+
+    last = now();
+    buffer.insert(buffer.end(), std::begin(MAGIC), std::end(MAGIC));
+    buffer.push_back(VERSION);
+    buffer.insert(buffer.end(), nodeId.cbegin(), nodeId.cbegin() + ID_BYTES);
+    putBigEndian(buffer, last, 8);
+    out.write((const char*)buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+PacketCapture::~PacketCapture() {
+    flush();
+}
+
+void PacketCapture::write(Direction direction, const SocketAddress& peer, const uint8_t* data, size_t size,
+        uint64_t timestamp) {
+    std::lock_guard<std::mutex> lk(lock);
+
+    uint8_t flags = direction == Direction::OUTBOUND ? FLAG_OUTBOUND : 0;
+    if (peer.family() == AF_INET6)
+        flags |= FLAG_IPV6;
+
+    buffer.push_back(flags);
+    putVarint(buffer, timestamp > last ? timestamp - last : 0);
+    buffer.insert(buffer.end(), peer.inaddr(), peer.inaddr() + peer.inaddrLength());
+    putBigEndian(buffer, peer.port(), 2);
+    putVarint(buffer, size);
+    out.write((const char*)buffer.data(), buffer.size());
+    out.write((const char*)data, size);
+    buffer.clear();
+
+    last = std::max(last, timestamp);
+    records++;
+}
+
+void PacketCapture::flush() {
+    std::lock_guard<std::mutex> lk(lock);
+    out.flush();
+}
+
+PacketCaptureReader::PacketCaptureReader(const std::string& path)
+    : in(path, std::ios::binary) {
+    if (!in)
+        throw std::runtime_error("Can't open the capture file " + path);
+
+    char magic[sizeof(MAGIC)];
+    uint8_t version;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)
+            || !getByte(in, version))
+        throw std::runtime_error(path + " is not a capture file");
+    if (version != PacketCapture::VERSION)
+        throw std::runtime_error("Unsupported capture file version " + std::to_string(version));
+
+    std::array<uint8_t, ID_BYTES> id;
+    getBytes(in, id.data(), id.size());
+    nodeId = Id({id.data(), id.size()});
+    startTime = last = getBigEndian(in, 8);
+}
+
+bool PacketCaptureReader::next(PacketCapture::Record& record) {
+    uint8_t flags;
+    if (!getByte(in, flags))
+        return false;
+
+    record.direction = (flags & FLAG_OUTBOUND) ? PacketCapture::Direction::OUTBOUND : PacketCapture::Direction::INBOUND;
+    last += getVarint(in);
+    record.timestamp = last;
+
+    uint8_t addr[16];
+    size_t addrLength = (flags & FLAG_IPV6) ? 16 : 4;
+    getBytes(in, addr, addrLength);
+    auto port = (in_port_t)getBigEndian(in, 2);
+    record.peer = SocketAddress({addr, addrLength}, port);
+
+    auto size = getVarint(in);
+    if (size > 65535)
+        throw std::runtime_error("Malformed capture record");
+    record.data.resize(size);
+    getBytes(in, record.data.data(), size);
+    return true;
+}
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+#include "carrier/def.h"
+#include "carrier/id.h"
+#include "carrier/socket_address.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * The capture file of the datagrams of the RPC server, to reproduce the real
+ * traffic locally. The file starts with the magic "CCAP", the format version,
+ * the id of the capturing node and the time of the capture start, then the
+ * records follow:
+ *
+ *   flags  | time delta | address    | port    | length | datagram
+ *   1 byte | varint, us | 4/16 bytes | 2 bytes | varint | length bytes
+ *
+ * The flags are the direction and the address family, the time is relative
+ * to the previous record and the integers are big endian. The datagrams are
+ * kept as on the wire, encrypted for the node key, so they can only be
+ * replayed against a node with the same key.
+ */
+class CARRIER_PUBLIC PacketCapture {
+public:
+    enum class Direction : uint8_t {
+        INBOUND = 0,
+        OUTBOUND = 1
+    };
+
+    struct Record {
+        Direction direction {Direction::INBOUND};
+        uint64_t timestamp {0};         // us since the epoch
+        SocketAddress peer {};
+        std::vector<uint8_t> data {};
+    };
+
+    static constexpr uint8_t VERSION = 1;
+
+    // Creates the file, throws a std::runtime_error if it can't
+    PacketCapture(const std::string& path, const Id& nodeId);
+    ~PacketCapture();
+
+    PacketCapture(const PacketCapture&) = delete;
+    PacketCapture& operator=(const PacketCapture&) = delete;
+
+    // Appends a record, safe to call from any thread
+    void write(Direction direction, const SocketAddress& peer, const uint8_t* data, size_t size,
+            uint64_t timestamp = now());
+
+    void flush();
+
+    uint64_t getRecords() const {
+        return records;
+    }
+
+    static uint64_t now() noexcept;
+
+private:
+    std::mutex lock;
+    std::ofstream out;
+    std::vector<uint8_t> buffer {};
+    uint64_t last {0};
+    uint64_t records {0};
+};
+
+/*
+ * Reads the records of a capture file in order.
+ */
+class CARRIER_PUBLIC PacketCaptureReader {
+public:
+    // Throws a std::runtime_error if the file can't be read or isn't a capture
+    explicit PacketCaptureReader(const std::string& path);
+
+    const Id& getNodeId() const noexcept {
+        return nodeId;
+    }
+
+    uint64_t getStartTime() const noexcept {
+        return startTime;
+    }
+
+    // Reads the next record, false at the end of the file. Throws a
+    // std::runtime_error on a truncated or malformed record.
+    bool next(PacketCapture::Record& record);
+
+private:
+    std::ifstream in;
+    Id nodeId {};
+    uint64_t startTime {0};
+    uint64_t last {0};
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdexcept>
+
+#include "utils/time.h"
+#include "packet_replay.h"
+
+namespace elastos {
+namespace carrier {
+
+PacketReplay::PacketReplay(const std::string& path) : reader(path) {
+}
+
+SocketAddress PacketReplay::bind(const SocketAddress& addr, Listener& listener) {
+    std::lock_guard<std::mutex> lk(lock);
+    this->listener = &listener;
+    endpoints++;
+    return addr;
+}
+
+void PacketReplay::unbind(const SocketAddress& bound) {
+    std::lock_guard<std::mutex> lk(lock);
+    if (endpoints > 0 && --endpoints == 0)
+        listener = nullptr;
+}
+
+int PacketReplay::send(const SocketAddress& from, const uint8_t* data, size_t size, const SocketAddress& to) {
+    sent++;
+    sentBytes += size;
+    return (int)size;
+}
+
+void PacketReplay::wakeup(Listener& listener) {
+    std::lock_guard<std::mutex> lk(lock);
+    woken = true;
+    cond.notify_one();
+}
+
+void PacketReplay::stop() {
+    std::lock_guard<std::mutex> lk(lock);
+    running = false;
+    cond.notify_one();
+}
+
+void PacketReplay::poll() {
+    deadline = listener->onPoll();
+}
+
+/*
+ * Runs the jobs of the server due before the next datagram.
+ */
+void PacketReplay::waitUntil(Clock::time_point due) {
+    while (running && Clock::now() < due) {
+        auto next = due;
+        if (deadline != NO_DEADLINE) {
+            auto now = currentTimeMillis();
+            auto job = Clock::now() + std::chrono::milliseconds(deadline > now ? deadline - now : 0);
+            next = std::min(next, job);
+        }
+
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lk(lock);
+            cond.wait_until(lk, next, [this]() { return woken || !running; });
+            wake = woken;
+            woken = false;
+        }
+
+        if (wake || (deadline != NO_DEADLINE && currentTimeMillis() >= deadline))
+            poll();
+    }
+}
+
+PacketReplay::Stats PacketReplay::run(double speed) {
+    if (listener == nullptr)
+        throw std::runtime_error("No node started on the replay");
+
+    Stats stats {};
+    running = true;
+    auto start = Clock::now();
+    uint64_t first = 0;
+    bool started = false;
+
+    poll();
+
+    PacketCapture::Record record {};
+    while (running && reader.next(record)) {
+        if (record.direction == PacketCapture::Direction::OUTBOUND) {
+            stats.skipped++;
+            continue;
+        }
+
+        if (!started) {
+            first = record.timestamp;
+            started = true;
+        }
+
+        if (speed > 0.0) {
+            auto offset = (double)(record.timestamp - first) / speed;
+            waitUntil(start + std::chrono::microseconds((uint64_t)offset));
+        }
+
+        listener->onReceive(record.data.data(), record.data.size(), record.peer);
+        poll();
+        stats.replayed++;
+    }
+
+    running = false;
+    stats.sent = sent;
+    stats.sentBytes = sentBytes;
+    stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    return stats;
+}
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+#include "carrier/def.h"
+#include "packet_capture.h"
+#include "transport.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Replays a capture against a node: a transport to set on a node started
+ * with the key of the capturing one. run() feeds the inbound datagrams of the
+ * capture through the RPC server at the original pace, or faster by the
+ * speed factor, and runs the jobs of the server in between. The datagrams
+ * the node sends are counted and dropped, the captured peers are never
+ * contacted, so the responses to the captured requests of the node don't
+ * match any call of the replaying node. The admission filter of the node
+ * runs on the real clock, turn it off on the replaying node, or the
+ * accelerated replays measure the filter shedding the datagrams.
+ */
+class CARRIER_PUBLIC PacketReplay : public Transport {
+public:
+    struct Stats {
+        uint64_t replayed {0};      // the inbound datagrams fed to the node
+        uint64_t skipped {0};       // the outbound records of the capture
+        uint64_t sent {0};          // the datagrams sent by the node
+        uint64_t sentBytes {0};
+        uint64_t elapsed {0};       // ms
+    };
+
+    // Throws a std::runtime_error if the file isn't a capture
+    explicit PacketReplay(const std::string& path);
+
+    const Id& getNodeId() const noexcept {
+        return reader.getNodeId();
+    }
+
+    // Replays the capture on the calling thread, speed 0 as fast as possible.
+    // The node must be started on this transport.
+    Stats run(double speed = 1.0);
+
+    // Interrupts run(), safe to call from any thread
+    void stop();
+
+    SocketAddress bind(const SocketAddress& addr, Listener& listener) override;
+    void unbind(const SocketAddress& bound) override;
+    int send(const SocketAddress& from, const uint8_t* data, size_t size, const SocketAddress& to) override;
+    void wakeup(Listener& listener) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitUntil(Clock::time_point due);
+    void poll();
+
+    PacketCaptureReader reader;
+
+    std::mutex lock;
+    std::condition_variable cond;
+    Listener* listener {nullptr};
+    int endpoints {0};
+    bool woken {false};
+    std::atomic_bool running {false};
+    uint64_t deadline {NO_DEADLINE};
+
+    std::atomic<uint64_t> sent {0};
+    std::atomic<uint64_t> sentBytes {0};
+};
+
+} // namespace carrier
+} // namespace elastos
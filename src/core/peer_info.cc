@@ -135,5 +135,9 @@ bool PeerInfo::isValid() const {
    return Signature::verify(getSignData(), signature, pk);
 }
 
+void PeerInfo::addTo(Signature::BatchVerifier& batch) const {
+    batch.add(getSignData(), signature, publicKey.toSignatureKey());
+}
+
 }
 }
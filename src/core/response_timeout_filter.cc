@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include "response_timeout_filter.h"
+
+namespace elastos {
+namespace carrier {
+
+void ResponseTimeoutFilter::update(int rtt) noexcept {
+    int bin = std::clamp(rtt / BIN_SIZE, 0, BINS - 1);
+    bins[bin] += 1.0f;
+
+    if (++samples % UPDATE_INTERVAL == 0 && samples >= MIN_SAMPLES)
+        updateBaseline();
+}
+
+void ResponseTimeoutFilter::reset() noexcept {
+    bins.fill(0.0f);
+    samples = 0;
+    timeoutBaseline = Constants::RPC_CALL_STALL_TIMEOUT;
+}
+
+void ResponseTimeoutFilter::updateBaseline() noexcept {
+    double total = 0;
+    for (auto count : bins)
+        total += count;
+
+    double threshold = total * PERCENTILE;
+    double accumulated = 0;
+    int bin = 0;
+    for (; bin < BINS - 1; bin++) {
+        accumulated += bins[bin];
+        if (accumulated >= threshold)
+            break;
+    }
+
+    timeoutBaseline = std::clamp((bin + 1) * BIN_SIZE,
+            Constants::RPC_CALL_TIMEOUT_BASELINE_MIN, Constants::RPC_CALL_TIMEOUT_MAX);
+
+    // age out the old samples, the network conditions change
+    for (auto& count : bins)
+        count *= DECAY;
+}
+
+} // namespace carrier
+} // namespace elastos
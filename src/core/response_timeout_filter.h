@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "constants.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Tracks the distribution of the round trip times of all the RPC calls and
+ * derives the stall timeout for the calls to nodes without their own RTT
+ * estimate. The samples are kept in a decaying histogram, the baseline is
+ * a high percentile bounded by RPC_CALL_TIMEOUT_BASELINE_MIN and
+ * RPC_CALL_TIMEOUT_MAX. Only used by the RPC server thread.
+ */
+class ResponseTimeoutFilter {
+public:
+    static const int BIN_SIZE = 10;                 // ms
+    static const int BINS = 1000;                   // covers RPC_CALL_TIMEOUT_MAX
+    static const int MIN_SAMPLES = 16;
+    static const int UPDATE_INTERVAL = 32;          // samples between the baseline updates
+    static constexpr double PERCENTILE = 0.9;
+    static constexpr double DECAY = 0.95;
+
+    void update(int rtt) noexcept;
+    void reset() noexcept;
+
+    int getStallTimeout() const noexcept {
+        return timeoutBaseline;
+    }
+
+    uint64_t getSamples() const noexcept {
+        return samples;
+    }
+
+private:
+    void updateBaseline() noexcept;
+
+    std::array<float, BINS> bins {};
+    uint64_t samples {0};
+    int timeoutBaseline {Constants::RPC_CALL_STALL_TIMEOUT};
+};
+
+} // namespace carrier
+} // namespace elastos
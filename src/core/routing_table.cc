@@ -231,6 +231,17 @@ void RoutingTable::_maintenance() {
     }
 }
 
+void RoutingTable::updateMetrics() {
+    if (entriesGauge == nullptr) {
+        auto network = dht.getType() == DHT::Type::IPV4 ? "ipv4" : "ipv6";
+        entriesGauge = &Metrics::gauge("carrier_routing_table_entries", "Nodes in the routing table", {{ "network", network }});
+        bucketsGauge = &Metrics::gauge("carrier_routing_table_buckets", "Buckets of the routing table", {{ "network", network }});
+    }
+
+    entriesGauge->set(getNumBucketEntries());
+    bucketsGauge->set(size());
+}
+
 void RoutingTable::tryPingMaintenance(Sp<KBucket> bucket, const std::vector<PingRefreshTask::Options>& options, const std::string& name) {
     assert(bucket);
     assert(!name.empty());
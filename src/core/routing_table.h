@@ -35,6 +35,7 @@
 #include "utils/random_generator.h"
 #include "utils/mtqueue.h"
 #include "utils/log.h"
+#include "utils/metrics.h"
 #include "task/ping_refresh_task.h"
 #include "kbucket.h"
 
@@ -120,6 +121,7 @@ public:
 
     void maintenance() {
         _maintenance();
+        updateMetrics();
     }
 
     void fillBuckets();
@@ -146,9 +148,15 @@ private:
      */
     void _maintenance();
 
+    void updateMetrics();
+
     DHT& dht;
     std::list<Sp<KBucket>> buckets {};
 
+    // resolved on the first update, once the DHT is fully constructed
+    Gauge* entriesGauge {nullptr};
+    Gauge* bucketsGauge {nullptr};
+
     long timeOfLastPingCheck {0};
 
     std::atomic_bool writeLock {false};
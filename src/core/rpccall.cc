@@ -23,8 +23,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <array>
 
 #include "utils/time.h"
+#include "utils/metrics.h"
 
 #include "rpccall.h"
 #include "rpcserver.h"
@@ -35,6 +37,37 @@
 namespace elastos {
 namespace carrier {
 
+static const int METRIC_METHODS = 7;
+
+// round trips of the answered calls in milliseconds, by method
+static Histogram& callLatency(Message::Method method) {
+    static auto histograms = []() {
+        std::array<Histogram*, METRIC_METHODS> histograms {};
+        for (int m = 0; m < METRIC_METHODS; m++)
+            histograms[m] = &Metrics::histogram("carrier_rpc_call_duration_seconds",
+                    "Round trip time of the answered RPC calls",
+                    {{ "method", Message::methodString(static_cast<Message::Method>(m)) }}, 1e-3);
+        return histograms;
+    }();
+
+    int m = static_cast<int>(method);
+    return *histograms[m < METRIC_METHODS ? m : 0];
+}
+
+static Counter& callTimeouts(Message::Method method) {
+    static auto counters = []() {
+        std::array<Counter*, METRIC_METHODS> counters {};
+        for (int m = 0; m < METRIC_METHODS; m++)
+            counters[m] = &Metrics::counter("carrier_rpc_call_timeouts_total",
+                    "RPC calls timed out without a response",
+                    {{ "method", Message::methodString(static_cast<Message::Method>(m)) }});
+        return counters;
+    }();
+
+    int m = static_cast<int>(method);
+    return *counters[m < METRIC_METHODS ? m : 0];
+}
+
 RPCCall::RPCCall(DHT& _dht, Sp<NodeInfo> _target, Sp<Message> _request)
     : dht(_dht), target(_target), request(_request),
     stateChangeHandler([](RPCCall*, State, State){}),
@@ -44,13 +77,19 @@ RPCCall::RPCCall(DHT& _dht, Sp<NodeInfo> _target, Sp<Message> _request)
 
     request->setRemote(target->getId(), target->getAddress());
 
+    const RTTEstimator* rtt = nullptr;
     if (auto kbEntry = std::dynamic_pointer_cast<KBucketEntry>(_target)) {
         sourceWasKnownReachable = kbEntry->isReachable();
+        rtt = &kbEntry->getRTTEstimator();
     } else if (auto candidateNode = std::dynamic_pointer_cast<CandidateNode>(_target)) {
         sourceWasKnownReachable = candidateNode->isReachable();
+        rtt = &candidateNode->getRTTEstimator();
     } else {
         sourceWasKnownReachable = false;
     }
+
+    if (rtt != nullptr && rtt->hasSamples())
+        expectedRTT = rtt->getTimeout(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN, Constants::RPC_CALL_TIMEOUT_MAX);
 }
 
 void RPCCall::updateState(State currentState) {
@@ -61,6 +100,7 @@ void RPCCall::updateState(State currentState) {
 
     switch (currentState) {
     case State::TIMEOUT:
+        callTimeouts(request->getMethod()).inc();
         timeoutHandler(this);
         break;
     case State::STALLED:
@@ -78,13 +118,13 @@ void RPCCall::sent(RPCServer* server) {
     sentTime = currentTimeMillis();
     updateState(State::SENT);
 
+    // the node's own estimate if we talked to it before, otherwise the
+    // percentile of the recent round trips of all the calls
+    if (expectedRTT == 0)
+        expectedRTT = server->getTimeoutFilter().getStallTimeout();
+
     scheduler = std::ref(server->getScheduler());
-    // spread out the stalls by +- 1ms to reduce lock contention
-    // TODO:: Improve the time
-    // int smear = ThreadLocalRandom.current().nextInt(-1000, 1000);
-    // timeoutTimer = scheduler.schedule(this::checkTimeout,
-    //         expectedRTT * 1000 + smear, TimeUnit.MICROSECONDS);
-    timeoutTimer = scheduler->get().add(std::bind(&RPCCall::checkTimeout, this), 2000);
+    timeoutTimer = scheduler->get().add(std::bind(&RPCCall::checkTimeout, this), expectedRTT);
 }
 
 void RPCCall::responsed(Sp<Message> response) {
@@ -100,6 +140,8 @@ void RPCCall::responsed(Sp<Message> response) {
 
     switch(response->getType()) {
     case Message::Type::RESPONSE:
+        if (getRTT() >= 0)
+            callLatency(request->getMethod()).record(getRTT());
         updateState(State::RESPONDED);
         break;
     case Message::Type::ERR:
@@ -90,6 +90,19 @@ public:
         return responseTime;
     }
 
+    // round trip time of the call in milliseconds, -1 if not responded
+    int getRTT() const noexcept {
+        if (responseTime == std::numeric_limits<uint64_t>::max() || responseTime < sentTime)
+            return -1;
+
+        return static_cast<int>(responseTime - sentTime);
+    }
+
+    // the stall timeout of the call, 0 before it is sent
+    int getExpectedRTT() const noexcept {
+        return expectedRTT;
+    }
+
     State getState() const noexcept {
         return state;
     }
@@ -165,6 +178,8 @@ private:
     Sp<Message> response {};
 
     bool sourceWasKnownReachable {false};
+    // stall timeout from the RTT estimate of the target node, if any
+    int expectedRTT {0};
 
     uint64_t sentTime = std::numeric_limits<uint64_t>::max();
     uint64_t responseTime = std::numeric_limits<uint64_t>::max();
@@ -34,6 +34,7 @@
 #include "exceptions/dht_error.h"
 #include "messages/message.h"
 #include "messages/error_message.h"
+#include "stage_tracer.h"
 #include "error_code.h"
 #include "constants.h"
 #include "rpcserver.h"
@@ -65,11 +66,45 @@ bool RPCServer::filterMessage(std::string name) {
 
 RPCServer::RPCServer(Node& _node, const Sp<DHT> _dht4, const Sp<DHT> _dht6): node(_node),
     dht4(_dht4 ? std::optional<std::reference_wrapper<DHT>>(*_dht4) : std::nullopt),
-    dht6(_dht6 ? std::optional<std::reference_wrapper<DHT>>(*_dht6) : std::nullopt) {
-
-    nextTxid = RandomGenerator<int>(1,32768)();
+    dht6(_dht6 ? std::optional<std::reference_wrapper<DHT>>(*_dht6) : std::nullopt),
+    calls(Constants::MAX_ACTIVE_CALLS * 2, RandomGenerator<uint32_t>(1, 32768)()) {
 
     log = Logger::get("RpcServer");
+    transport = node.getTransport();
+    numWorkers = std::max(0, node.getConfig()->rpcWorkers());
+    numCryptoWorkers = std::max(0, node.getConfig()->rpcCryptoWorkers());
+    batchSize = node.getConfig()->rpcBatchSize();
+    if (transport != nullptr) {
+        // the transport runs the whole pipeline on its thread
+        if (numWorkers > 0 || numCryptoWorkers > 0 || batchSize > 1 || node.getConfig()->rpcIoUring())
+            log->warn("The RPC workers, batched I/O and io_uring don't apply to a transport, ignored");
+        numWorkers = 0;
+        numCryptoWorkers = 0;
+        batchSize = 0;
+    }
+    if (batchSize > 1)
+        txBatch = std::make_unique<DatagramBatch>(batchSize);
+    if (node.getConfig()->rpcAdmissionControl())
+        admission = std::make_unique<AdmissionFilter>();
+    datagramBudget = std::max(0, node.getConfig()->rpcDatagramBudget());
+    if (node.getConfig()->rpcTraceCapacity() > 0)
+        trace = std::make_unique<TraceRing>(node.getConfig()->rpcTraceCapacity());
+    auto captureFile = node.getConfig()->rpcCaptureFile();
+    if (!captureFile.empty()) {
+        try {
+            capture = std::make_unique<PacketCapture>(captureFile, node.getId());
+            log->info("Capturing the RPC datagrams to {}", captureFile);
+        } catch (const std::exception& e) {
+            log->error("The RPC capture is disabled: {}", e.what());
+        }
+    }
+    initMetrics();
+
+    // jobs added from the API threads may be due before the armed timer
+    scheduler.setWakeupHandler([this]() {
+        if (std::this_thread::get_id() != ioThread.load(std::memory_order_acquire))
+            wakeup();
+    });
 
     SocketAddress bind4, bind6;
     if (_dht4 != nullptr)
@@ -77,13 +112,40 @@ RPCServer::RPCServer(Node& _node, const Sp<DHT> _dht4, const Sp<DHT> _dht6): nod
     if (_dht6 != nullptr)
         bind6 = _dht6->getOrigin();
 
+    if (transport != nullptr) {
+        bindTransport(bind4, bind6);
+        return;
+    }
+
     bindSockets(bind4, bind6);
+
+    if (node.getConfig()->rpcIoUring()) {
+        if (numWorkers > 0) {
+            log->warn("The io_uring backend doesn't work with the RPC workers, use the socket I/O");
+        } else {
+            try {
+                uring = std::make_unique<IoUring>();
+                uring->listen(sock4);
+                uring->listen(sock6);
+            } catch (const std::exception& e) {
+                log->warn("The io_uring backend is unavailable, use the socket I/O: {}", e.what());
+                uring.reset();
+            }
+        }
+    }
 }
 
 RPCServer::~RPCServer() {
     stop();
+    if (transport != nullptr)
+        closeTransport();
     if (rcv_thread.joinable())
         rcv_thread.join();
+    for (auto& worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    closeCryptoWorkers();
 }
 
 static bool setNonblocking(int fd, bool nonblocking = true)
@@ -106,7 +168,25 @@ static bool setNonblocking(int fd, bool nonblocking = true)
 #endif
 }
 
-static int bindSocket(const SocketAddress& addr, SocketAddress& bound)
+static void closeSocket(int sock)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+static int sendFlags()
+{
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+    return flags;
+}
+
+static int bindSocket(const SocketAddress& addr, SocketAddress& bound, bool reusePort = false)
 {
     int sock = socket(addr.family(), SOCK_DGRAM, 0);
     if (sock < 0)
@@ -115,6 +195,12 @@ static int bindSocket(const SocketAddress& addr, SocketAddress& bound)
     int set = 1;
 #ifdef SO_NOSIGPIPE
     setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, (char*)&set, sizeof(set));
+#endif
+#ifdef SO_REUSEPORT
+    // Let the receive workers bind their own sockets on the same address,
+    // the kernel shards the inbound datagrams by the flow hash
+    if (reusePort)
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (char*)&set, sizeof(set));
 #endif
     if (addr.family() == AF_INET6)
         setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (char*)&set, sizeof(set));
@@ -122,11 +208,7 @@ static int bindSocket(const SocketAddress& addr, SocketAddress& bound)
     setNonblocking(sock);
     int rc = bind(sock, addr.addr(), addr.length());
     if (rc < 0) {
-#if defined(_WIN32) || defined(_WIN64)
-        closesocket(sock);
-#else
-        close(sock);
-#endif
+        closeSocket(sock);
         throw std::runtime_error("Can't bind socket on " + addr.toString() + " " + std::string(std::strerror(errno)));
     }
 
@@ -149,10 +231,10 @@ int RPCServer::sendData(Sp<Message>& msg) {
     int sockfd = -1;
     switch (remoteAddr.family()) {
         case AF_INET:
-            sockfd = sock4;
+            sockfd = transport ? (bound4 ? 0 : -1) : sock4;
             break;
         case AF_INET6:
-            sockfd = sock6;
+            sockfd = transport ? (bound6 ? 0 : -1) : sock6;
             break;
         default:
             throw std::runtime_error("Unsupported address family!");
@@ -161,44 +243,215 @@ int RPCServer::sendData(Sp<Message>& msg) {
     if (sockfd < 0)
         throw std::runtime_error("Socket fd is error!!!");
 
-    int flags = 0;
-    #ifdef MSG_NOSIGNAL
-        flags |= MSG_NOSIGNAL;
-    #endif
-    #ifdef MSG_CONFIRM
-        //if (replied)
-            //flags |= MSG_CONFIRM;
-    #endif
-
-    auto buffer = msg->serialize();
-    auto encrypted = node.encrypt(msg->getRemoteId(), {buffer});
-    buffer.resize(ID_BYTES + encrypted.size());
-    std::memcpy(buffer.data(), msg->getId().data(), ID_BYTES);
-    std::memcpy(buffer.data() + ID_BYTES, encrypted.data(), encrypted.size());
-
-    int ret = sendto(sockfd, (char*)buffer.data(), buffer.size(), flags, remoteAddr.addr(), remoteAddr.length());
+    auto buffer = packetPool.acquire();
+    CARRIER_STAGE_MARK(encodeStart);
+    encodePacket(node, *msg, buffer);
+    CARRIER_STAGE_END(ENCODE, msg->getMethod(), encodeStart);
+    if (datagramBudget > 0 && buffer.size() > (size_t)datagramBudget && msg->getType() == Message::Type::RESPONSE)
+        oversizedResponses++;
+    if (capture != nullptr)
+        capture->write(PacketCapture::Direction::OUTBOUND, remoteAddr, buffer.data(), buffer.size());
+
+    if (std::this_thread::get_id() == ioThread.load(std::memory_order_acquire) && uring != nullptr) {
+        // submitted with the other requests at the end of the current loop iteration
+        size_t size = buffer.size();
+        if (uring->send(sockfd, buffer, remoteAddr)) {
+#ifdef CARRIER_STAGE_TRACING
+            uringSends.push_back(msg->getMethod());
+#endif
+            // got back the buffer of a completed send
+            packetPool.release(std::move(buffer));
+            logSent(msg, size);
+            return 0;
+        }
+    }
+
+    if (txBatch != nullptr && std::this_thread::get_id() == ioThread.load(std::memory_order_acquire)) {
+        // flushed with one sendmmsg at the end of the current I/O loop iteration
+        outbound.push_back({msg, sockfd, std::move(buffer)});
+        return 0;
+    }
+
+    CARRIER_STAGE_MARK(sendStart);
+    int ret = transport != nullptr
+            ? transport->send(getAddress(remoteAddr.family()), buffer.data(), buffer.size(), remoteAddr)
+            : sendto(sockfd, (char*)buffer.data(), buffer.size(), sendFlags(), remoteAddr.addr(), remoteAddr.length());
+    CARRIER_STAGE_END(SEND, msg->getMethod(), sendStart);
+    size_t size = buffer.size();
+    packetPool.release(std::move(buffer));
+
     if (ret == 0 || (ret == -1 && errno == EAGAIN)) {
         messageQueue.push(msg);
+        if (std::this_thread::get_id() != ioThread.load(std::memory_order_acquire))
+            wakeup();
         return EAGAIN;
     } else if (ret == -1) {
         log->debug("Failed to send message to {}: {}", remoteAddr.toString(), std::strerror(errno));
         return errno;
     } else {
-#ifdef MSG_PRINT_DETAIL
-        msg->setName(txidNames[msg->getTxid()]);
-        if (filterMessage(msg->name)) {
-            auto af = msg->getRemoteAddress().family();
-            log->debug("\n\n-- Sent: {} bytes --\nLocal: {}\nTo: {}\n{}\n-- ** --\n",
-                    ret, getAddress(af).toString(), msg->getRemoteAddress().toString(), static_cast<std::string>(*msg));
+        logSent(msg, size);
+        return 0;
+    }
+}
+
+/*
+ * The packet is the sender id in clear followed by the encrypted message.
+ * The message is serialized behind the id and MAC headroom and encrypted in
+ * place, the capacity of the buffer is reused.
+ */
+void RPCServer::encodePacket(const Node& node, Message& msg, std::vector<uint8_t>& packet) {
+    static const size_t HEADROOM = ID_BYTES + CryptoBox::MAC_BYTES;
+
+    packet.resize(HEADROOM);
+    msg.serialize(packet);
+    std::memcpy(packet.data(), msg.getId().data(), ID_BYTES);
+
+    Blob plain {packet.data() + HEADROOM, packet.size() - HEADROOM};
+    Blob cipher {packet.data() + ID_BYTES, packet.size() - ID_BYTES};
+    node.encrypt(msg.getRemoteId(), cipher, plain);
+}
+
+void RPCServer::tracePacket(TraceRing::Direction direction, Message& msg, const SocketAddress& peer, size_t size) {
+    trace->record(direction, (uint8_t)msg.getTypeBits(), msg.getTxid(), size,
+            (uint8_t)peer.family(), peer.inaddr(), peer.inaddrLength(), peer.port());
+}
+
+void RPCServer::dumpTrace(std::ostream& out) const {
+    if (trace == nullptr)
+        return;
+
+    auto records = trace->snapshot();
+    out << "# " << records.size() << " of " << trace->recorded() << " packets\n";
+    for (const auto& r : records) {
+        std::string peer = "-";
+        if (r.addressLength > 0)
+            peer = SocketAddress(Blob{r.address, r.addressLength}, r.port).toString();
+
+        out << r.timestamp
+            << (r.direction == TraceRing::Direction::SENT ? " > " : " < ")
+            << Message::methodString(Message::ofMethod(r.type)) << '/'
+            << Message::typeString(Message::ofType(r.type))
+            << " t:" << r.txid
+            << ' ' << peer
+            << ' ' << r.size << '\n';
+    }
+}
+
+void RPCServer::initMetrics() {
+    static const char* DIRECTIONS[] = { "sent", "received" };
+    static const Message::Type TYPES[] = { Message::Type::ERR, Message::Type::REQUEST, Message::Type::RESPONSE };
+
+    for (int d = 0; d < 2; d++) {
+        for (int t = 0; t < METRIC_TYPES; t++) {
+            for (int m = 0; m < METRIC_METHODS; m++) {
+                packetCounters[d][t][m] = &Metrics::counter("carrier_rpc_messages_total",
+                        "RPC messages sent and received", {
+                            { "direction", DIRECTIONS[d] },
+                            { "type", Message::typeString(TYPES[t]) },
+                            { "method", Message::methodString(static_cast<Message::Method>(m)) }
+                        });
+            }
         }
+
+        byteCounters[d] = &Metrics::counter("carrier_rpc_bytes_total",
+                "RPC datagram bytes sent and received", {{ "direction", DIRECTIONS[d] }});
+    }
+}
+
+void RPCServer::countPacket(TraceRing::Direction direction, const Message& msg, size_t size) noexcept {
+    int d = static_cast<int>(direction);
+    // the type bits are 0x00, 0x20 and 0x40
+    int t = (int)msg.getType() >> 5;
+    int m = (int)msg.getMethod();
+    if (t < METRIC_TYPES && m < METRIC_METHODS)
+        packetCounters[d][t][m]->inc();
+    byteCounters[d]->inc(size);
+}
+
+void RPCServer::logSent(const Sp<Message>& msg, size_t size) {
+    countPacket(TraceRing::Direction::SENT, *msg, size);
+
+    if (trace != nullptr)
+        tracePacket(TraceRing::Direction::SENT, *msg, msg->getRemoteAddress(), size);
+
+    // don't format the message for nothing on the send path
+    if (!log->isDebugEnabled())
+        return;
+
+#ifdef MSG_PRINT_DETAIL
+    msg->setName(txidNames[msg->getTxid()]);
+    if (filterMessage(msg->name)) {
+        auto af = msg->getRemoteAddress().family();
+        log->debug("\n\n-- Sent: {} bytes --\nLocal: {}\nTo: {}\n{}\n-- ** --\n",
+                size, getAddress(af).toString(), msg->getRemoteAddress().toString(), *msg);
+    }
 #else
-        log->debug("Sent {}/{} to {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
-                msg->getRemoteAddress().toString(), buffer.size(), static_cast<std::string>(*msg));
+    log->debug("Sent {}/{} to {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
+            msg->getRemoteAddress().toString(), size, *msg);
 #endif
-        return 0;
+}
+
+void RPCServer::flushOutbound() {
+    while (!outbound.empty()) {
+        // sendmmsg works on one socket, batch the leading packets for the same socket
+        int sockfd = outbound.front().sockfd;
+        txBatch->clear();
+        for (const auto& out : outbound) {
+            if (out.sockfd != sockfd || !txBatch->add({out.packet}, out.msg->getRemoteAddress()))
+                break;
+        }
+
+        CARRIER_STAGE_MARK(sendStart);
+        int sent = txBatch->send(sockfd, sendFlags());
+        CARRIER_STAGE_MARK(sendEnd);
+        if (sent < 0) {
+            // keep the packets queued and retry on the next iteration
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+
+            log->debug("Failed to send message to {}: {}", outbound.front().msg->getRemoteAddress().toString(),
+                    std::strerror(errno));
+            packetPool.release(std::move(outbound.front().packet));
+            outbound.pop_front();
+            continue;
+        }
+
+        sentBatches++;
+        sentDatagrams += sent;
+        for (int i = 0; i < sent; i++) {
+            // each packet of the batch took the whole sendmmsg call
+            CARRIER_STAGE_RECORD(SEND, outbound.front().msg->getMethod(), sendStart, sendEnd);
+            logSent(outbound.front().msg, outbound.front().packet.size());
+            packetPool.release(std::move(outbound.front().packet));
+            outbound.pop_front();
+        }
     }
 }
 
+int RPCServer::receiveBatch(DatagramBatch& batch, int fd,
+        const std::function<void(const Blob&, const SocketAddress&)>& handler) {
+    int total = 0;
+
+    // drain the socket, a full batch means there may be more to read
+    do {
+        int rc = batch.receive(fd);
+        if (rc <= 0) {
+            if (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                log->error("Error receiving packets: {}", strerror(errno));
+            break;
+        }
+
+        receivedBatches++;
+        receivedDatagrams += rc;
+        total += rc;
+
+        for (int i = 0; i < rc; i++)
+            handler(batch.datagram(i), batch.from(i));
+    } while (running && batch.size() == batch.capacity());
+
+    return total;
+}
+
 void
 RPCServer::bindSockets(const SocketAddress& bind4, const SocketAddress& bind6)
 {
@@ -208,7 +461,7 @@ RPCServer::bindSockets(const SocketAddress& bind4, const SocketAddress& bind6)
     bound4 = {};
     if (bind4) {
         try {
-            sock4 = bindSocket(bind4, bound4);
+            sock4 = bindSocket(bind4, bound4, numWorkers > 0);
         } catch (const DhtError& e) {
             if (log)
                 log->error("Can't bind inet socket: {}", e.what());
@@ -222,7 +475,7 @@ RPCServer::bindSockets(const SocketAddress& bind4, const SocketAddress& bind6)
             if (auto p4 = bound4.port()) {
                 auto b6 = SocketAddress({bind6.inaddr(), bind6.inaddrLength()}, p4);
                 try {
-                    sock6 = bindSocket(b6, bound6);
+                    sock6 = bindSocket(b6, bound6, numWorkers > 0);
                 } catch (const DhtError& e) {
                     if (log)
                         log->error("Can't bind inet6 socket: {}", e.what());
@@ -231,7 +484,7 @@ RPCServer::bindSockets(const SocketAddress& bind4, const SocketAddress& bind6)
         }
         if (sock6 == -1) {
             try {
-                sock6 = bindSocket(bind6, bound6);
+                sock6 = bindSocket(bind6, bound6, numWorkers > 0);
             } catch (const DhtError& e) {
                 if (log)
                     log->error("Can't bind inet6 socket: {}", e.what());
@@ -249,8 +502,13 @@ RPCServer::openSockets()
 {
     running = true;
     rcv_thread = std::thread([this, ls4=sock4, ls6=sock6]() mutable {
-        int selectFd = std::max({ls4, ls6}) + 1;
-        struct timeval timeout;
+        ioThread.store(std::this_thread::get_id(), std::memory_order_release);
+        std::unique_ptr<DatagramBatch> rxBatch {};
+        if (batchSize > 1)
+            rxBatch = std::make_unique<DatagramBatch>(batchSize);
+
+        poller.add(ls4);
+        poller.add(ls6);
 
 // TODO:: will be remove
         // //--------------------For Debug-----------------------
@@ -260,24 +518,14 @@ RPCServer::openSockets()
 
         try {
             while (running) {
-                fd_set readfds;
-                FD_ZERO(&readfds);
-
-                if (ls4 >= 0) {
-                    FD_SET(ls4, &readfds);
-                }
-                if (ls6 >= 0) {
-                    FD_SET(ls6, &readfds);
-                }
+                // sleep until a packet arrives or the next job is due
+                poller.setDeadline(nextDeadline());
 
-                timeout.tv_sec = 0;
-                timeout.tv_usec = 100000;
-
-                int rc = select(selectFd, &readfds, NULL, NULL, &timeout);
+                int rc = poller.wait();
                 if (rc < 0) {
                     if (errno != EINTR) {
                         if (log)
-                            log->error("Select error: {}", strerror(errno));
+                            log->error("Poll error: {}", strerror(errno));
                         std::this_thread::sleep_for(std::chrono::seconds(1));
                     }
                 }
@@ -285,14 +533,23 @@ RPCServer::openSockets()
                 if (not running)
                     break;
 
-                if (rc > 0) {
+                if (rc > 0 && rxBatch != nullptr) {
+                    for (int fd : {ls4, ls6}) {
+                        if (!poller.isReadable(fd))
+                            continue;
+
+                        receiveBatch(*rxBatch, fd, [&](const Blob& packet, const SocketAddress& from) {
+                            handlePacket(packet.ptr(), packet.size(), from);
+                        });
+                    }
+                } else if (rc > 0) {
                     std::array<uint8_t, 1024 * 64> buf;
                     sockaddr_storage from;
                     socklen_t from_len = sizeof(from);
 
-                    if (ls4 >= 0 && FD_ISSET(ls4, &readfds))
+                    if (poller.isReadable(ls4))
                         rc = recvfrom(ls4, (char*)buf.data(), (size_t)buf.size(), 0, (sockaddr*)&from, &from_len);
-                    else if (ls6 >= 0 && FD_ISSET(ls6, &readfds))
+                    else if (poller.isReadable(ls6))
                         rc = recvfrom(ls6, (char*)buf.data(), (size_t)buf.size(), 0, (sockaddr*)&from, &from_len);
                     else
                         continue;
@@ -309,6 +566,8 @@ RPCServer::openSockets()
                             std::unique_lock<std::mutex> lk(lock, std::try_to_lock);
                             if (lk.owns_lock()) {
                                 if (not running) break;
+                                poller.remove(ls4);
+                                poller.remove(ls6);
                                 if (ls4 >= 0) {
                                     #if defined(_WIN32) || defined(_WIN64)
                                             closesocket(ls4);
@@ -339,7 +598,8 @@ RPCServer::openSockets()
                                     break;
                                 sock4 = ls4;
                                 sock6 = ls6;
-                                selectFd = std::max({ls4, ls6}) + 1;
+                                poller.add(ls4);
+                                poller.add(ls6);
                             } else {
                                 break;
                             }
@@ -379,13 +639,347 @@ RPCServer::openSockets()
     });
 }
 
+void
+RPCServer::openIoUring()
+{
+    running = true;
+    rcv_thread = std::thread([this]() {
+        ioThread.store(std::this_thread::get_id(), std::memory_order_release);
+        poller.add(uring->fd());
+
+        auto handler = [this](const Blob& packet, const SocketAddress& from) {
+            handlePacket(packet.ptr(), packet.size(), from);
+        };
+
+        try {
+            while (running) {
+                // the ring fd is readable while there are completions to reap
+                poller.setDeadline(nextDeadline());
+                if (poller.wait() < 0 && errno != EINTR) {
+                    log->error("Poll error: {}", strerror(errno));
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+
+                if (not running)
+                    break;
+
+                uring->poll(handler);
+                periodic();
+
+                // the packets queued in this iteration go out with one system call
+                CARRIER_STAGE_MARK(submitStart);
+                if (uring->submit() < 0)
+                    log->error("io_uring submit error: {}", strerror(errno));
+#ifdef CARRIER_STAGE_TRACING
+                auto submitEnd = StageTracer::now();
+                for (auto method : uringSends)
+                    StageTracer::record(StageTracer::Stage::SEND, method, submitStart, submitEnd);
+                uringSends.clear();
+#endif
+            }
+        } catch (const std::exception& e) {
+            log->error("Error in RPCServer io_uring thread: {}", e.what());
+        }
+
+        if (uring->getSubmitCalls() > 0)
+            log->info("RPC Server io_uring: {:.2f} requests per submit, {} truncated datagrams, {} send errors",
+                    (double)uring->getSubmittedRequests() / uring->getSubmitCalls(),
+                    uring->getDroppedDatagrams(), uring->getSendErrors());
+
+        // cancel the receives before closing the sockets
+        poller.remove(uring->fd());
+        uring.reset();
+
+        std::unique_lock<std::mutex> lk(lock);
+        if (sock4 >= 0)
+            closeSocket(sock4);
+        if (sock6 >= 0)
+            closeSocket(sock6);
+        sock4 = -1;
+        sock6 = -1;
+        bound4 = {};
+        bound6 = {};
+    });
+}
+
+void
+RPCServer::openWorkers()
+{
+    running = true;
+
+    for (int i = 0; i < numWorkers; i++) {
+        int ls4 = sock4;
+        int ls6 = sock6;
+
+#ifdef SO_REUSEPORT
+        // The first worker uses the primary sockets, others get their own shard
+        if (i > 0) {
+            SocketAddress bound {};
+            try {
+                if (sock4 >= 0) {
+                    ls4 = bindSocket(bound4, bound, true);
+                    workerSockets.push_back(ls4);
+                }
+                if (sock6 >= 0) {
+                    ls6 = bindSocket(bound6, bound, true);
+                    workerSockets.push_back(ls6);
+                }
+            } catch (const std::exception& e) {
+                // fall back to share the primary sockets
+                log->warn("Can't bind the socket for RPC worker {}: {}", i, e.what());
+                ls4 = sock4;
+                ls6 = sock6;
+            }
+        }
+#endif
+        workerPollers.push_back(std::make_unique<EventPoller>());
+        workers.emplace_back(&RPCServer::receiveLoop, this, std::ref(*workerPollers.back()), ls4, ls6);
+    }
+
+    rcv_thread = std::thread(&RPCServer::dispatchLoop, this);
+}
+
+void
+RPCServer::receiveLoop(EventPoller& workerPoller, int ls4, int ls6)
+{
+    std::vector<uint8_t> buf(1024 * 64);
+
+    workerPoller.add(ls4);
+    workerPoller.add(ls6);
+
+    std::unique_ptr<DatagramBatch> rxBatch {};
+    if (batchSize > 1)
+        rxBatch = std::make_unique<DatagramBatch>(batchSize);
+
+    auto enqueue = [this](const uint8_t* packet, size_t size, const SocketAddress& from) {
+        if (!acceptPacket(packet, size, from))
+            return;
+
+        if (numCryptoWorkers > 0) {
+            submitPacket(packet, size, from);
+            return;
+        }
+
+        auto msg = processPacket(packet, size, from);
+        if (msg != nullptr)
+            enqueueMessage(msg, size);
+    };
+
+    try {
+        while (running) {
+            int rc = workerPoller.wait();
+            if (rc < 0) {
+                if (errno != EINTR) {
+                    log->error("Poll error: {}", strerror(errno));
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                }
+                continue;
+            }
+
+            for (int fd : {ls4, ls6}) {
+                if (!workerPoller.isReadable(fd))
+                    continue;
+
+                if (rxBatch != nullptr) {
+                    receiveBatch(*rxBatch, fd, [&](const Blob& packet, const SocketAddress& from) {
+                        enqueue(packet.ptr(), packet.size(), from);
+                    });
+                    continue;
+                }
+
+                // drain the socket, the sockets are non-blocking
+                while (running) {
+                    sockaddr_storage from;
+                    socklen_t from_len = sizeof(from);
+
+                    rc = recvfrom(fd, (char*)buf.data(), buf.size(), 0, (sockaddr*)&from, &from_len);
+                    if (rc <= 0) {
+                        // another worker sharing the same socket may have taken the packet
+                        if (rc == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                            log->error("Error receiving packet: {}", strerror(errno));
+                        break;
+                    }
+
+                    enqueue(buf.data(), rc, SocketAddress(from));
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        log->error("Error in RPCServer worker thread: {}", e.what());
+    }
+}
+
+void
+RPCServer::dispatchLoop()
+{
+    ioThread.store(std::this_thread::get_id(), std::memory_order_release);
+
+    try {
+        while (running) {
+            // the routing table, calls and tasks are only touched from this thread
+            periodic();
+
+            // sleep until the workers queue a message or the next job is due
+            poller.setDeadline(nextDeadline());
+            if (poller.wait() < 0 && errno != EINTR) {
+                log->error("Poll error: {}", strerror(errno));
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+        }
+    } catch (const std::exception& e) {
+        log->error("Error in RPCServer dispatch thread: {}", e.what());
+    }
+
+    running = false;
+    for (auto& workerPoller : workerPollers)
+        workerPoller->wakeup();
+
+    for (auto& worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+    workerPollers.clear();
+
+    for (auto sock : workerSockets)
+        closeSocket(sock);
+    workerSockets.clear();
+
+    std::unique_lock<std::mutex> lk(lock);
+    if (sock4 >= 0)
+        closeSocket(sock4);
+    if (sock6 >= 0)
+        closeSocket(sock6);
+    sock4 = -1;
+    sock6 = -1;
+    bound4 = {};
+    bound6 = {};
+}
+
+void
+RPCServer::openCryptoWorkers()
+{
+    for (int i = 0; i < numCryptoWorkers; i++)
+        cryptoWorkers.emplace_back(&RPCServer::cryptoLoop, this);
+}
+
+void
+RPCServer::closeCryptoWorkers()
+{
+    // an empty packet wakes a worker to see the server stopped
+    for (size_t i = 0; i < cryptoWorkers.size(); i++)
+        cryptoQueue.push(RawPacket {});
+
+    for (auto& worker : cryptoWorkers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    cryptoWorkers.clear();
+}
+
+void
+RPCServer::cryptoLoop()
+{
+    try {
+        while (running) {
+            RawPacket in;
+            if (!cryptoQueue.pop(in, std::chrono::seconds(1)) || in.packet.empty())
+                continue;
+
+            auto size = in.packet.size();
+            auto msg = processPacket(in.packet.data(), size, in.from);
+            rawPool.release(std::move(in.packet));
+
+            cryptoStage.processed++;
+            if (msg != nullptr)
+                enqueueMessage(msg, size);
+        }
+    } catch (const std::exception& e) {
+        log->error("Error in RPCServer crypto worker: {}", e.what());
+    }
+}
+
+void
+RPCServer::bindTransport(const SocketAddress& bind4, const SocketAddress& bind6)
+{
+    bound4 = {};
+    if (bind4) {
+        try {
+            bound4 = transport->bind(bind4, *this);
+        } catch (const DhtError& e) {
+            log->error("Can't bind inet endpoint: {}", e.what());
+        }
+    }
+
+    bound6 = {};
+    if (dht6 && bind6) {
+        try {
+            bound6 = transport->bind(bind6, *this);
+        } catch (const DhtError& e) {
+            log->error("Can't bind inet6 endpoint: {}", e.what());
+        }
+    }
+
+    if (!bound4 && !bound6)
+        throw DhtError("Can't bind socket");
+}
+
+void
+RPCServer::openTransport()
+{
+    // no I/O thread, the transport polls the server from its own
+    running = true;
+    transport->wakeup(*this);
+}
+
+void
+RPCServer::closeTransport()
+{
+    std::unique_lock<std::mutex> lk(lock);
+    if (bound4)
+        transport->unbind(bound4);
+    if (bound6)
+        transport->unbind(bound6);
+    bound4 = {};
+    bound6 = {};
+}
+
+void RPCServer::wakeup() {
+    if (transport != nullptr)
+        transport->wakeup(*this);
+    else
+        poller.wakeup();
+}
+
+void RPCServer::onReceive(const uint8_t* data, size_t size, const SocketAddress& from) {
+    if (running)
+        handlePacket(data, size, from);
+}
+
+uint64_t RPCServer::onPoll() {
+    if (!running)
+        return Transport::NO_DEADLINE;
+
+    periodic();
+    return nextDeadline();
+}
+
 //--------------------------------------------------------------
 
 void RPCServer::start() {
     if (state != State::INITIAL)
         return;
 
-    openSockets();
+    if (transport != nullptr)
+        openTransport();
+    else if (numWorkers > 0)
+        openWorkers();
+    else if (uring != nullptr)
+        openIoUring();
+    else
+        openSockets();
+
+    openCryptoWorkers();
 
     state = State::RUNNING;
     startTime = currentTimeMillis();
@@ -395,6 +989,13 @@ void RPCServer::start() {
     else
         log->info("Started RPC server ipv4: {}, ipv6: {}", bound4.toString(), bound6.toString());
 
+    if (numWorkers > 0)
+        log->info("RPC server receiving with {} workers", numWorkers);
+    else if (uring != nullptr)
+        log->info("RPC server I/O with io_uring");
+    if (numCryptoWorkers > 0)
+        log->info("RPC server decrypting with {} crypto workers", numCryptoWorkers);
+
 }
 
 void RPCServer::stop() {
@@ -405,13 +1006,43 @@ void RPCServer::stop() {
     if (!running.exchange(false))
         return;
 
+    poller.wakeup();
+
     if (rcv_thread.joinable())
         rcv_thread.join();
 
+    closeCryptoWorkers();
+
     if (bound4)
         log->info("Stopped RPC Server ipv4: {}", bound4.toString());
     if (bound6)
         log->info("Stopped RPC Server ipv6: {}", bound6.toString());
+
+    if (batchSize > 1)
+        log->info("RPC Server batched I/O: {:.2f} datagrams per receive, {:.2f} datagrams per send",
+                getAverageReceiveBatchSize(), getAverageSendBatchSize());
+
+    if (numWorkers > 0 || numCryptoWorkers > 0) {
+        auto crypto = getCryptoStageStats();
+        auto dispatch = getDispatchStageStats();
+        log->info("RPC Server pipeline: crypto {} processed, {} dropped, peak queue {}; dispatch {} processed, {} dropped, peak queue {}",
+                crypto.processed, crypto.dropped, crypto.peakDepth, dispatch.processed, dispatch.dropped, dispatch.peakDepth);
+    }
+
+    if (admission) {
+        auto stats = admission->getStats();
+        log->info("RPC Server admission: {} accepted, {} blocked, {} source limited, {} sender limited, {} key limited, {} failures, {} blocklisted, {} spared",
+                stats.accepted, stats.blocked, stats.sourceLimited, stats.senderLimited, stats.keyLimited,
+                stats.failures, stats.blocklisted, stats.spared);
+    }
+
+    if (capture != nullptr) {
+        capture->flush();
+        log->info("RPC Server captured {} datagrams", capture->getRecords());
+    }
+
+    if (transport != nullptr)
+        closeTransport();
 }
 
 void RPCServer::updateReachability(uint64_t now) {
@@ -429,15 +1060,8 @@ void RPCServer::updateReachability(uint64_t now) {
 }
 
 void RPCServer::sendCall(Sp<RPCCall>& call) {
-    int txid = nextTxid++;
-    if (txid == 0) // 0 is invalid txid, skip
-        txid = nextTxid++;
-
-    if (calls.find(txid) != calls.end())
-        throw std::runtime_error("Transaction ID already exists");
-
+    int txid = calls.insert(call);
     call->getRequest()->setTxid(txid);
-    calls.insert({txid, call});
     dispatchCall(call);
 }
 
@@ -447,10 +1071,10 @@ void RPCServer::dispatchCall(Sp<RPCCall>& call) {
 
     auto responseHandler = [](RPCCall*, Sp<Message>&) {};
     auto timeoutHandler = [=](RPCCall* _call) {
-        auto it = calls.find(_call->getRequest()->getTxid());
-        if (it != calls.end()) {
-            it->second->getDHT().onTimeout(_call);
-            calls.erase(it);
+        int txid = _call->getRequest()->getTxid();
+        if (calls.find(txid) != nullptr) {
+            _call->getDHT().onTimeout(_call);
+            calls.remove(txid);
         }
     };
 
@@ -458,6 +1082,15 @@ void RPCServer::dispatchCall(Sp<RPCCall>& call) {
     call->addTimeoutHandler(timeoutHandler);
     call->addResponseHandler(responseHandler);
 
+    // the hot requests are compact encoded for the nodes known to understand it
+    int version = call->getTarget()->getVersion();
+    if (version == 0) {
+        auto entry = call->getDHT().getRoutingTable().getEntry(call->getTargetId());
+        if (entry != nullptr)
+            version = entry->getVersion();
+    }
+    request->setCompact(Message::supportsCompact(version));
+
     request->setAssociatedCall(call.get());
     sendMessage(request);
 }
@@ -487,40 +1120,175 @@ void RPCServer::sendError(Sp<Message> msg, int code, const std::string& err) {
     sendMessage(em);
 }
 
+/*
+ * Checks the cleartext sender id and the source address of the datagram
+ * before anything is spent on it. Called from the receiving threads.
+ */
+bool RPCServer::admitPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
+    if (!admission || buflen < ID_BYTES)
+        return true;    // the truncated ones are rejected by decodePacket
+
+    auto verdict = admission->admit(Id({buf, ID_BYTES}), from, currentTimeMillis());
+    return verdict == AdmissionFilter::Verdict::ACCEPTED;
+}
+
+/*
+ * Where every received datagram enters, whatever the receive mode: captures
+ * it when a capture is open, then admits it. Called from the receiving threads.
+ */
+bool RPCServer::acceptPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
+    if (capture != nullptr)
+        capture->write(PacketCapture::Direction::INBOUND, from, buf, buflen);
+
+    return admitPacket(buf, buflen, from);
+}
+
 void RPCServer::handlePacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
+    if (!acceptPacket(buf, buflen, from))
+        return;
+
+    if (numCryptoWorkers > 0) {
+        submitPacket(buf, buflen, from);
+        return;
+    }
+
+    auto msg = decodePacket(buf, buflen, from);
+    if (msg != nullptr)
+        dispatchPacket(msg, buflen);
+}
+
+/*
+ * Hands a copy of the datagram to the crypto workers, sheds it if they are
+ * too far behind. Called from the receiving threads.
+ */
+void RPCServer::submitPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
+    if (cryptoQueue.size() >= (size_t)Constants::RPC_CRYPTO_QUEUE_CAPACITY) {
+        cryptoStage.dropped++;
+        return;
+    }
+
+    auto packet = rawPool.acquire();
+    packet.assign(buf, buf + buflen);
+    cryptoStage.updatePeak(cryptoQueue.push(RawPacket {std::move(packet), from}));
+}
+
+/*
+ * Decodes the packet and checks the signatures it carries, so the DHT thread
+ * gets a message ready to handle. Safe to be called from the workers.
+ */
+Sp<Message> RPCServer::processPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
+    auto msg = decodePacket(buf, buflen, from);
+    if (msg == nullptr)
+        return nullptr;
+
+    try {
+        CARRIER_STAGE_SPAN(span, VERIFY, msg->getMethod());
+        msg->isSignatureValid();
+    } catch (const std::exception&) {
+        // malformed value or peer, left to the DHT thread to reject
+    }
+    return msg;
+}
+
+void RPCServer::enqueueMessage(Sp<Message> msg, size_t buflen) {
+    auto queued = inbox.push({msg, buflen});
+    if (queued == 0) {
+        dispatchStage.dropped++;
+        return;
+    }
+
+    dispatchStage.updatePeak(queued);
+    // the dispatcher drains the inbox before sleeping, wake it for the first one
+    if (queued == 1)
+        poller.wakeup();
+}
+
+void RPCServer::drainInbox() {
+    Inbound in;
+    while (running && inbox.pop(in)) {
+        dispatchStage.processed++;
+        dispatchPacket(in.msg, in.size);
+    }
+}
+
+/*
+ * Decrypts and parses the packet without touching any DHT state, it is safe
+ * to be called from the receive workers.
+ */
+Sp<Message> RPCServer::decodePacket(const uint8_t *buf, size_t buflen, const SocketAddress& from) {
     Sp<Message> msg = nullptr;
-    std::vector<uint8_t> buffer;
+
+    if (buflen <= ID_BYTES + CryptoBox::MAC_BYTES) {
+        log->warn("Got a truncated packet from {}, ignored: len {}", from.toString(), buflen);
+        if (admission)
+            admission->failure(from, currentTimeMillis());
+        return nullptr;
+    }
 
     Id sender({buf, ID_BYTES});
 
+    // decrypt into a pooled buffer and parse the plain text in place
+    auto buffer = receivePool.acquire();
+    buffer.resize(buflen - ID_BYTES - CryptoBox::MAC_BYTES);
+
+    CARRIER_STAGE_MARK(decryptStart);
     try {
-        buffer = node.decrypt(sender, {buf + ID_BYTES, buflen - ID_BYTES});
+        Blob plain {buffer};
+        node.decrypt(sender, plain, {buf + ID_BYTES, buflen - ID_BYTES});
     } catch(std::exception &e) {
         log->warn("Decrypt packet error from {}, ignored: len {}, {}", from.toString(), buflen, e.what());
-        return;
+        if (admission)
+            admission->failure(from, currentTimeMillis());
+        receivePool.release(std::move(buffer));
+        return nullptr;
     }
 
+    CARRIER_STAGE_MARK(parseStart);
     try {
         msg = Message::parse(buffer.data(), buffer.size());
     } catch(std::exception& e) {
         log->warn("Got a wrong packet from {}, ignored.", from.toString());
-        return;
+        if (admission)
+            admission->failure(from, currentTimeMillis());
+        receivePool.release(std::move(buffer));
+        return nullptr;
     }
 
-    receivedMessages++;
+    receivePool.release(std::move(buffer));
+    if (admission)
+        admission->success(from, currentTimeMillis());
+
+    // the method is only known once parsed
+    CARRIER_STAGE_RECORD(DECRYPT, msg->getMethod(), decryptStart, parseStart);
+    CARRIER_STAGE_END(PARSE, msg->getMethod(), parseStart);
+
     msg->setId(sender);
     msg->setOrigin(from);
+    return msg;
+}
 
+void RPCServer::dispatchPacket(Sp<Message> msg, size_t buflen) {
+    const auto& from = msg->getOrigin();
+
+    receivedMessages++;
+    countPacket(TraceRing::Direction::RECEIVED, *msg, buflen);
+
+    if (trace != nullptr)
+        tracePacket(TraceRing::Direction::RECEIVED, *msg, from, buflen);
+
+    // the arguments would be built even if the record isn't logged
+    if (log->isDebugEnabled()) {
 #ifdef MSG_PRINT_DETAIL
-    msg->setName(txidNames[msg->getTxid()]);
-    if (filterMessage(msg->name)) {
-        log->debug("\n\n-- Received: {} bytes -- \nLocal: {}\nFrom: {}\n{}\n-- ** --\n",
-                  buflen,  getAddress(from.family()).toString(), from.toString(), static_cast<std::string>(*msg));
-    }
+        msg->setName(txidNames[msg->getTxid()]);
+        if (filterMessage(msg->name)) {
+            log->debug("\n\n-- Received: {} bytes -- \nLocal: {}\nFrom: {}\n{}\n-- ** --\n",
+                      buflen,  getAddress(from.family()).toString(), from.toString(), *msg);
+        }
 #else
-    log->debug("Received {}/{} from {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
-            from.toString(), buflen, static_cast<std::string>(*msg));
+        log->debug("Received {}/{} from {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
+                from.toString(), buflen, *msg);
 #endif
+    }
 
     // transaction id should be a non-zero integer
     if (msg->getType() != Message::Type::ERR && msg->getTxid() == 0) {
@@ -537,16 +1305,18 @@ void RPCServer::handlePacket(const uint8_t *buf, size_t buflen, const SocketAddr
     }
 
     // check if this is a response to an outstanding request
-    auto it = calls.find(msg->getTxid());
-    if (it != calls.end()) {
-        Sp<RPCCall> call = it->second;
+    auto pending = calls.find(msg->getTxid());
+    if (pending != nullptr) {
+        Sp<RPCCall> call = *pending;
         // message matches transaction ID and origin == destination
         // we only check the IP address here. the routing table applies more strict checks to also verify a stable port
         if (call->getRequest()->getRemoteAddress() == msg->getOrigin()) {
             // remove call first in case of exception
-            calls.erase(it);
+            calls.remove(msg->getTxid());
             msg->setAssociatedCall(call.get());
             call->responsed(msg);
+            if (msg->getType() == Message::Type::RESPONSE)
+                timeoutFilter.update(call->getRTT());
 
             // processCallQueue();
             // apply after checking for a proper response
@@ -599,10 +1369,11 @@ void RPCServer::handlePacket(const uint8_t *buf, size_t buflen, const SocketAddr
         return;
     }
 
-    log->debug("Ignored message: {}", static_cast<std::string>(*msg));
+    log->debug("Ignored message: {}", *msg);
 }
 
 void RPCServer::handleMessage(Sp<Message> msg) {
+    CARRIER_STAGE_SPAN(span, DISPATCH, msg->getMethod());
     if (msg->getOrigin().family() == AF_INET)
         dht4->get().onMessage(msg);
     else
@@ -610,7 +1381,10 @@ void RPCServer::handleMessage(Sp<Message> msg) {
 }
 
 void RPCServer::periodic() {
-    while(!messageQueue.empty()) {
+    drainInbox();
+
+    // only retry the queued packets once, sendData() queues them again on EAGAIN
+    for (auto pending = messageQueue.size(); pending > 0 && !messageQueue.empty(); pending--) {
         auto msg = messageQueue.front();
         messageQueue.pop();
         sendData(msg);
@@ -618,6 +1392,17 @@ void RPCServer::periodic() {
 
     scheduler.syncTime();
     scheduler.run();
+
+    if (txBatch != nullptr)
+        flushOutbound();
+}
+
+uint64_t RPCServer::nextDeadline() const {
+    uint64_t deadline = scheduler.getNextJobTime();
+    // the packets the socket couldn't take are retried shortly
+    if (!messageQueue.empty() || !outbound.empty())
+        deadline = std::min(deadline, currentTimeMillis() + Constants::RPC_SEND_RETRY_INTERVAL);
+    return deadline;
 }
 
 } // namespace carrier
@@ -23,21 +23,37 @@
 #pragma once
 
 #include <list>
+#include <deque>
 #include <queue>
+#include <thread>
 #include <random>
 #include <optional>
+#include <ostream>
 
 #include "utils/log.h"
+#include "utils/mtqueue.h"
+#include "utils/mpsc_queue.h"
+#include "utils/datagram_batch.h"
+#include "utils/event_poller.h"
+#include "utils/io_uring.h"
+#include "utils/buffer_pool.h"
+#include "utils/txid_table.h"
+#include "utils/trace_ring.h"
+#include "utils/metrics.h"
 #include "messages/message.h"
 #include "rpccall.h"
+#include "response_timeout_filter.h"
+#include "admission_filter.h"
 #include "scheduler.h"
+#include "transport.h"
+#include "packet_capture.h"
 
 namespace elastos {
 namespace carrier {
 
 class Node;
 
-class RPCServer {
+class RPCServer : private Transport::Listener {
 public:
     enum class State {
         INITIAL,
@@ -45,8 +61,19 @@ public:
         STOPPED
     };
 
+    /*
+     * Backpressure of a stage of the receive pipeline: the items it passed
+     * on, the items shed because its queue was full, and its queue depth.
+     */
+    struct StageStats {
+        uint64_t processed {0};
+        uint64_t dropped {0};
+        size_t depth {0};
+        size_t peakDepth {0};
+    };
+
     RPCServer(Node& _node, const Sp<DHT> _dht4, const Sp<DHT> _dht6);
-    ~RPCServer();
+    ~RPCServer() override;
 
     void start();
     void stop();
@@ -64,34 +91,121 @@ public:
 
     bool hasIPv4() const {
         std::lock_guard<std::mutex> lk(lock);
-        return sock4 != -1;
+        return transport ? (bool)bound4 : sock4 != -1;
     }
 
     bool hasIPv6() const {
         std::lock_guard<std::mutex> lk(lock);
-        return sock6 != -1;
+        return transport ? (bool)bound6 : sock6 != -1;
     }
 
     Scheduler& getScheduler() {
         return scheduler;
     }
 
+    const ResponseTimeoutFilter& getTimeoutFilter() const {
+        return timeoutFilter;
+    }
+
     int getNumberOfActiveRPCCalls() {
         return calls.size();
     }
 
+    int getNumberOfWorkers() const {
+        return numWorkers;
+    }
+
+    int getNumberOfCryptoWorkers() const {
+        return numCryptoWorkers;
+    }
+
+    uint64_t getDroppedMessages() const {
+        return cryptoStage.dropped + dispatchStage.dropped;
+    }
+
+    // the raw datagrams queued for the crypto workers
+    StageStats getCryptoStageStats() const {
+        return cryptoStage.snapshot(cryptoQueue.size());
+    }
+
+    // the decoded messages queued for the DHT thread
+    StageStats getDispatchStageStats() const {
+        return dispatchStage.snapshot(inbox.size());
+    }
+
+    // the datagrams admitted or shed before decryption
+    AdmissionFilter::Stats getAdmissionStats() const {
+        return admission ? admission->getStats() : AdmissionFilter::Stats {};
+    }
+
+    // 0 if the responses aren't trimmed to a datagram size
+    int getDatagramBudget() const {
+        return datagramBudget;
+    }
+
+    // the responses sent over the datagram budget, e.g. the values too large to fit
+    uint64_t getOversizedResponses() const {
+        return oversizedResponses;
+    }
+
+    bool isTraceEnabled() const {
+        return trace != nullptr;
+    }
+
+    // Writes the packets kept in the trace ring, one per line, oldest first
+    void dumpTrace(std::ostream& out) const;
+
+    double getAverageReceiveBatchSize() const {
+        return receivedBatches ? (double)receivedDatagrams / receivedBatches : 0.0;
+    }
+
+    double getAverageSendBatchSize() const {
+        return sentBatches ? (double)sentDatagrams / sentBatches : 0.0;
+    }
+
     SocketAddress& getAddress(sa_family_t af) {
         return (af == AF_INET) ? bound4: bound6;
     }
 
     void sendError(Sp<Message> msg, int code, const std::string& err);
 
+    // Serializes and encrypts the message into the packet buffer
+    static void encodePacket(const Node& node, Message& msg, std::vector<uint8_t>& packet);
+
 private:
     void bindSockets(const SocketAddress& bind4, const SocketAddress& bind6);
+    void bindTransport(const SocketAddress& bind4, const SocketAddress& bind6);
+    void openTransport();
+    void closeTransport();
+    void wakeup();
+    void onReceive(const uint8_t* data, size_t size, const SocketAddress& from) override;
+    uint64_t onPoll() override;
     void openSockets();
+    void openWorkers();
+    void openIoUring();
+    void receiveLoop(EventPoller& workerPoller, int ls4, int ls6);
+    void dispatchLoop();
+    void openCryptoWorkers();
+    void closeCryptoWorkers();
+    void cryptoLoop();
     int sendData(Sp<Message>& msg);
+    void logSent(const Sp<Message>& msg, size_t size);
+    void tracePacket(TraceRing::Direction direction, Message& msg, const SocketAddress& peer, size_t size);
+    void initMetrics();
+    void countPacket(TraceRing::Direction direction, const Message& msg, size_t size) noexcept;
+    void flushOutbound();
+    int receiveBatch(DatagramBatch& batch, int fd, const std::function<void(const Blob&, const SocketAddress&)>& handler);
+    bool admitPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
+    bool acceptPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
     void handlePacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
+    Sp<Message> decodePacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
+    Sp<Message> processPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
+    void submitPacket(const uint8_t *buf, size_t buflen, const SocketAddress& from);
+    void enqueueMessage(Sp<Message> msg, size_t buflen);
+    void drainInbox();
+    void dispatchPacket(Sp<Message> msg, size_t buflen);
     void periodic();
+    uint64_t nextDeadline() const;
 
 #if defined(MSG_PRINT_DETAIL)
     bool filterMessage(std::string name);
@@ -106,17 +220,109 @@ private:
     int sock4 {-1};
     int sock6 {-1};
 
+    // replaces the sockets and the I/O thread if set on the node
+    Sp<Transport> transport {};
+
     SocketAddress bound4;
     SocketAddress bound6;
 
     std::thread rcv_thread;
     std::atomic_bool running {false};
 
+    // wakes the I/O thread for the sockets, the scheduler and stop()
+    EventPoller poller {};
+
+    struct Inbound {
+        Sp<Message> msg {};
+        size_t size {0};
+    };
+
+    struct RawPacket {
+        std::vector<uint8_t> packet {};
+        SocketAddress from {};
+    };
+
+    struct StageCounters {
+        std::atomic<uint64_t> processed {0};
+        std::atomic<uint64_t> dropped {0};
+        std::atomic<size_t> peakDepth {0};
+
+        void updatePeak(size_t depth) {
+            size_t peak = peakDepth.load(std::memory_order_relaxed);
+            while (depth > peak && !peakDepth.compare_exchange_weak(peak, depth, std::memory_order_relaxed));
+        }
+
+        StageStats snapshot(size_t depth) const {
+            return { processed.load(), dropped.load(), depth, peakDepth.load() };
+        }
+    };
+
+    int numWorkers {0};
+    std::vector<std::thread> workers {};
+    std::vector<int> workerSockets {};
+    std::vector<std::unique_ptr<EventPoller>> workerPollers {};
+
+    // sheds the floods before they cost a decryption, null if disabled
+    std::unique_ptr<AdmissionFilter> admission {};
+
+    // decrypt, parse and signature checks off the receiving threads
+    int numCryptoWorkers {0};
+    std::vector<std::thread> cryptoWorkers {};
+    MTQueue<RawPacket> cryptoQueue {};
+    BufferPool rawPool {(size_t)Constants::RPC_PACKET_POOL_SIZE, (size_t)Constants::RPC_PACKET_BUFFER_SIZE};
+    StageCounters cryptoStage {};
+
+    // the decoded messages from the workers, only the DHT thread pops them
+    MPSCQueue<Inbound> inbox {(size_t)Constants::RPC_WORKER_QUEUE_CAPACITY};
+    StageCounters dispatchStage {};
+
+    struct Outbound {
+        Sp<Message> msg {};
+        int sockfd {-1};
+        std::vector<uint8_t> packet {};
+    };
+
+    // Batched I/O, the outbound queue is only touched by the I/O thread
+    int batchSize {0};
+    std::atomic<std::thread::id> ioThread {};
+    std::unique_ptr<DatagramBatch> txBatch {};
+    std::deque<Outbound> outbound {};
+    std::atomic<uint64_t> receivedBatches {0};
+    std::atomic<uint64_t> receivedDatagrams {0};
+    std::atomic<uint64_t> sentBatches {0};
+    std::atomic<uint64_t> sentDatagrams {0};
+
+    int datagramBudget {0};
+    std::atomic<uint64_t> oversizedResponses {0};
+
+    // the recent packets, only if enabled by the configuration
+    std::unique_ptr<TraceRing> trace {};
+
+    // every datagram received and sent, only if enabled by the configuration
+    std::unique_ptr<PacketCapture> capture {};
+
+    // the exported packet counters, by direction, message type and method
+    static constexpr int METRIC_TYPES = 3;
+    static constexpr int METRIC_METHODS = 7;
+    Counter* packetCounters[2][METRIC_TYPES][METRIC_METHODS] {};
+    Counter* byteCounters[2] {};
+
+    // the io_uring backend, only used by the I/O thread once started
+    std::unique_ptr<IoUring> uring {};
+#ifdef CARRIER_STAGE_TRACING
+    std::vector<Message::Method> uringSends {};     // queued since the last submit
+#endif
+
+    BufferPool packetPool {(size_t)Constants::RPC_PACKET_POOL_SIZE, (size_t)Constants::RPC_PACKET_BUFFER_SIZE};
+    BufferPool receivePool {(size_t)Constants::RPC_RECEIVE_POOL_SIZE, (size_t)Constants::RECEIVE_BUFFER_SIZE};
+
+    // round trip times of the calls, the stall timeout for the unknown nodes
+    ResponseTimeoutFilter timeoutFilter {};
+
     std::list<Sp<RPCCall>> callQueue;
-    std::map<int, Sp<RPCCall>> calls;
+    TxidTable<Sp<RPCCall>> calls;
 
     State state {State::INITIAL};
-    volatile int nextTxid {0};
     volatile bool _isReachable {false};
     uint64_t messagesAtLastReachableCheck {0};
     uint64_t lastReachableCheck {0};
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Jacobson/Karels round trip time estimator (RFC 6298), kept per remote node.
+ * The smoothed RTT and the variation are stored scaled by 8 and 4 so the
+ * updates stay in integer arithmetic.
+ */
+class RTTEstimator {
+public:
+    bool hasSamples() const noexcept {
+        return samples > 0;
+    }
+
+    int getSamples() const noexcept {
+        return samples;
+    }
+
+    // smoothed round trip time in milliseconds
+    int getSRTT() const noexcept {
+        return srtt >> 3;
+    }
+
+    // round trip time variation in milliseconds
+    int getRTTVar() const noexcept {
+        return rttvar >> 2;
+    }
+
+    void update(int rtt) noexcept {
+        rtt = std::max(rtt, 1);
+
+        if (samples == 0) {
+            srtt = rtt << 3;
+            rttvar = rtt << 1;
+        } else {
+            int delta = rtt - (srtt >> 3);
+            srtt += delta;                               // srtt = 7/8 srtt + 1/8 rtt
+            rttvar += std::abs(delta) - (rttvar >> 2);   // rttvar = 3/4 rttvar + 1/4 |delta|
+        }
+
+        if (samples < INT32_MAX)
+            samples++;
+    }
+
+    /*
+     * The retransmission timeout: srtt + 4 * rttvar, bounded by the caller.
+     */
+    int getTimeout(int min, int max) const noexcept {
+        return std::clamp(getSRTT() + rttvar, min, max);
+    }
+
+private:
+    int srtt {0};
+    int rttvar {0};
+    int samples {0};
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "scheduler.h"
+
+namespace elastos {
+namespace carrier {
+
+static inline int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+void Scheduler::Job::cancel() {
+    do_ = {};
+    fixedDelay = 0;
+
+    // the last reference might be the wheel's, keep it until we are done
+    Sp<Job> keep {};
+    if (owner != nullptr)
+        keep = owner->unlink(this);
+}
+
+Scheduler::~Scheduler() {
+    auto release = [](Link& list) {
+        while (!list.empty()) {
+            auto job = static_cast<Job*>(list.next);
+            list.next = job->next;
+            job->prev = job->next = job;
+            job->owner = nullptr;
+            auto keep = std::move(job->self);
+        }
+        list.prev = &list;
+    };
+
+    for (auto& wheel : wheels) {
+        for (auto& slot : wheel)
+            release(slot);
+    }
+    release(overflow);
+    release(due);
+}
+
+void Scheduler::add(const Sp<Scheduler::Job>& job, long delay, long fixedDelay) {
+    job->setFixedDelay(fixedDelay);
+    uint64_t time = currentTimeMillis() + delay;
+    if (time == std::numeric_limits<uint64_t>::max())
+        return;
+
+    Sp<Job> keep {};
+    if (job->owner != nullptr)
+        keep = unlink(job.get());
+
+    bool earliest = time < getNextJobTime();
+
+    job->expiration = time;
+    job->owner = this;
+    job->self = job;
+    link(job.get());
+    jobs++;
+
+    if (earliest && wakeupHandler)
+        wakeupHandler();
+}
+
+void Scheduler::append(Link& list, Link* node) {
+    node->prev = list.prev;
+    node->next = &list;
+    list.prev->next = node;
+    list.prev = node;
+}
+
+void Scheduler::link(Job* job) {
+    if (job->expiration <= current) {
+        job->level = DUE;
+        append(due, job);
+        return;
+    }
+
+    uint64_t diff = job->expiration ^ current;
+    if (diff >> (SLOT_BITS * LEVELS)) {
+        job->level = OVERFLOW_LEVEL;
+        append(overflow, job);
+
+        uint64_t time = job->expiration & ~((uint64_t(1) << (SLOT_BITS * LEVELS)) - 1);
+        overflowTime = std::min(overflowTime, time);
+        return;
+    }
+
+    int level = LEVELS - 1;
+    while ((diff >> (SLOT_BITS * level)) == 0)
+        level--;
+
+    int slot = (job->expiration >> (SLOT_BITS * level)) & (SLOTS - 1);
+    job->level = level;
+    job->slot = slot;
+    append(wheels[level][slot], job);
+    occupied[level][slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+Sp<Scheduler::Job> Scheduler::unlink(Job* job) {
+    job->prev->next = job->next;
+    job->next->prev = job->prev;
+
+    if (job->level >= 0 && job->level < LEVELS) {
+        auto& slot = wheels[job->level][job->slot];
+        if (slot.empty())
+            occupied[job->level][job->slot / 64] &= ~(uint64_t(1) << (job->slot % 64));
+    }
+
+    job->prev = job->next = job;
+    job->owner = nullptr;
+    jobs--;
+    return std::move(job->self);
+}
+
+/*
+ * The earliest time a non-empty slot is reached: the jobs of the level 0
+ * slots expire exactly then, the ones from the upper levels cascade down.
+ */
+uint64_t Scheduler::nextSlotTime() const {
+    for (int level = 0; level < LEVELS; level++) {
+        int shift = SLOT_BITS * level;
+        int from = ((current >> shift) & (SLOTS - 1)) + 1;
+
+        for (int word = from / 64; word < (int)occupied[level].size(); word++) {
+            uint64_t bits = occupied[level][word];
+            if (word == from / 64)
+                bits &= ~uint64_t(0) << (from % 64);
+            if (bits == 0)
+                continue;
+
+            uint64_t slot = word * 64 + lowestBit(bits);
+            uint64_t base = current & ~((uint64_t(1) << (shift + SLOT_BITS)) - 1);
+            return base | (slot << shift);
+        }
+    }
+
+    return overflow.empty() ? std::numeric_limits<uint64_t>::max() : overflowTime;
+}
+
+void Scheduler::cascade(Link& list) {
+    while (!list.empty()) {
+        auto job = static_cast<Job*>(list.next);
+        list.next = job->next;
+        job->next->prev = &list;
+        link(job);
+    }
+}
+
+void Scheduler::advance(uint64_t time) {
+    while (true) {
+        uint64_t next = nextSlotTime();
+        if (next > time)
+            break;
+
+        current = next;
+        if (!overflow.empty() && current >= overflowTime) {
+            overflowTime = std::numeric_limits<uint64_t>::max();
+            cascade(overflow);
+        }
+
+        // the upper levels first, their jobs might land on the level 0 slot
+        for (int level = LEVELS - 1; level >= 0; level--) {
+            int shift = SLOT_BITS * level;
+            if (level > 0 && (current & ((uint64_t(1) << shift) - 1)) != 0)
+                continue;
+
+            int slot = (current >> shift) & (SLOTS - 1);
+            if (occupied[level][slot / 64] & (uint64_t(1) << (slot % 64))) {
+                occupied[level][slot / 64] &= ~(uint64_t(1) << (slot % 64));
+                cascade(wheels[level][slot]);
+            }
+        }
+    }
+
+    // no slot is reached in between, the wheel can jump
+    if (time > current)
+        current = time;
+}
+
+uint64_t Scheduler::run() {
+    /*
+     * Running jobs scheduled before "now" prevents run+rescheduling
+     * loops before this method ends. It is garanteed by the fact that a
+     * job will at least be scheduled for "now" and not before.
+     */
+    advance(now);
+
+    while (!due.empty()) {
+        auto job = unlink(static_cast<Job*>(due.next));
+        if (*job)
+            (*job)();
+
+        // re-armed unless cancelled or already re-armed by itself
+        if (job->fixedDelay > 0 && !job->isArmed())
+            add(job, job->fixedDelay, job->fixedDelay);
+    }
+
+    return getNextJobTime();
+}
+
+uint64_t Scheduler::getNextJobTime() const {
+    return due.empty() ? nextSlotTime() : current;
+}
+
+} // namespace carrier
+} // namespace elastos
@@ -23,10 +23,13 @@
 #pragma once
 
 #include <functional>
-#include <map>
+#include <array>
+#include <memory>
 #include <chrono>
+#include <limits>
 #include <cstdint>
 
+#include "carrier/types.h"
 #include "utils/time.h"
 
 namespace elastos {
@@ -36,19 +39,42 @@ namespace carrier {
 
 using clock = std::chrono::steady_clock;
 
+/*
+ * Hierarchical timing wheel. LEVELS wheels of SLOTS slots with 1ms ticks:
+ * a job lives on the level of the highest byte its expiration differs from
+ * the current wheel time and moves down a level each time the wheel time
+ * reaches its slot, jobs beyond the top level wait on an overflow list.
+ * The jobs are intrusive list nodes, arming and cancelling are O(1) and
+ * don't allocate. Not thread safe, the jobs are only armed, cancelled and
+ * run on the thread running the scheduler.
+ */
 class Scheduler {
+private:
+    struct Link {
+        Link* prev {this};
+        Link* next {this};
+
+        bool empty() const {
+            return next == this;
+        }
+    };
+
 public:
-    class Job {
+    class Job : private Link {
     public:
         Job(std::function<void()>&& f) : do_(std::move(f)) {}
 
+        Job(const Job&) = delete;
+        Job& operator=(const Job&) = delete;
+
         void setFixedDelay(long _fixedDelay) {
             fixedDelay = _fixedDelay;
         }
 
-        void cancel() {
-            do_ = {};
-            fixedDelay = 0;
+        void cancel();
+
+        bool isArmed() const {
+            return owner != nullptr;
         }
 
         explicit operator bool() const {
@@ -62,59 +88,56 @@ public:
     private:
         std::function<void()> do_;
         long fixedDelay = 0;
+
+        uint64_t expiration {0};
+        Scheduler* owner {nullptr};
+        int level {0};
+        int slot {0};
+        Sp<Job> self {};        // keeps the job alive while it is armed
+
         friend class Scheduler;
     };
 
+    Scheduler() = default;
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
     Sp<Scheduler::Job> add(std::function<void()>&& job_func, long delay, long fixedDelay = 0) {
         auto job = std::make_shared<Job>(std::move(job_func));
         add(job, delay, fixedDelay);
         return job;
     }
 
-    void add(const Sp<Scheduler::Job>& job, long delay, long fixedDelay = 0) {
-        job->setFixedDelay(fixedDelay);
-        uint64_t time = currentTimeMillis() + delay;
-        if (time != std::numeric_limits<uint64_t>::max())
-            timers.emplace(time, job);
-    }
+    // (re-)arms the job, it is moved if it was already armed
+    void add(const Sp<Scheduler::Job>& job, long delay, long fixedDelay = 0);
 
     void edit(Sp<Scheduler::Job>& job, long delay, long fixedDelay = 0) {
-        if (not job) {
+        if (not job)
             return;
-        }
-        // std::function move doesn't garantee to leave the object empty.
-        // Force clearing old value.
-        auto task = std::move(job->do_);
-        job->cancel();
-        job = add(std::move(task), delay, fixedDelay);
+
+        add(job, delay, fixedDelay);
     }
 
-    uint64_t run() {
-        while (not timers.empty()) {
-            auto timer = timers.begin();
-            /*
-             * Running jobs scheduled before "now" prevents run+rescheduling
-             * loops before this method ends. It is garanteed by the fact that a
-             * job will at least be scheduled for "now" and not before.
-             */
-            if (timer->first > now)
-                break;
-
-            auto job = std::move(timer->second);
-            if (*job)
-                (*job)();
-
-            if (job->fixedDelay > 0) {
-                edit(job, job->fixedDelay, job->fixedDelay);
-            }
-
-            timers.erase(timer);
-        }
-        return getNextJobTime();
+    uint64_t run();
+
+    /*
+     * The time of the next job, or the time the wheel has to advance to
+     * find it out. It might be earlier than the job but never later.
+     */
+    uint64_t getNextJobTime() const;
+
+    size_t size() const {
+        return jobs;
     }
 
-    inline uint64_t getNextJobTime() const {
-        return timers.empty() ? std::numeric_limits<uint64_t>::max() : timers.begin()->first;
+    /*
+     * The handler is called when a job is added ahead of the next job time,
+     * so the event loop running the scheduler can re-arm its timer.
+     */
+    void setWakeupHandler(std::function<void()>&& handler) {
+        wakeupHandler = std::move(handler);
     }
 
     inline const uint64_t& time() const { return now; }
@@ -122,8 +145,33 @@ public:
     inline void syncTime(const uint64_t& n) { now = n; }
 
 private:
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+    static const int DUE = -1;
+    static const int OVERFLOW_LEVEL = LEVELS;
+
+    using Bitmap = std::array<uint64_t, SLOTS / 64>;
+
+    void link(Job* job);
+    Sp<Job> unlink(Job* job);
+    void advance(uint64_t time);
+    void cascade(Link& list);
+    uint64_t nextSlotTime() const;
+
+    static void append(Link& list, Link* node);
+
     uint64_t now {currentTimeMillis()};
-    std::multimap<uint64_t, Sp<Job>> timers {}; /* the jobs ordered by time */
+    uint64_t current {now};     /* the time the wheel has advanced to */
+
+    std::array<std::array<Link, SLOTS>, LEVELS> wheels {};
+    std::array<Bitmap, LEVELS> occupied {};
+    Link overflow {};
+    uint64_t overflowTime {std::numeric_limits<uint64_t>::max()};
+    Link due {};                /* expired jobs waiting to run */
+    size_t jobs {0};
+
+    std::function<void()> wakeupHandler {};
 };
 
 }
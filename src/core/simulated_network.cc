@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+
+#include "exceptions/dht_error.h"
+#include "simulated_network.h"
+
+namespace elastos {
+namespace carrier {
+
+SimulatedNetwork::SimulatedNetwork(uint64_t seed, uint64_t start)
+    : clock(start), random(seed) {
+}
+
+SimulatedNetwork::~SimulatedNetwork() {
+}
+
+void SimulatedNetwork::setProfile(const LinkProfile& profile) {
+    std::lock_guard<std::mutex> lk(lock);
+    defaultProfile = profile;
+}
+
+void SimulatedNetwork::setProfile(const SocketAddress& from, const LinkProfile& profile) {
+    std::lock_guard<std::mutex> lk(lock);
+    profiles[from] = profile;
+}
+
+SimulatedNetwork::Stats SimulatedNetwork::getStats() const {
+    std::lock_guard<std::mutex> lk(lock);
+    return stats;
+}
+
+size_t SimulatedNetwork::getNumberOfEndpoints() const {
+    std::lock_guard<std::mutex> lk(lock);
+    return endpoints.size();
+}
+
+SocketAddress SimulatedNetwork::bind(const SocketAddress& addr, Listener& listener) {
+    std::lock_guard<std::mutex> lk(lock);
+
+    SocketAddress bound = addr;
+    if (addr.port() == 0) {
+        do {
+            bound = SocketAddress({addr.inaddr(), addr.inaddrLength()}, nextPort);
+            nextPort = nextPort == UINT16_MAX ? 49152 : nextPort + 1;
+        } while (endpoints.find(bound) != endpoints.end());
+    }
+
+    if (!endpoints.emplace(bound, Endpoint {&listener}).second)
+        throw DhtError("Can't bind " + bound.toString() + ", the address is in use");
+
+    bindings[&listener].endpoints++;
+    return bound;
+}
+
+void SimulatedNetwork::unbind(const SocketAddress& bound) {
+    std::lock_guard<std::mutex> lk(lock);
+
+    auto it = endpoints.find(bound);
+    if (it == endpoints.end())
+        return;
+
+    auto binding = bindings.find(it->second.listener);
+    if (binding != bindings.end() && --binding->second.endpoints <= 0)
+        bindings.erase(binding);     // the armed polls are skipped
+    endpoints.erase(it);
+}
+
+int SimulatedNetwork::send(const SocketAddress& from, const uint8_t* data, size_t size, const SocketAddress& to) {
+    std::lock_guard<std::mutex> lk(lock);
+
+    auto source = endpoints.find(from);
+    if (source == endpoints.end()) {
+        errno = EBADF;
+        return -1;
+    }
+
+    auto p = profiles.find(from);
+    const auto& profile = p != profiles.end() ? p->second : defaultProfile;
+
+    stats.sent++;
+    stats.bytes += size;
+
+    // the datagrams queue on the uplink of the sender
+    uint64_t departure = std::max(nowMicros(), source->second.uplinkFree);
+    if (profile.bandwidth > 0)
+        departure += size * 1000000 / profile.bandwidth;
+    source->second.uplinkFree = departure;
+
+    if (profile.loss > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random) < profile.loss) {
+        stats.lost++;
+        return (int)size;
+    }
+
+    uint64_t latency = profile.latency;
+    if (profile.jitter > 0)
+        latency += std::uniform_int_distribution<uint32_t>(0, profile.jitter)(random);
+
+    Event event {};
+    event.time = departure + latency * 1000;
+    event.from = from;
+    event.to = to;
+    event.data.assign(data, data + size);
+    push(std::move(event));
+    return (int)size;
+}
+
+void SimulatedNetwork::wakeup(Listener& listener) {
+    std::lock_guard<std::mutex> lk(lock);
+    schedulePoll(&listener, nowMicros());
+}
+
+void SimulatedNetwork::push(Event&& event) {
+    event.sequence = sequence++;
+    events.push_back(std::move(event));
+    std::push_heap(events.begin(), events.end(), std::greater<Event> {});
+}
+
+void SimulatedNetwork::schedulePoll(Listener* listener, uint64_t time) {
+    auto binding = bindings.find(listener);
+    if (binding == bindings.end() || binding->second.pollTime <= time)
+        return;     // unbound, or an earlier poll is armed
+
+    binding->second.pollTime = time;
+
+    Event event {};
+    event.time = time;
+    event.listener = listener;
+    push(std::move(event));
+}
+
+void SimulatedNetwork::setTime(uint64_t time) {
+    clock.set(time / 1000);
+    micros = time % 1000;
+}
+
+/*
+ * Runs the first event if due by the limit. The listeners are called without
+ * the lock, they send and wake up in the call.
+ */
+bool SimulatedNetwork::runNext(uint64_t limit) {
+    Event event {};
+    Listener* listener {nullptr};
+
+    {
+        std::lock_guard<std::mutex> lk(lock);
+        if (events.empty() || events.front().time > limit)
+            return false;
+
+        std::pop_heap(events.begin(), events.end(), std::greater<Event> {});
+        event = std::move(events.back());
+        events.pop_back();
+
+        if (event.time > nowMicros())
+            setTime(event.time);
+
+        if (event.listener != nullptr) {
+            auto binding = bindings.find(event.listener);
+            if (binding == bindings.end() || binding->second.pollTime != event.time)
+                return true;    // superseded by an earlier poll, or unbound
+
+            binding->second.pollTime = UINT64_MAX;
+            listener = event.listener;
+        } else {
+            auto endpoint = endpoints.find(event.to);
+            if (endpoint == endpoints.end()) {
+                stats.unreachable++;
+                return true;
+            }
+
+            stats.delivered++;
+            listener = endpoint->second.listener;
+        }
+    }
+
+    if (event.listener == nullptr)
+        listener->onReceive(event.data.data(), event.data.size(), event.from);
+
+    // like the I/O loop of the sockets, the jobs run after each wakeup
+    uint64_t deadline = listener->onPoll();
+    if (deadline != NO_DEADLINE) {
+        std::lock_guard<std::mutex> lk(lock);
+        uint64_t time = deadline < UINT64_MAX / 1000 ? deadline * 1000 : UINT64_MAX;
+        schedulePoll(listener, std::max(time, nowMicros()));
+    }
+
+    return true;
+}
+
+size_t SimulatedNetwork::runUntil(uint64_t time) {
+    uint64_t limit = time * 1000;
+    size_t count = 0;
+    while (runNext(limit))
+        count++;
+
+    std::lock_guard<std::mutex> lk(lock);
+    if (nowMicros() < limit)
+        setTime(limit);
+    return count;
+}
+
+bool SimulatedNetwork::runUntil(const std::function<bool()>& condition, uint64_t timeout) {
+    uint64_t limit = (now() + timeout) * 1000;
+    while (!condition()) {
+        if (!runNext(limit)) {
+            std::lock_guard<std::mutex> lk(lock);
+            if (nowMicros() < limit)
+                setTime(limit);
+            return condition();
+        }
+    }
+    return true;
+}
+
+} // namespace carrier
+} // namespace elastos
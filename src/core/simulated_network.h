@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <functional>
+
+#include "utils/time.h"
+#include "transport.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * An in-process network for the scaling tests and benchmarks, thousands of
+ * nodes can share it in one process.
+ *
+ * The nodes bound to it are run by run*() on the calling thread, one event
+ * at a time in the time order: a datagram arrives after the serialization
+ * delay at the uplink bandwidth of the sender and the link latency, or is
+ * lost. The network owns the virtual clock of the process and only moves
+ * it to the next event, so the simulated hours pass as fast as the nodes
+ * handle them. With the same seed, the same scenario replays identically.
+ *
+ * The lookups skip the bogon addresses, give the nodes public addresses
+ * unless built with CARRIER_DEVELOPMENT.
+ */
+class SimulatedNetwork : public Transport {
+public:
+    struct LinkProfile {
+        uint32_t latency {20};      // one way, in ms
+        uint32_t jitter {0};        // added to the latency, uniformly up to, in ms
+        double loss {0.0};          // the probability a datagram is lost
+        uint64_t bandwidth {0};     // of the sender uplink, in bytes per second, 0 unlimited
+    };
+
+    struct Stats {
+        uint64_t sent {0};
+        uint64_t delivered {0};
+        uint64_t lost {0};
+        uint64_t unreachable {0};
+        uint64_t bytes {0};
+    };
+
+    explicit SimulatedNetwork(uint64_t seed = 0, uint64_t start = systemTimeMillis());
+    ~SimulatedNetwork();
+
+    SimulatedNetwork(const SimulatedNetwork&) = delete;
+    SimulatedNetwork& operator=(const SimulatedNetwork&) = delete;
+
+    void setProfile(const LinkProfile& profile);
+    // The profile of the links from the bound address, overrides the default one
+    void setProfile(const SocketAddress& from, const LinkProfile& profile);
+
+    uint64_t now() const noexcept {
+        return clock.now();
+    }
+
+    // Runs the events due up to the virtual time, returns the events run
+    size_t runUntil(uint64_t time);
+
+    size_t runFor(uint64_t duration) {
+        return runUntil(now() + duration);
+    }
+
+    // Runs until the condition holds, checked between the events, or the
+    // virtual timeout passed. Returns the condition.
+    bool runUntil(const std::function<bool()>& condition, uint64_t timeout);
+
+    Stats getStats() const;
+
+    size_t getNumberOfEndpoints() const;
+
+    SocketAddress bind(const SocketAddress& addr, Listener& listener) override;
+    void unbind(const SocketAddress& bound) override;
+    int send(const SocketAddress& from, const uint8_t* data, size_t size, const SocketAddress& to) override;
+    void wakeup(Listener& listener) override;
+
+private:
+    struct Endpoint {
+        Listener* listener {nullptr};
+        uint64_t uplinkFree {0};    // us, when the uplink sent the queued datagrams
+    };
+
+    struct Binding {
+        int endpoints {0};
+        uint64_t pollTime {UINT64_MAX};     // us, the earliest armed poll
+    };
+
+    struct Event {
+        uint64_t time {0};          // us
+        uint64_t sequence {0};      // the events at the same time run in the FIFO order
+        Listener* listener {nullptr};   // the listener to poll, null for a datagram
+        SocketAddress from {};
+        SocketAddress to {};
+        std::vector<uint8_t> data {};
+
+        bool operator>(const Event& o) const noexcept {
+            return time != o.time ? time > o.time : sequence > o.sequence;
+        }
+    };
+
+    void push(Event&& event);
+    void schedulePoll(Listener* listener, uint64_t time);
+    bool runNext(uint64_t limit);
+    void setTime(uint64_t time);
+
+    uint64_t nowMicros() const noexcept {
+        return clock.now() * 1000 + micros;
+    }
+
+    VirtualClock clock;
+    uint64_t micros {0};            // the sub millisecond part of the network time
+
+    mutable std::mutex lock;
+    std::mt19937_64 random;
+    LinkProfile defaultProfile {};
+    std::map<SocketAddress, LinkProfile> profiles {};
+    std::map<SocketAddress, Endpoint> endpoints {};
+    std::map<Listener*, Binding> bindings {};
+    std::vector<Event> events {};   // a min heap by time
+    uint64_t sequence {0};
+    in_port_t nextPort {49152};
+    Stats stats {};
+};
+
+} // namespace carrier
+} // namespace elastos
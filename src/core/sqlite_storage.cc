@@ -25,6 +25,7 @@
 #include "crypto/hex.h"
 #include "constants.h"
 #include "scheduler.h"
+#include "utils/metrics.h"
 #include "sqlite_storage.h"
 
 namespace elastos {
@@ -123,7 +124,16 @@ SqliteStorage::~SqliteStorage() {
     }
 }
 
+// latency of the storage operations in microseconds, by operation
+static Histogram& operationLatency(const char* op) {
+    return Metrics::histogram("carrier_storage_operation_seconds",
+            "Latency of the storage operations", {{ "op", op }}, 1e-6);
+}
+
 void SqliteStorage::expire() {
+    static auto& latency = operationLatency("expire");
+    ScopedTimer timer(latency);
+
     const char *sqls[2] = { "DELETE FROM valores WHERE persistent != TRUE and timestamp < ?",  "DELETE FROM peers WHERE persistent != TRUE and timestamp < ?"};
     uint64_t ts[2];
     ts[0] = currentTimeMillis() - Constants::MAX_VALUE_AGE;
@@ -205,6 +215,9 @@ int SqliteStorage::getUserVersion() {
 }
 
 Sp<Value> SqliteStorage::getValue(const Id& valueId) {
+    static auto& latency = operationLatency("get_value");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt* pStmt {nullptr};
     if (sqlite3_prepare_v2(sqlite_store, SELECT_VALUE.c_str(), strlen(SELECT_VALUE.c_str()), &pStmt, 0) != SQLITE_OK) {
         sqlite3_finalize(pStmt);
@@ -263,6 +276,9 @@ Sp<Value> SqliteStorage::getValue(const Id& valueId) {
 }
 
 Sp<Value> SqliteStorage::putValue(const Value& value, int expectedSeq, bool persistent, bool updateLastAnnounce) {
+    static auto& latency = operationLatency("put_value");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt *pStmt;
 
     if (value.isMutable() && !value.isValid())
@@ -444,6 +460,9 @@ std::list<Value> SqliteStorage::getPersistentValues(uint64_t lastAnnounceBefore)
 }
 
 bool SqliteStorage::removeValue(const Id& valueId) {
+    static auto& latency = operationLatency("remove_value");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt* pStmt {nullptr};
     if (sqlite3_prepare_v2(sqlite_store, REMOVE_VALUE.c_str(), strlen(REMOVE_VALUE.c_str()), &pStmt, 0) != SQLITE_OK) {
         sqlite3_finalize(pStmt);
@@ -463,6 +482,9 @@ bool SqliteStorage::removeValue(const Id& valueId) {
 }
 
 std::list<PeerInfo> SqliteStorage::getPeer(const Id& peerId, int maxPeers) {
+    static auto& latency = operationLatency("get_peers");
+    ScopedTimer timer(latency);
+
     if (maxPeers <=0)
         maxPeers = 0x7fffffff;
 
@@ -523,6 +545,9 @@ std::list<PeerInfo> SqliteStorage::getPeer(const Id& peerId, int maxPeers) {
 }
 
 Sp<PeerInfo> SqliteStorage::getPeer(const Id& peerId, const Id& origin) {
+    static auto& latency = operationLatency("get_peer");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt *pStmt {nullptr};
     if(sqlite3_prepare_v2(sqlite_store, SELECT_PEER_WITH_SRC.c_str(), strlen(SELECT_PEER_WITH_SRC.c_str()), &pStmt, 0) != SQLITE_OK) {
         sqlite3_finalize(pStmt);
@@ -580,6 +605,9 @@ Sp<PeerInfo> SqliteStorage::getPeer(const Id& peerId, const Id& origin) {
 }
 
 void SqliteStorage::putPeer(const std::list<PeerInfo>& peers) {
+    static auto& latency = operationLatency("put_peers");
+    ScopedTimer timer(latency);
+
     if (sqlite3_exec(sqlite_store, "BEGIN", 0, 0, 0) != 0)
         throw std::runtime_error("Open auto commit mode failed.");
 
@@ -623,6 +651,9 @@ void SqliteStorage::putPeer(const std::list<PeerInfo>& peers) {
 }
 
 void SqliteStorage::putPeer(const PeerInfo& peer, bool persistent, bool updateLastAnnounce) {
+    static auto& latency = operationLatency("put_peer");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt *pStmt {nullptr};
     if(sqlite3_prepare_v2(sqlite_store, UPSERT_PEER.c_str(), strlen(UPSERT_PEER.c_str()), &pStmt, 0) != SQLITE_OK) {
         sqlite3_finalize(pStmt);
@@ -759,6 +790,9 @@ std::list<PeerInfo> SqliteStorage::getPersistentPeers(uint64_t lastAnnounceBefor
 }
 
 bool SqliteStorage::removePeer(const Id& peerId, const Id& origin) {
+    static auto& latency = operationLatency("remove_peer");
+    ScopedTimer timer(latency);
+
     sqlite3_stmt* pStmt {nullptr};
     if (sqlite3_prepare_v2(sqlite_store, REMOVE_PEER.c_str(), strlen(REMOVE_PEER.c_str()), &pStmt, 0) != SQLITE_OK) {
         sqlite3_finalize(pStmt);
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <algorithm>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+
+#include "utils/metrics.h"
+#include "utils/record_ring.h"
+#include "stage_tracer.h"
+
+namespace elastos {
+namespace carrier {
+
+namespace {
+
+const int METHODS = 7;
+
+struct Event {
+    uint64_t start;
+    uint32_t duration;      // nanoseconds, saturated
+    uint32_t thread;
+    StageTracer::Stage stage;
+    Message::Method method;
+};
+
+// never destroyed, the spans may still be recorded while the process exits
+RecordRing<Event>& events() {
+    static auto* ring = new RecordRing<Event>(StageTracer::EVENTS_CAPACITY);
+    return *ring;
+}
+
+Histogram& stageLatency(StageTracer::Stage stage, Message::Method method) {
+    static auto histograms = []() {
+        std::array<std::array<Histogram*, METHODS>, StageTracer::STAGES> histograms {};
+        for (int s = 0; s < StageTracer::STAGES; s++) {
+            for (int m = 0; m < METHODS; m++) {
+                histograms[s][m] = &Metrics::histogram("carrier_rpc_stage_seconds",
+                        "Time spent by the packets in each stage of the RPC server", {
+                            { "stage", StageTracer::stageName(static_cast<StageTracer::Stage>(s)) },
+                            { "method", Message::methodString(static_cast<Message::Method>(m)) }
+                        }, 1e-9);
+            }
+        }
+        return histograms;
+    }();
+
+    int m = static_cast<int>(method);
+    return *histograms[static_cast<int>(stage)][m < METHODS ? m : 0];
+}
+
+// small sequential ids read better than the hashed thread ids in the traces
+uint32_t threadNumber() noexcept {
+    static std::atomic<uint32_t> next {1};
+    thread_local uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+} // namespace
+
+uint64_t StageTracer::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void StageTracer::record(Stage stage, Message::Method method, uint64_t start, uint64_t end) noexcept {
+    uint64_t duration = end > start ? end - start : 0;
+    stageLatency(stage, method).record(duration);
+
+    Event event {};
+    event.start = start;
+    event.duration = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration;
+    event.thread = threadNumber();
+    event.stage = stage;
+    event.method = method;
+    events().push(event);
+}
+
+const char* StageTracer::stageName(Stage stage) noexcept {
+    static const char* NAMES[STAGES] = {
+        "decrypt", "parse", "verify", "dispatch", "storage", "encode", "send"
+    };
+
+    int index = static_cast<int>(stage);
+    return index < STAGES ? NAMES[index] : "unknown";
+}
+
+// the trace timestamps are microseconds, written with the full nanosecond precision
+struct Micros {
+    uint64_t nanos;
+};
+
+static std::ostream& operator<<(std::ostream& out, Micros m) {
+    auto fill = out.fill('0');
+    out << m.nanos / 1000 << '.' << std::setw(3) << m.nanos % 1000;
+    out.fill(fill);
+    return out;
+}
+
+void StageTracer::dumpChromeTrace(std::ostream& out) {
+    auto records = events().snapshot();
+    uint64_t origin = records.empty() ? 0 : records.front().start;
+    for (const auto& e : records)
+        origin = std::min(origin, e.start);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& e : records) {
+        out << (first ? "" : ",")
+            << "{\"name\":\"" << stageName(e.stage)
+            << "\",\"cat\":\"" << Message::methodString(e.method)
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << Micros{e.start - origin}
+            << ",\"dur\":" << Micros{e.duration} << "}";
+        first = false;
+    }
+    out << "]}\n";
+}
+
+} // namespace carrier
+} // namespace elastos
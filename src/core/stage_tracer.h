@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "messages/message.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Latency of the stages a packet goes through in the RPC server and the
+ * DHT: decryption, parsing, signature check, dispatch to the DHT, storage
+ * access and the send path. Each span goes into a per stage and method
+ * histogram of the metrics registry, carrier_rpc_stage_seconds, and into
+ * a ring of events that can be dumped in the Chrome trace event format for
+ * chrome://tracing or Perfetto.
+ *
+ * The spans are compiled in with ENABLE_STAGE_TRACING only, otherwise the
+ * CARRIER_STAGE_* macros expand to nothing and the hot path is unchanged.
+ */
+class StageTracer {
+public:
+    enum class Stage : uint8_t {
+        DECRYPT,
+        PARSE,
+        VERIFY,
+        DISPATCH,
+        STORAGE,
+        ENCODE,
+        SEND
+    };
+
+    static constexpr int STAGES = 7;
+    static constexpr size_t EVENTS_CAPACITY = 65536;
+
+    // Monotonic nanoseconds
+    static uint64_t now() noexcept;
+
+    static void record(Stage stage, Message::Method method, uint64_t start, uint64_t end) noexcept;
+
+    // Writes the recent spans as a Chrome trace event JSON object
+    static void dumpChromeTrace(std::ostream& out);
+
+    static const char* stageName(Stage stage) noexcept;
+
+    class Span {
+    public:
+        Span(Stage stage, Message::Method method) noexcept
+            : stage(stage), method(method), start(now()) {}
+
+        ~Span() {
+            record(stage, method, start, now());
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        Stage stage;
+        Message::Method method;
+        uint64_t start;
+    };
+};
+
+} // namespace carrier
+} // namespace elastos
+
+#ifdef CARRIER_STAGE_TRACING
+#define CARRIER_STAGE_SPAN(var, stage, method) \
+    elastos::carrier::StageTracer::Span var(elastos::carrier::StageTracer::Stage::stage, method)
+#define CARRIER_STAGE_MARK(var) \
+    const uint64_t var = elastos::carrier::StageTracer::now()
+#define CARRIER_STAGE_END(stage, method, start) \
+    elastos::carrier::StageTracer::record(elastos::carrier::StageTracer::Stage::stage, method, \
+            start, elastos::carrier::StageTracer::now())
+#define CARRIER_STAGE_RECORD(stage, method, start, end) \
+    elastos::carrier::StageTracer::record(elastos::carrier::StageTracer::Stage::stage, method, start, end)
+#else
+#define CARRIER_STAGE_SPAN(var, stage, method) do {} while (0)
+#define CARRIER_STAGE_MARK(var) do {} while (0)
+#define CARRIER_STAGE_END(stage, method, start) do {} while (0)
+#define CARRIER_STAGE_RECORD(stage, method, start, end) do {} while (0)
+#endif
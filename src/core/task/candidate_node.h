@@ -25,6 +25,7 @@
 #include "carrier/node_info.h"
 #include "utils/time.h"
 #include "kbucket_entry.h"
+#include "rtt_estimator.h"
 
 namespace elastos {
 namespace carrier {
@@ -34,6 +35,7 @@ public:
     CandidateNode(const NodeInfo& ni): NodeInfo(ni) {
         if (const auto entry = dynamic_cast<const KBucketEntry*>(&ni)) {
             reachable = entry->isReachable();
+            rtt = entry->getRTTEstimator();
         }
     }
 
@@ -52,6 +54,12 @@ public:
 
     void setReplied() {
         this->lastReply = currentTimeMillis();
+        if (lastSent != 0 && lastReply >= lastSent)
+            rtt.update(lastReply - lastSent);
+    }
+
+    const RTTEstimator& getRTTEstimator() const noexcept {
+        return rtt;
     }
 
     void setToken(int token) {
@@ -88,6 +96,8 @@ private:
     int  pinged {0};
 
     int token {0};
+
+    RTTEstimator rtt {};
 };
 
 } // namespace carrier
@@ -31,7 +31,7 @@ namespace carrier {
 
 bool LookupTask::isBogonAddress(const SocketAddress& addr) const {
 #ifdef CARRIER_DEVELOPMENT
-    return !addr.isAnyUnicast();
+    return !addr.isAnyUnicast() && !addr.isLoopback();
 #else
     return addr.isBogon();
 #endif
@@ -78,7 +78,7 @@ void NodeLookup::callResponsed(RPCCall* call, Sp<Message> response) {
     }
 
     auto findNodeResponse = std::static_pointer_cast<FindNodeResponse>(response);
-    auto nodes = findNodeResponse->getNodes(getDHT().getType());
+    const auto& nodes = findNodeResponse->getNodes(getDHT().getType());
     if (!nodes.empty())
         addCandidates(nodes);
 }
@@ -70,16 +70,14 @@ void PeerLookup::callResponsed(RPCCall* call, Sp<Message> message) {
     auto response = std::static_pointer_cast<FindPeerResponse>(message);
 
     if (response->hasPeers()) {
-        auto peers = response->getPeers();
-        for (auto peer : peers) {
-            if (!peer.isValid()) {
-                log->error("Response include invalid peer, signature mismatch");
-                return; // Ignore
-            }
-        }
-
-        resultHandler(peers, this);
+        // a forged record doesn't discard the valid peers of the response
+        auto peers = response->getValidPeers();
+        if (peers.size() != response->getPeers().size())
+            log->error("Response include {} invalid peers, signature mismatch",
+                    response->getPeers().size() - peers.size());
 
+        if (!peers.empty())
+            resultHandler(peers, this);
     }
     else {
         const auto& nodes = response->getNodes(getDHT().getType());
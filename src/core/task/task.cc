@@ -114,6 +114,7 @@ void Task::clearInFlight() {
         call->addStateChangeHandler([](RPCCall*, RPCCall::State, RPCCall::State) {});
     }
     inFlight.clear();
+    stalled = 0;
 }
 
 // TODO: CHECK ME!!!
@@ -162,11 +163,18 @@ bool Task::sendCall(Sp<NodeInfo> node, Sp<Message> request, std::function<void(S
     call->setName(name);
 #endif
     call->addStateChangeHandler([&](RPCCall* c, RPCCall::State previous, RPCCall::State current) {
+        if (previous == RPCCall::State::STALLED && stalled > 0)
+            stalled--;
+
         switch (current) {
         case RPCCall::State::SENT:
             callSent(c);
             break;
 
+        case RPCCall::State::STALLED:
+            stalled++;
+            break;
+
         case RPCCall::State::RESPONDED:
             removeCall(inFlight, c);
             if (!isFinished()) {
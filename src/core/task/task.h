@@ -123,8 +123,9 @@ public:
     operator std::string() const;
 
 protected:
+    // the stalled calls don't hold a request slot, a slow node shouldn't block the task
     bool canDoRequest() const {
-        return inFlight.size() < Constants::MAX_CONCURRENT_TASK_REQUESTS;
+        return inFlight.size() - stalled < Constants::MAX_CONCURRENT_TASK_REQUESTS;
     }
 
     bool sendCall(Sp<NodeInfo> node, Sp<Message> request, std::function<void(Sp<RPCCall>&)> modifyCallBeforeSubmit);
@@ -138,7 +139,7 @@ protected:
     virtual void update() {}
 
     virtual bool isDone() const {
-        return inFlight.empty() || isFinished();
+        return inFlight.size() == stalled || isFinished();
     }
 
     virtual std::string className() const {
@@ -169,6 +170,7 @@ private:
     uint64_t finishTime {};
 
     std::map<std::size_t, Sp<RPCCall>> inFlight {};
+    size_t stalled {0};
     std::list<TaskListener> listeners {};
 
     int lock {0};
@@ -35,6 +35,7 @@ void TaskManager::add(Sp<Task> task, bool prior) {
 
     if (task->getState() == Task::State::RUNNING) {
         running.emplace_back(task);
+        updateMetrics();
         return;
     }
 
@@ -45,6 +46,7 @@ void TaskManager::add(Sp<Task> task, bool prior) {
         queued.emplace_front(task);
     else
         queued.emplace_back(task);
+    updateMetrics();
 }
 
 void TaskManager::dequeue() {
@@ -56,11 +58,14 @@ void TaskManager::dequeue() {
 
         auto task = queued.front();
         queued.pop_front();
+        updateMetrics();
 
         if (task->isFinished())
             continue;
 
         running.emplace_back(task);
+        updateMetrics();
+        startedTasks->inc();
 
         task->start();
     }
@@ -90,6 +95,7 @@ void TaskManager::cancelAll() {
 void TaskManager::removeTask(Task* t) {
     running.remove_if([t](Sp<Task> task){ return task.get() == t; });
     queued.remove_if([t](Sp<Task> task){ return task.get() == t; });
+    updateMetrics();
 }
 
 }
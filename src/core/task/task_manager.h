@@ -24,9 +24,11 @@
 
 #include <memory>
 #include <list>
+#include <string>
 #include <atomic>
 
 #include "utils/log.h"
+#include "utils/metrics.h"
 #include "constants.h"
 
 namespace elastos {
@@ -37,8 +39,13 @@ class Task;
 
 class TaskManager {
 public:
-    TaskManager(): canceling(false) {
+    TaskManager(const std::string& network): canceling(false) {
         log = Logger::get("TaskManager");
+        queuedTasks = &Metrics::gauge("carrier_tasks", "DHT tasks queued and running",
+                {{ "network", network }, { "state", "queued" }});
+        runningTasks = &Metrics::gauge("carrier_tasks", "DHT tasks queued and running",
+                {{ "network", network }, { "state", "running" }});
+        startedTasks = &Metrics::counter("carrier_tasks_started_total", "DHT tasks started", {{ "network", network }});
     }
 
     void add(Sp<Task> task, bool prior);
@@ -57,12 +64,22 @@ public:
     void removeTask(Task* t);
 
 private:
+    void updateMetrics() noexcept {
+        queuedTasks->set(queued.size());
+        runningTasks->set(running.size());
+    }
+
     std::list<Sp<Task>> queued {};
     std::list<Sp<Task>> running {};
     bool canceling {false};
 
     Sp<Logger> log;
 
+    // per DHT network, set from the list sizes whenever they change
+    Gauge* queuedTasks;
+    Gauge* runningTasks;
+    Counter* startedTasks;
+
     mutable std::mutex taskman_mtx {};
 };
 
@@ -78,7 +78,7 @@ void ValueLookup::callResponsed(RPCCall* call, Sp<Message> message) {
             log->warn("Responsed value id {} mismatched with expected {}", static_cast<std::string>(id), static_cast<std::string>(getTarget()));
             return;
         }
-        if (!value.isValid()) {
+        if (!response->isSignatureValid()) {
             log->warn("Responsed value {} is invalid, signature mismatch", static_cast<std::string>(id));
             return;
         }
@@ -92,7 +92,7 @@ void ValueLookup::callResponsed(RPCCall* call, Sp<Message> message) {
         resultHandler(value, this);
     }
     else {
-        auto nodes = response->getNodes(getDHT().getType());
+        const auto& nodes = response->getNodes(getDHT().getType());
         if (!nodes.empty())
             addCandidates(nodes);
     }
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "carrier/socket_address.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * The datagram I/O under the RPC server. Without a transport the server
+ * reads and writes its own UDP sockets; a transport set on the node replaces
+ * them, e.g. the in-process SimulatedNetwork of the tests.
+ *
+ * A transport runs the servers bound to it on its own thread: it hands them
+ * the received datagrams and polls them when their next job is due. The
+ * server then has no I/O thread nor workers of its own.
+ */
+class Transport {
+public:
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+
+        // A datagram arrived from the peer
+        virtual void onReceive(const uint8_t* data, size_t size, const SocketAddress& from) = 0;
+
+        // Runs the due jobs, returns the next deadline in currentTimeMillis() time
+        virtual uint64_t onPoll() = 0;
+    };
+
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    virtual ~Transport() = default;
+
+    // Binds the listener to the address, a zero port picks a free one. Returns
+    // the bound address, throws a DhtError if the address is in use.
+    virtual SocketAddress bind(const SocketAddress& addr, Listener& listener) = 0;
+    virtual void unbind(const SocketAddress& bound) = 0;
+
+    // Returns the number of bytes sent, or -1 with errno set like sendto()
+    virtual int send(const SocketAddress& from, const uint8_t* data, size_t size, const SocketAddress& to) = 0;
+
+    // Polls the listener as soon as possible, safe to call from any thread
+    virtual void wakeup(Listener& listener) = 0;
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * A pool of byte buffers that keep their capacity between uses, so the
+ * packet paths stop allocating once the pool is warmed up.
+ */
+class BufferPool {
+public:
+    BufferPool(size_t maxBuffers, size_t bufferCapacity)
+        : maxBuffers(maxBuffers), bufferCapacity(bufferCapacity) {
+        buffers.reserve(maxBuffers);
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /*
+     * Returns an empty buffer, allocated only if the pool is exhausted.
+     */
+    std::vector<uint8_t> acquire() {
+        {
+            std::lock_guard<std::mutex> lk(lock);
+            if (!buffers.empty()) {
+                auto buffer = std::move(buffers.back());
+                buffers.pop_back();
+                return buffer;
+            }
+        }
+
+        std::vector<uint8_t> buffer {};
+        buffer.reserve(bufferCapacity);
+        return buffer;
+    }
+
+    void release(std::vector<uint8_t>&& buffer) {
+        if (buffer.capacity() == 0)
+            return;
+
+        buffer.clear();
+        std::lock_guard<std::mutex> lk(lock);
+        if (buffers.size() < maxBuffers)
+            buffers.push_back(std::move(buffer));
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(lock);
+        return buffers.size();
+    }
+
+private:
+    size_t maxBuffers;
+    size_t bufferCapacity;
+
+    mutable std::mutex lock;
+    std::vector<std::vector<uint8_t>> buffers {};
+};
+
+} // namespace carrier
+} // namespace elastos
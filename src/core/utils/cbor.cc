@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdexcept>
+
+#include "cbor.h"
+
+namespace elastos {
+namespace carrier {
+
+static const uint8_t INDEFINITE = 31;
+
+void CborWriter::writeHeader(uint8_t major, uint64_t value) {
+    uint8_t type = major << 5;
+
+    if (value < 24) {
+        buffer.push_back(type | (uint8_t)value);
+        return;
+    }
+
+    int bytes;
+    if (value <= 0xff) {
+        buffer.push_back(type | 24);
+        bytes = 1;
+    } else if (value <= 0xffff) {
+        buffer.push_back(type | 25);
+        bytes = 2;
+    } else if (value <= 0xffffffff) {
+        buffer.push_back(type | 26);
+        bytes = 4;
+    } else {
+        buffer.push_back(type | 27);
+        bytes = 8;
+    }
+
+    // network byte order
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8)
+        buffer.push_back((uint8_t)(value >> shift));
+}
+
+void CborReader::fail(const std::string& reason) {
+    throw std::invalid_argument("Invalid CBOR: " + reason);
+}
+
+const uint8_t* CborReader::take(uint64_t length) {
+    if (length > (uint64_t)(end - ptr))
+        fail("truncated data");
+
+    auto data = ptr;
+    ptr += length;
+    return data;
+}
+
+uint64_t CborReader::readArgument(uint8_t info) {
+    if (info < 24)
+        return info;
+
+    int bytes;
+    switch (info) {
+    case 24: bytes = 1; break;
+    case 25: bytes = 2; break;
+    case 26: bytes = 4; break;
+    case 27: bytes = 8; break;
+    default:
+        fail("unsupported additional information " + std::to_string(info));
+    }
+
+    auto data = take(bytes);
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+CborReader::Container CborReader::enterContainer(uint8_t major, const char* name) {
+    if (ptr >= end || (*ptr >> 5) != major)
+        fail(std::string("expected ") + name);
+
+    uint8_t info = *ptr++ & 0x1f;
+    if (info == INDEFINITE)
+        return { 0, true };
+
+    return { readArgument(info), false };
+}
+
+bool CborReader::hasNext(Container& container) {
+    if (container.indefinite) {
+        if (ptr >= end)
+            fail("truncated data");
+
+        if (*ptr == CborWriter::BREAK) {
+            ptr++;
+            return false;
+        }
+        return true;
+    }
+
+    if (container.remaining == 0)
+        return false;
+
+    container.remaining--;
+    return true;
+}
+
+int64_t CborReader::readInteger() {
+    if (ptr >= end)
+        fail("truncated data");
+
+    uint8_t major = *ptr >> 5;
+    uint8_t info = *ptr & 0x1f;
+    if (major != CborWriter::UNSIGNED && major != CborWriter::NEGATIVE)
+        fail("expected integer");
+
+    ptr++;
+    auto value = readArgument(info);
+    return major == CborWriter::UNSIGNED ? (int64_t)value : (int64_t)~value;
+}
+
+Blob CborReader::readBytes() {
+    if (ptr >= end || (*ptr >> 5) != CborWriter::BYTES)
+        fail("expected byte string");
+
+    uint8_t info = *ptr++ & 0x1f;
+    if (info == INDEFINITE)
+        fail("chunked byte string");
+
+    auto length = readArgument(info);
+    return Blob(take(length), length);
+}
+
+Blob CborReader::readBytes(size_t length) {
+    auto bytes = readBytes();
+    if (bytes.size() != length)
+        fail("expected " + std::to_string(length) + " bytes, got " + std::to_string(bytes.size()));
+    return bytes;
+}
+
+std::string_view CborReader::readText() {
+    if (ptr >= end || (*ptr >> 5) != CborWriter::TEXT)
+        fail("expected text string");
+
+    uint8_t info = *ptr++ & 0x1f;
+    if (info == INDEFINITE)
+        fail("chunked text string");
+
+    auto length = readArgument(info);
+    return std::string_view((const char*)take(length), length);
+}
+
+void CborReader::skip(int depth) {
+    if (depth > MAX_DEPTH)
+        fail("nested too deep");
+
+    if (ptr >= end)
+        fail("truncated data");
+
+    uint8_t major = *ptr >> 5;
+    uint8_t info = *ptr & 0x1f;
+
+    switch (major) {
+    case CborWriter::UNSIGNED:
+    case CborWriter::NEGATIVE:
+        readInteger();
+        break;
+
+    case CborWriter::BYTES:
+        readBytes();
+        break;
+
+    case CborWriter::TEXT:
+        readText();
+        break;
+
+    case CborWriter::ARRAY: {
+        auto array = enterArray();
+        while (hasNext(array))
+            skip(depth + 1);
+        break;
+    }
+
+    case CborWriter::MAP: {
+        auto map = enterMap();
+        while (hasNext(map)) {
+            skip(depth + 1);
+            skip(depth + 1);
+        }
+        break;
+    }
+
+    case CborWriter::TAG:
+        fail("unsupported tag");
+
+    default:
+        // simple values and floats, the break is only valid in a container
+        if (info == INDEFINITE)
+            fail("unexpected break");
+        if (info > 27)
+            fail("reserved simple value");
+        ptr++;
+        if (info >= 24)
+            take(info == 24 ? 1 : (info == 25 ? 2 : (info == 26 ? 4 : 8)));
+        break;
+    }
+}
+
+} // namespace carrier
+} // namespace elastos
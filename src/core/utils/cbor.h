@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "carrier/blob.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Minimal CBOR (RFC 8949) encoder for the fixed schema of the DHT messages,
+ * appends to the caller's buffer. The integers and the lengths take the
+ * shortest form, the same bytes nlohmann::json::to_cbor produces. The maps
+ * are written as they come, the callers write the keys in the byte-wise
+ * sorted order the std::map based JSON objects used.
+ */
+class CborWriter {
+public:
+    explicit CborWriter(std::vector<uint8_t>& buffer) noexcept : buffer(buffer) {}
+
+    void writeMap(size_t size) {
+        writeHeader(MAP, size);
+    }
+
+    void writeArray(size_t size) {
+        writeHeader(ARRAY, size);
+    }
+
+    void writeInteger(int64_t value) {
+        if (value >= 0)
+            writeHeader(UNSIGNED, (uint64_t)value);
+        else
+            writeHeader(NEGATIVE, ~(uint64_t)value);    // -1 - value
+    }
+
+    void writeBytes(const Blob& bytes) {
+        writeHeader(BYTES, bytes.size());
+        buffer.insert(buffer.end(), bytes.cbegin(), bytes.cend());
+    }
+
+    void writeText(std::string_view text) {
+        writeHeader(TEXT, text.size());
+        buffer.insert(buffer.end(), text.begin(), text.end());
+    }
+
+    void writeNull() {
+        buffer.push_back(NULL_VALUE);
+    }
+
+    size_t size() const noexcept {
+        return buffer.size();
+    }
+
+    static constexpr uint8_t UNSIGNED = 0;
+    static constexpr uint8_t NEGATIVE = 1;
+    static constexpr uint8_t BYTES = 2;
+    static constexpr uint8_t TEXT = 3;
+    static constexpr uint8_t ARRAY = 4;
+    static constexpr uint8_t MAP = 5;
+    static constexpr uint8_t TAG = 6;
+    static constexpr uint8_t SIMPLE = 7;
+
+    static constexpr uint8_t NULL_VALUE = 0xf6;
+    static constexpr uint8_t BREAK = 0xff;
+
+private:
+    void writeHeader(uint8_t major, uint64_t value);
+
+    std::vector<uint8_t>& buffer;
+};
+
+/*
+ * Pull parser over a CBOR encoded buffer, nothing is allocated: the byte
+ * and text strings are returned as views into the buffer, which must
+ * outlive them. Both the definite and the indefinite length maps and
+ * arrays are accepted, the chunked strings, the tags and the floating
+ * point numbers aren't used by the DHT messages and are rejected. Any
+ * malformed or unexpected input throws std::invalid_argument.
+ */
+class CborReader {
+public:
+    // Position in a map or an array being read
+    struct Container {
+        uint64_t remaining {0};
+        bool indefinite {false};
+    };
+
+    static constexpr int MAX_DEPTH = 16;
+
+    CborReader(const uint8_t* data, size_t size) noexcept : ptr(data), end(data + size) {}
+    explicit CborReader(const Blob& data) noexcept : CborReader(data.ptr(), data.size()) {}
+
+    Container enterMap() {
+        return enterContainer(CborWriter::MAP, "map");
+    }
+
+    Container enterArray() {
+        return enterContainer(CborWriter::ARRAY, "array");
+    }
+
+    // Once per array element or map entry, consumes the break of the indefinite ones
+    bool hasNext(Container& container);
+
+    void expectNext(Container& container) {
+        if (!hasNext(container))
+            fail("missing element");
+    }
+
+    // Skips the elements or entries left, the newer peers may add some
+    void skipRemaining(Container& container) {
+        while (hasNext(container))
+            skip();
+    }
+
+    bool isMap() const noexcept {
+        return ptr < end && (*ptr >> 5) == CborWriter::MAP;
+    }
+
+    bool isArray() const noexcept {
+        return ptr < end && (*ptr >> 5) == CborWriter::ARRAY;
+    }
+
+    // Consumes the null if it's the next item
+    bool readNull() noexcept {
+        if (ptr < end && *ptr == CborWriter::NULL_VALUE) {
+            ptr++;
+            return true;
+        }
+        return false;
+    }
+
+    // Out of range values wrap around, like the JSON number conversions
+    int64_t readInteger();
+    Blob readBytes();
+    // The fixed size ones, e.g. the nonces, checked before they reach the asserting constructors
+    Blob readBytes(size_t length);
+    std::string_view readText();
+
+    void skip() {
+        skip(0);
+    }
+
+    bool atEnd() const noexcept {
+        return ptr == end;
+    }
+
+private:
+    Container enterContainer(uint8_t major, const char* name);
+    uint64_t readArgument(uint8_t info);
+    const uint8_t* take(uint64_t length);
+    void skip(int depth);
+
+    [[noreturn]] static void fail(const std::string& reason);
+
+    const uint8_t* ptr;
+    const uint8_t* end;
+};
+
+} // namespace carrier
+} // namespace elastos
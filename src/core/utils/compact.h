@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "carrier/blob.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Fixed layout binary encoding of the compact wire format: the integers
+ * in network byte order, the ids and the addresses as raw bytes with
+ * their lengths implied by the layout. Appends to the caller's buffer.
+ */
+class CompactWriter {
+public:
+    explicit CompactWriter(std::vector<uint8_t>& buffer) noexcept : buffer(buffer) {}
+
+    void writeUInt8(uint8_t value) {
+        buffer.push_back(value);
+    }
+
+    void writeUInt16(uint16_t value) {
+        buffer.push_back((uint8_t)(value >> 8));
+        buffer.push_back((uint8_t)value);
+    }
+
+    void writeUInt32(uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            buffer.push_back((uint8_t)(value >> shift));
+    }
+
+    void writeBytes(const Blob& bytes) {
+        buffer.insert(buffer.end(), bytes.cbegin(), bytes.cend());
+    }
+
+private:
+    std::vector<uint8_t>& buffer;
+};
+
+/*
+ * Reader over a compact encoded buffer, the byte strings are returned as
+ * views into the buffer. Reading past the end throws std::invalid_argument.
+ */
+class CompactReader {
+public:
+    CompactReader(const uint8_t* data, size_t size) noexcept : ptr(data), end(data + size) {}
+
+    uint8_t readUInt8() {
+        return *take(1);
+    }
+
+    uint16_t readUInt16() {
+        auto data = take(2);
+        return (uint16_t)(data[0] << 8 | data[1]);
+    }
+
+    uint32_t readUInt32() {
+        auto data = take(4);
+        return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3];
+    }
+
+    Blob readBytes(size_t length) {
+        return Blob(take(length), length);
+    }
+
+    size_t remaining() const noexcept {
+        return end - ptr;
+    }
+
+    bool atEnd() const noexcept {
+        return ptr == end;
+    }
+
+private:
+    const uint8_t* take(size_t length) {
+        if (length > (size_t)(end - ptr))
+            throw std::invalid_argument("Invalid compact message: truncated data");
+
+        auto data = ptr;
+        ptr += length;
+        return data;
+    }
+
+    const uint8_t* ptr;
+    const uint8_t* end;
+};
+
+} // namespace carrier
+} // namespace elastos
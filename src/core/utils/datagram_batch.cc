@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef HAVE_MMSG
+#include <sys/socket.h>
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <winsock2.h>
+#endif
+
+#include "datagram_batch.h"
+
+namespace elastos {
+namespace carrier {
+
+struct DatagramBatch::Native {
+#ifdef HAVE_MMSG
+    std::vector<iovec> iovecs {};
+    std::vector<mmsghdr> headers {};
+#endif
+};
+
+DatagramBatch::DatagramBatch(size_t capacity, size_t bufferSize)
+    : _capacity(capacity > 0 ? capacity : 1), bufferSize(bufferSize), native(std::make_unique<Native>()) {
+    lengths.resize(_capacity);
+    addrs.resize(_capacity);
+    outgoing.resize(_capacity);
+#ifdef HAVE_MMSG
+    native->iovecs.resize(_capacity);
+    native->headers.resize(_capacity);
+#endif
+}
+
+DatagramBatch::~DatagramBatch() {}
+
+int DatagramBatch::receive(int fd) {
+    // the receive buffers are only needed by the receiving batches
+    if (buffers.empty())
+        buffers.resize(_capacity * bufferSize);
+
+    count = 0;
+
+#ifdef HAVE_MMSG
+    auto& iovecs = native->iovecs;
+    auto& headers = native->headers;
+    for (size_t i = 0; i < _capacity; i++) {
+        iovecs[i].iov_base = buffers.data() + i * bufferSize;
+        iovecs[i].iov_len = bufferSize;
+
+        std::memset(&headers[i], 0, sizeof(mmsghdr));
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+        headers[i].msg_hdr.msg_name = &addrs[i];
+        headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+    }
+
+    int rc = recvmmsg(fd, headers.data(), _capacity, MSG_DONTWAIT, nullptr);
+    if (rc < 0)
+        return -1;
+
+    for (int i = 0; i < rc; i++)
+        lengths[i] = headers[i].msg_len;
+
+    count = rc;
+#else
+    while (count < _capacity) {
+        socklen_t addrlen = sizeof(sockaddr_storage);
+        auto rc = recvfrom(fd, (char*)buffers.data() + count * bufferSize, bufferSize, 0,
+                (sockaddr*)&addrs[count], &addrlen);
+        if (rc < 0) {
+            if (count == 0)
+                return -1;
+            break;
+        }
+
+        lengths[count++] = rc;
+    }
+#endif
+
+    return count;
+}
+
+bool DatagramBatch::add(const Blob& data, const SocketAddress& to) {
+    if (count >= _capacity)
+        return false;
+
+    outgoing[count] = data;
+    std::memcpy(&addrs[count], to.addr(), to.length());
+    lengths[count] = to.length();
+    count++;
+    return true;
+}
+
+int DatagramBatch::send(int fd, int flags) {
+    if (count == 0)
+        return 0;
+
+#ifdef HAVE_MMSG
+    auto& iovecs = native->iovecs;
+    auto& headers = native->headers;
+    for (size_t i = 0; i < count; i++) {
+        iovecs[i].iov_base = const_cast<uint8_t*>(outgoing[i].ptr());
+        iovecs[i].iov_len = outgoing[i].size();
+
+        std::memset(&headers[i], 0, sizeof(mmsghdr));
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+        headers[i].msg_hdr.msg_name = &addrs[i];
+        headers[i].msg_hdr.msg_namelen = lengths[i];
+    }
+
+    return sendmmsg(fd, headers.data(), count, flags);
+#else
+    size_t sent = 0;
+    for (; sent < count; sent++) {
+        auto rc = sendto(fd, (const char*)outgoing[sent].ptr(), outgoing[sent].size(), flags,
+                (const sockaddr*)&addrs[sent], (socklen_t)lengths[sent]);
+        if (rc < 0) {
+            if (sent == 0)
+                return -1;
+            break;
+        }
+    }
+    return sent;
+#endif
+}
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "carrier/blob.h"
+#include "carrier/socket_address.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * A batch of datagrams received or sent with one system call, using
+ * recvmmsg/sendmmsg where available and falling back to a loop of
+ * recvfrom/sendto otherwise. The buffers are allocated once and reused.
+ */
+class DatagramBatch {
+public:
+    static const size_t MAX_DATAGRAM_SIZE = 64 * 1024;
+
+    explicit DatagramBatch(size_t capacity, size_t bufferSize = MAX_DATAGRAM_SIZE);
+    ~DatagramBatch();
+
+    size_t capacity() const noexcept {
+        return _capacity;
+    }
+
+    size_t size() const noexcept {
+        return count;
+    }
+
+    /*
+     * Receives up to capacity datagrams without blocking, returns the number
+     * of datagrams received, or -1 with errno set.
+     */
+    int receive(int fd);
+
+    Blob datagram(size_t index) const noexcept {
+        return {buffers.data() + index * bufferSize, lengths[index]};
+    }
+
+    SocketAddress from(size_t index) const noexcept {
+        return {addrs[index]};
+    }
+
+    void clear() noexcept {
+        count = 0;
+    }
+
+    /*
+     * Queues a datagram to send, the data is not copied and must stay valid
+     * until send() returns. Returns false if the batch is full.
+     */
+    bool add(const Blob& data, const SocketAddress& to);
+
+    /*
+     * Sends the queued datagrams, returns the number of datagrams sent from
+     * the head of the batch, or -1 with errno set if nothing was sent.
+     */
+    int send(int fd, int flags);
+
+private:
+    size_t _capacity;
+    size_t bufferSize;
+    size_t count {0};
+
+    std::vector<uint8_t> buffers {};
+    std::vector<size_t> lengths {};
+    std::vector<sockaddr_storage> addrs {};
+    std::vector<Blob> outgoing {};
+
+    // the mmsghdr/iovec arrays, only used when recvmmsg/sendmmsg are available
+    struct Native;
+    std::unique_ptr<Native> native;
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_EPOLL
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#elif defined(_WIN32) || defined(_WIN64)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include "utils/time.h"
+#include "event_poller.h"
+
+namespace elastos {
+namespace carrier {
+
+#ifdef HAVE_EPOLL
+static int watch(int epollFd, int fd)
+{
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void closeFds(std::initializer_list<int> fds)
+{
+    for (int fd : fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+#endif
+
+EventPoller::EventPoller() {
+#ifdef HAVE_EPOLL
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || timerFd < 0 || eventFd < 0 ||
+            watch(epollFd, timerFd) < 0 || watch(epollFd, eventFd) < 0) {
+        auto error = std::string(std::strerror(errno));
+        closeFds({epollFd, timerFd, eventFd});
+        throw std::runtime_error("Failed to create the event poller: " + error);
+    }
+#endif
+}
+
+EventPoller::~EventPoller() {
+#ifdef HAVE_EPOLL
+    closeFds({epollFd, timerFd, eventFd});
+#endif
+}
+
+void EventPoller::add(int fd) {
+    if (fd < 0 || std::find(fds.begin(), fds.end(), fd) != fds.end())
+        return;
+
+#ifdef HAVE_EPOLL
+    if (watch(epollFd, fd) < 0)
+        throw std::runtime_error("Failed to add fd to the event poller: " + std::string(std::strerror(errno)));
+#endif
+    fds.push_back(fd);
+    ready.reserve(fds.size());
+}
+
+void EventPoller::remove(int fd) {
+    auto it = std::find(fds.begin(), fds.end(), fd);
+    if (it == fds.end())
+        return;
+
+#ifdef HAVE_EPOLL
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    fds.erase(it);
+}
+
+void EventPoller::setDeadline(uint64_t deadline) {
+    if (deadline == this->deadline)
+        return;
+
+    this->deadline = deadline;
+
+#ifdef HAVE_EPOLL
+    // the scheduler works on the wall clock in milliseconds, the timer is
+    // armed with the relative delay on the monotonic clock
+    struct itimerspec spec {};
+    if (deadline != NO_DEADLINE) {
+        uint64_t now = currentTimeMillis();
+        uint64_t delay = deadline > now ? deadline - now : 0;
+        spec.it_value.tv_sec = delay / 1000;
+        spec.it_value.tv_nsec = (delay % 1000) * 1000000;
+        // a zero it_value disarms the timer, expire as soon as possible instead
+        if (delay == 0)
+            spec.it_value.tv_nsec = 1;
+    }
+
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+#endif
+}
+
+int EventPoller::wait() {
+    ready.clear();
+
+#ifdef HAVE_EPOLL
+    struct epoll_event events[16];
+    int rc = epoll_wait(epollFd, events, 16, -1);
+    if (rc < 0)
+        return -1;
+
+    for (int i = 0; i < rc; i++) {
+        int fd = events[i].data.fd;
+        if (fd == timerFd || fd == eventFd) {
+            uint64_t value;
+            // reset the counters, EAGAIN is harmless
+            [[maybe_unused]] auto n = read(fd, &value, sizeof(value));
+            // the timer is one-shot, let the next setDeadline() re-arm it
+            if (fd == timerFd)
+                deadline = NO_DEADLINE;
+        } else {
+            ready.push_back(fd);
+        }
+    }
+#else
+    fd_set readfds;
+    FD_ZERO(&readfds);
+
+    int maxFd = -1;
+    for (int fd : fds) {
+        FD_SET(fd, &readfds);
+        maxFd = std::max(maxFd, fd);
+    }
+
+    uint64_t timeout = MAX_WAIT_TIME;
+    if (deadline != NO_DEADLINE) {
+        uint64_t now = currentTimeMillis();
+        timeout = std::min(timeout, deadline > now ? deadline - now : 0);
+    }
+
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+
+    int rc = select(maxFd + 1, &readfds, nullptr, nullptr, &tv);
+    if (rc < 0)
+        return -1;
+
+    for (int fd : fds) {
+        if (FD_ISSET(fd, &readfds))
+            ready.push_back(fd);
+    }
+
+    if (deadline != NO_DEADLINE && currentTimeMillis() >= deadline)
+        deadline = NO_DEADLINE;
+#endif
+
+    return (int)ready.size();
+}
+
+bool EventPoller::isReadable(int fd) const noexcept {
+    return fd >= 0 && std::find(ready.begin(), ready.end(), fd) != ready.end();
+}
+
+void EventPoller::wakeup() {
+#ifdef HAVE_EPOLL
+    uint64_t value = 1;
+    [[maybe_unused]] auto n = write(eventFd, &value, sizeof(value));
+#endif
+}
+
+} // namespace carrier
+} // namespace elastos
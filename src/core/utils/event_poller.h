@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Waits on a set of sockets, a deadline and cross-thread wakeups.
+ *
+ * On Linux it is an epoll instance with a timerfd armed to the deadline and
+ * an eventfd for the wakeups, so the waiting thread only runs when there is
+ * something to do. Elsewhere it falls back to select() with the timeout
+ * computed from the deadline, capped at MAX_WAIT_TIME because the wakeups
+ * can't interrupt the wait.
+ */
+class EventPoller {
+public:
+    static const int MAX_WAIT_TIME = 100;
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+
+    EventPoller();
+    ~EventPoller();
+
+    EventPoller(const EventPoller&) = delete;
+    EventPoller& operator=(const EventPoller&) = delete;
+
+    void add(int fd);
+    void remove(int fd);
+
+    /*
+     * Arms the timer to the deadline, in currentTimeMillis() time,
+     * NO_DEADLINE disarms it.
+     */
+    void setDeadline(uint64_t deadline);
+
+    uint64_t getDeadline() const noexcept {
+        return deadline;
+    }
+
+    /*
+     * Blocks until a socket is readable, the deadline passed or wakeup() is
+     * called. Returns the number of readable sockets, or -1 with errno set.
+     */
+    int wait();
+
+    bool isReadable(int fd) const noexcept;
+
+    /*
+     * Interrupts a pending or the next wait(), safe to call from any thread.
+     */
+    void wakeup();
+
+private:
+    std::vector<int> fds {};
+    std::vector<int> ready {};
+    uint64_t deadline {NO_DEADLINE};
+
+    int epollFd {-1};
+    int timerFd {-1};
+    int eventFd {-1};
+};
+
+} // namespace carrier
+} // namespace elastos
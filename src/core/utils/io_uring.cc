@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifdef HAVE_IO_URING
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#include "io_uring.h"
+
+namespace elastos {
+namespace carrier {
+
+#ifdef HAVE_IO_URING
+
+static const uint64_t RECEIVE_TAG = 1ULL << 63;
+static const uint64_t CANCEL_TAG = 1ULL << 62;
+static const uint16_t BUFFER_GROUP = 0;
+
+template <typename T>
+static inline T loadAcquire(const T* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+static inline void storeRelease(T* p, T v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static std::runtime_error error(const std::string& what, int err) {
+    return std::runtime_error(what + ": " + std::string(std::strerror(err)));
+}
+
+struct IoUring::Ring {
+    io_uring_params params {};
+
+    void* sqPtr {MAP_FAILED};
+    size_t sqSize {0};
+    void* cqPtr {MAP_FAILED};
+    size_t cqSize {0};
+    io_uring_sqe* sqes {(io_uring_sqe*)MAP_FAILED};
+    size_t sqesSize {0};
+
+    unsigned* sqHead {nullptr};
+    unsigned* sqTail {nullptr};
+    unsigned* sqArray {nullptr};
+    unsigned sqMask {0};
+    unsigned sqPending {0};     // the local tail, published by submit()
+
+    unsigned* cqHead {nullptr};
+    unsigned* cqTail {nullptr};
+    io_uring_cqe* cqes {nullptr};
+    unsigned cqMask {0};
+
+    // provided buffers for the multishot receives
+    io_uring_buf_ring* bufRing {(io_uring_buf_ring*)MAP_FAILED};
+    size_t bufRingSize {0};
+    unsigned bufEntries {0};
+    unsigned short bufTail {0};
+    size_t bufferSize {0};
+    std::vector<uint8_t> buffers {};
+    msghdr receiveHeader {};
+    int armed {0};
+    bool closing {false};
+
+    struct SendSlot {
+        msghdr header {};
+        iovec iov {};
+        sockaddr_storage addr {};
+        std::vector<uint8_t> packet {};
+    };
+
+    std::vector<SendSlot> slots {};
+    std::vector<unsigned> freeSlots {};
+
+    io_uring_sqe* getSqe() {
+        if (sqPending - loadAcquire(sqHead) >= params.sq_entries)
+            return nullptr;
+
+        unsigned index = sqPending & sqMask;
+        auto sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        sqPending++;
+        return sqe;
+    }
+
+    void provide(unsigned short bid) {
+        // not bufRing->bufs, the flexible array wrapper of the uapi header
+        // has a non-zero size in C++ and shifts the entries
+        auto buf = reinterpret_cast<io_uring_buf*>(bufRing) + (bufTail & (bufEntries - 1));
+        buf->addr = (uint64_t)(buffers.data() + bid * bufferSize);
+        buf->len = (uint32_t)bufferSize;
+        buf->bid = bid;
+        bufTail++;
+    }
+
+    void prepareReceive(io_uring_sqe* sqe, int sock) {
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = sock;
+        sqe->addr = (uint64_t)&receiveHeader;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = BUFFER_GROUP;
+        sqe->user_data = RECEIVE_TAG | (uint32_t)sock;
+        armed++;
+    }
+};
+
+IoUring::IoUring(unsigned entries, unsigned buffers, size_t bufferSize) : ring(std::make_unique<Ring>()) {
+    auto& r = *ring;
+
+    // the multishot receives post many completions per request
+    r.params.flags = IORING_SETUP_CQSIZE;
+    r.params.cq_entries = entries * 4;
+
+    ringFd = (int)syscall(__NR_io_uring_setup, entries, &r.params);
+    if (ringFd < 0)
+        throw error("io_uring_setup failed", errno);
+
+    if (!(r.params.features & IORING_FEAT_NODROP)) {
+        shutdown();
+        throw std::runtime_error("io_uring_setup failed: the kernel may drop completions");
+    }
+
+    r.sqSize = r.params.sq_off.array + r.params.sq_entries * sizeof(unsigned);
+    r.cqSize = r.params.cq_off.cqes + r.params.cq_entries * sizeof(io_uring_cqe);
+    if (r.params.features & IORING_FEAT_SINGLE_MMAP)
+        r.sqSize = r.cqSize = std::max(r.sqSize, r.cqSize);
+
+    r.sqPtr = mmap(nullptr, r.sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (r.sqPtr != MAP_FAILED) {
+        r.cqPtr = (r.params.features & IORING_FEAT_SINGLE_MMAP) ? r.sqPtr :
+                mmap(nullptr, r.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    }
+    if (r.cqPtr != MAP_FAILED) {
+        r.sqesSize = r.params.sq_entries * sizeof(io_uring_sqe);
+        r.sqes = (io_uring_sqe*)mmap(nullptr, r.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ringFd, IORING_OFF_SQES);
+    }
+    if (r.sqes == MAP_FAILED) {
+        int err = errno;
+        shutdown();
+        throw error("Failed to map the io_uring", err);
+    }
+
+    auto sq = (uint8_t*)r.sqPtr;
+    r.sqHead = (unsigned*)(sq + r.params.sq_off.head);
+    r.sqTail = (unsigned*)(sq + r.params.sq_off.tail);
+    r.sqArray = (unsigned*)(sq + r.params.sq_off.array);
+    r.sqMask = *(unsigned*)(sq + r.params.sq_off.ring_mask);
+    r.sqPending = *r.sqTail;
+
+    auto cq = (uint8_t*)r.cqPtr;
+    r.cqHead = (unsigned*)(cq + r.params.cq_off.head);
+    r.cqTail = (unsigned*)(cq + r.params.cq_off.tail);
+    r.cqes = (io_uring_cqe*)(cq + r.params.cq_off.cqes);
+    r.cqMask = *(unsigned*)(cq + r.params.cq_off.ring_mask);
+
+    // the provided buffer ring must be a power of 2 and page aligned
+    r.bufEntries = 1;
+    while (r.bufEntries < buffers && r.bufEntries < 32768)
+        r.bufEntries <<= 1;
+    r.bufferSize = bufferSize;
+    r.bufRingSize = r.bufEntries * sizeof(io_uring_buf);
+    r.bufRing = (io_uring_buf_ring*)mmap(nullptr, r.bufRingSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (r.bufRing == MAP_FAILED) {
+        int err = errno;
+        shutdown();
+        throw error("Failed to allocate the io_uring buffer ring", err);
+    }
+
+    io_uring_buf_reg reg {};
+    reg.ring_addr = (uint64_t)r.bufRing;
+    reg.ring_entries = r.bufEntries;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int err = errno;
+        shutdown();
+        throw error("Failed to register the io_uring buffer ring", err);
+    }
+
+    // the receive buffers are only touched by the kernel as datagrams arrive
+    r.buffers.resize(r.bufEntries * r.bufferSize);
+    for (unsigned bid = 0; bid < r.bufEntries; bid++)
+        r.provide(bid);
+    storeRelease(&r.bufRing->tail, r.bufTail);
+
+    r.receiveHeader.msg_namelen = sizeof(sockaddr_storage);
+
+    r.slots.resize(entries);
+    r.freeSlots.reserve(entries);
+    for (unsigned i = entries; i > 0; i--)
+        r.freeSlots.push_back(i - 1);
+}
+
+IoUring::~IoUring() {
+    shutdown();
+}
+
+void IoUring::shutdown() {
+    auto& r = *ring;
+
+    if (ringFd >= 0 && r.cqes != nullptr) {
+        // cancel the armed receives and wait for the in-flight requests,
+        // the kernel must not write into the buffers once they are freed
+        r.closing = true;
+
+        auto sqe = r.getSqe();
+        if (sqe == nullptr && submit() >= 0)
+            sqe = r.getSqe();
+        if (sqe != nullptr) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            sqe->user_data = CANCEL_TAG;
+            submit();
+        }
+
+        for (int i = 0; i < 100; i++) {
+            if (r.armed == 0 && r.freeSlots.size() == r.slots.size())
+                break;
+
+            if (enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                break;
+
+            poll([](const Blob&, const SocketAddress&) {});
+        }
+    }
+
+    if (r.bufRing != MAP_FAILED)
+        munmap(r.bufRing, r.bufRingSize);
+    if (r.sqes != MAP_FAILED)
+        munmap(r.sqes, r.sqesSize);
+    if (r.cqPtr != MAP_FAILED && r.cqPtr != r.sqPtr)
+        munmap(r.cqPtr, r.cqSize);
+    if (r.sqPtr != MAP_FAILED)
+        munmap(r.sqPtr, r.sqSize);
+
+    r.bufRing = (io_uring_buf_ring*)MAP_FAILED;
+    r.sqes = (io_uring_sqe*)MAP_FAILED;
+    r.cqPtr = r.sqPtr = MAP_FAILED;
+    r.cqes = nullptr;
+
+    if (ringFd >= 0)
+        close(ringFd);
+    ringFd = -1;
+}
+
+void IoUring::listen(int sock) {
+    auto& r = *ring;
+    if (sock < 0)
+        return;
+
+    auto sqe = r.getSqe();
+    if (sqe == nullptr && submit() >= 0)
+        sqe = r.getSqe();
+    if (sqe == nullptr)
+        throw std::runtime_error("io_uring submission queue is full");
+
+    r.prepareReceive(sqe, sock);
+    if (submit() < 0)
+        throw error("Failed to submit the io_uring receive", errno);
+
+    // kernels without multishot receive fail the request at once
+    unsigned tail = loadAcquire(r.cqTail);
+    for (unsigned head = *r.cqHead; head != tail; head++) {
+        auto cqe = &r.cqes[head & r.cqMask];
+        if (cqe->user_data == (RECEIVE_TAG | (uint32_t)sock) && cqe->res < 0 && !(cqe->flags & IORING_CQE_F_MORE))
+            throw error("io_uring multishot receive is not supported", -cqe->res);
+    }
+}
+
+bool IoUring::send(int sock, std::vector<uint8_t>& packet, const SocketAddress& to) {
+    auto& r = *ring;
+    if (r.freeSlots.empty())
+        return false;
+
+    auto sqe = r.getSqe();
+    if (sqe == nullptr && submit() >= 0)
+        sqe = r.getSqe();
+    if (sqe == nullptr)
+        return false;
+
+    unsigned index = r.freeSlots.back();
+    r.freeSlots.pop_back();
+
+    auto& slot = r.slots[index];
+    slot.packet.swap(packet);
+    packet.clear();
+    std::memcpy(&slot.addr, to.addr(), to.length());
+    slot.iov.iov_base = slot.packet.data();
+    slot.iov.iov_len = slot.packet.size();
+    slot.header.msg_name = &slot.addr;
+    slot.header.msg_namelen = to.length();
+    slot.header.msg_iov = &slot.iov;
+    slot.header.msg_iovlen = 1;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = sock;
+    sqe->addr = (uint64_t)&slot.header;
+    sqe->len = 1;
+#ifdef MSG_NOSIGNAL
+    sqe->msg_flags = MSG_NOSIGNAL;
+#endif
+    sqe->user_data = index;
+    return true;
+}
+
+int IoUring::submit() {
+    auto& r = *ring;
+
+    unsigned toSubmit = r.sqPending - *r.sqTail;
+    if (toSubmit == 0)
+        return 0;
+
+    storeRelease(r.sqTail, r.sqPending);
+
+    int rc;
+    do {
+        rc = enter(ringFd, toSubmit, 0, 0);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc < 0)
+        return -1;
+
+    submitCalls++;
+    submittedRequests += rc;
+    return rc;
+}
+
+int IoUring::poll(const Handler& handler) {
+    auto& r = *ring;
+    int received = 0;
+    std::vector<int> rearm {};
+
+    unsigned head = *r.cqHead;
+    unsigned tail = loadAcquire(r.cqTail);
+
+    for (; head != tail; head++) {
+        auto cqe = &r.cqes[head & r.cqMask];
+
+        if (!(cqe->user_data & RECEIVE_TAG)) {
+            if (cqe->user_data == CANCEL_TAG)
+                continue;
+
+            if (cqe->res < 0)
+                sendErrors++;
+
+            r.freeSlots.push_back((unsigned)cqe->user_data);
+            continue;
+        }
+
+        if (cqe->flags & IORING_CQE_F_BUFFER) {
+            auto bid = (unsigned short)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+            auto buf = r.buffers.data() + bid * r.bufferSize;
+
+            if (cqe->res >= (int)sizeof(io_uring_recvmsg_out)) {
+                auto out = (io_uring_recvmsg_out*)buf;
+                auto name = buf + sizeof(io_uring_recvmsg_out);
+                auto payload = name + r.receiveHeader.msg_namelen + r.receiveHeader.msg_controllen;
+
+                if (out->flags & MSG_TRUNC) {
+                    droppedDatagrams++;
+                } else {
+                    sockaddr_storage from {};
+                    std::memcpy(&from, name, std::min<size_t>(out->namelen, sizeof(from)));
+                    handler({payload, out->payloadlen}, SocketAddress(from));
+                    received++;
+                }
+            }
+
+            r.provide(bid);
+        }
+
+        if (!(cqe->flags & IORING_CQE_F_MORE)) {
+            // the multishot receive terminated, e.g. ran out of buffers
+            r.armed--;
+            if (!r.closing && cqe->res != -ECANCELED && cqe->res != -EBADF)
+                rearm.push_back((int)(cqe->user_data & ~RECEIVE_TAG));
+        }
+    }
+
+    storeRelease(r.cqHead, head);
+    storeRelease(&r.bufRing->tail, r.bufTail);
+
+    for (int sock : rearm) {
+        auto sqe = r.getSqe();
+        if (sqe == nullptr && submit() >= 0)
+            sqe = r.getSqe();
+        if (sqe != nullptr)
+            r.prepareReceive(sqe, sock);
+    }
+
+    return received;
+}
+
+#else // HAVE_IO_URING
+
+struct IoUring::Ring {};
+
+IoUring::IoUring(unsigned, unsigned, size_t) {
+    throw std::runtime_error("io_uring support is not built");
+}
+
+IoUring::~IoUring() {}
+
+void IoUring::shutdown() {}
+
+void IoUring::listen(int) {}
+
+bool IoUring::send(int, std::vector<uint8_t>&, const SocketAddress&) {
+    return false;
+}
+
+int IoUring::submit() {
+    return 0;
+}
+
+int IoUring::poll(const Handler&) {
+    return 0;
+}
+
+#endif // HAVE_IO_URING
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+#include "carrier/blob.h"
+#include "carrier/socket_address.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * An io_uring instance for the datagram sockets of the RPC server, using the
+ * kernel interface directly.
+ *
+ * Each socket has a multishot recvmsg posted against a ring of provided
+ * buffers, the receive stays armed without being resubmitted per datagram.
+ * The sends are queued as sendmsg requests and submitted together with one
+ * io_uring_enter() per loop iteration. The ring fd becomes readable when
+ * completions are pending, so it can be waited on with the EventPoller.
+ *
+ * Requires Linux 6.0 or later, the constructor and listen() throw if the
+ * kernel doesn't support the features needed, or the library is built
+ * without HAVE_IO_URING.
+ */
+class IoUring {
+public:
+    using Handler = std::function<void(const Blob&, const SocketAddress&)>;
+
+    IoUring(unsigned entries = 256, unsigned buffers = 256, size_t bufferSize = 64 * 1024);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    int fd() const noexcept {
+        return ringFd;
+    }
+
+    /*
+     * Posts a multishot receive for the socket.
+     */
+    void listen(int sock);
+
+    /*
+     * Queues a datagram to send. On success the packet is swapped with a
+     * recycled buffer, returns false if no send slot is free.
+     */
+    bool send(int sock, std::vector<uint8_t>& packet, const SocketAddress& to);
+
+    /*
+     * Submits the queued requests with one system call, returns the number
+     * of requests submitted, or -1 with errno set.
+     */
+    int submit();
+
+    /*
+     * Reaps the completions and calls the handler for every datagram
+     * received, returns the number of datagrams.
+     */
+    int poll(const Handler& handler);
+
+    uint64_t getSubmitCalls() const noexcept {
+        return submitCalls;
+    }
+
+    uint64_t getSubmittedRequests() const noexcept {
+        return submittedRequests;
+    }
+
+    uint64_t getDroppedDatagrams() const noexcept {
+        return droppedDatagrams;
+    }
+
+    uint64_t getSendErrors() const noexcept {
+        return sendErrors;
+    }
+
+private:
+    void shutdown();
+
+    int ringFd {-1};
+
+    uint64_t submitCalls {0};
+    uint64_t submittedRequests {0};
+    uint64_t droppedDatagrams {0};
+    uint64_t sendErrors {0};
+
+    // the mapped rings, provided buffers and send slots
+    struct Ring;
+    std::unique_ptr<Ring> ring;
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -22,81 +22,145 @@
 
 #pragma once
 
-#include <list>
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
 #include "utils/time.h"
 
 namespace elastos {
 namespace carrier {
 
-template <typename Key, typename Value>
-class LocadingCache{
+/*
+ * Bounded cache of the values loaded on demand, safe to use from several
+ * threads. The entries are spread over lock-striped shards by key hash, each
+ * shard holds a fixed number of slots and evicts with the CLOCK algorithm
+ * once full. get() returns a shared reference, the value stays valid for the
+ * caller even if the entry is evicted meanwhile. The TTL is checked against
+ * a coarse clock advanced by handleExpiration(), the lookups never read the
+ * system time, so the expiration granularity is the interval it's called at.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LocadingCache {
 public:
-    LocadingCache(int _ttl) : ttl(_ttl) { }
-
-    Value& get(Key key) {
-        auto it = cache.find(key);
-        if (it == cache.end()) {
-            cache[key] = Entry(load(key), ttl);
-            it = cache.find(key);
-        }
-        else {
-            it->second.setExpirationTime(ttl);
-        }
-        return it->second.value;
-    };
-
-    void handleExpiration() {
-        auto now = currentTimeMillis();
-        auto it = cache.begin();
-        while (it != cache.end()) {
-            auto entry = (*it).second;
-            auto cur_it = it++;
-            if (entry.expired(now)) {
-                onRemoval(entry.value);
-                cache.erase(cur_it);
+    static const size_t SHARDS = 16;
+
+    LocadingCache(int _ttl, size_t capacity = 4096) : ttl(_ttl) {
+        size_t perShard = std::max<size_t>(1, (capacity + SHARDS - 1) / SHARDS);
+        for (auto& shard : shards)
+            shard.slots.resize(perShard);
+        now.store(currentTimeMillis(), std::memory_order_relaxed);
+    }
+
+    virtual ~LocadingCache() = default;
+
+    std::shared_ptr<const Value> get(const Key& key) {
+        auto& shard = shards[Hash{}(key) % SHARDS];
+        {
+            std::lock_guard<std::mutex> lk(shard.lock);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                auto& slot = shard.slots[it->second];
+                slot.referenced = true;
+                slot.lastAccess = now.load(std::memory_order_relaxed);
+                return slot.value;
             }
         }
-    };
 
-private:
-    struct Entry {
-        Entry() {};
-        ~Entry()=default;
+        // load outside the lock, the other keys in the shard don't wait for it
+        auto value = std::make_shared<const Value>(load(key));
+
+        std::lock_guard<std::mutex> lk(shard.lock);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+            return shard.slots[it->second].value;   // loaded by another thread meanwhile
 
-        Entry(const Entry& e) : value(e.value), expiration_time(e.expiration_time) {}
-        Entry(Entry&& e) : value(e.value), expiration_time(e.expiration_time) {}
+        auto& slot = shard.slots[victim(shard)];
+        slot.key = key;
+        slot.value = value;
+        slot.referenced = false;
+        slot.lastAccess = now.load(std::memory_order_relaxed);
+        shard.index.emplace(key, &slot - shard.slots.data());
+        return value;
+    }
 
-        Entry& operator=(const Entry& o) noexcept {
-            value = o.value;
-            expiration_time = o.expiration_time;
-            return *this;
+    void handleExpiration() {
+        auto current = currentTimeMillis();
+        now.store(current, std::memory_order_relaxed);
+
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lk(shard.lock);
+            for (auto& slot : shard.slots) {
+                if (slot.value && current >= slot.lastAccess + ttl)
+                    evict(shard, slot);
+            }
         }
+    }
 
-        Entry& operator=(Entry&& o) noexcept {
-            value = o.value;
-            expiration_time = o.expiration_time;
-            return *this;
+    size_t size() {
+        size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lk(shard.lock);
+            total += shard.index.size();
         }
+        return total;
+    }
 
-        Entry(Value&& _value, int valid): value(_value),
-                expiration_time(currentTimeMillis() + valid) {}
+    size_t capacity() const noexcept {
+        return shards[0].slots.size() * SHARDS;
+    }
 
-        bool expired(uint64_t now) const {
-            return now >= expiration_time;
-        }
+protected:
+    virtual Value load(const Key &key) = 0;
+    virtual void onRemoval(const Value &val) = 0;
 
-        void setExpirationTime(int valid) {
-            expiration_time = currentTimeMillis() + valid;
-        }
+private:
+    struct Slot {
+        Key key {};
+        std::shared_ptr<const Value> value {};
+        uint64_t lastAccess {0};
+        bool referenced {false};
+    };
 
-        Value value;
-        uint64_t expiration_time = 0;
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<Key, size_t, Hash> index {};
+        std::vector<Slot> slots {};
+        size_t hand {0};
     };
 
-    virtual Value load(const Key &key) = 0;
-    virtual void onRemoval(const Value &val) = 0;
+    // Picks a free slot, or sweeps the clock hand over the recently used ones
+    size_t victim(Shard& shard) {
+        while (true) {
+            auto& slot = shard.slots[shard.hand];
+            size_t i = shard.hand;
+            shard.hand = (shard.hand + 1) % shard.slots.size();
+
+            if (!slot.value)
+                return i;
+
+            if (slot.referenced) {
+                slot.referenced = false;
+                continue;
+            }
+
+            evict(shard, slot);
+            return i;
+        }
+    }
+
+    void evict(Shard& shard, Slot& slot) {
+        shard.index.erase(slot.key);
+        onRemoval(*slot.value);
+        slot.value.reset();
+        slot.referenced = false;
+    }
 
-    std::map<Key, Entry> cache {};
+    std::array<Shard, SHARDS> shards {};
+    std::atomic<uint64_t> now {0};
     int ttl;
 };
 
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "utils/log.h"
+#include "metrics.h"
+
+namespace elastos {
+namespace carrier {
+
+uint64_t Histogram::count() const noexcept {
+    uint64_t n = 0;
+    for (const auto& bucket : buckets)
+        n += bucket.load(std::memory_order_relaxed);
+    return n;
+}
+
+uint64_t Histogram::percentile(double p) const noexcept {
+    uint64_t counts[BUCKETS];
+    uint64_t n = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        n += counts[i];
+    }
+
+    if (n == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * n + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS - 1; i++) {
+        seen += counts[i];
+        if (seen >= rank)
+            return lowerBound(i + 1) - 1;
+    }
+
+    return lowerBound(BUCKETS - 1);
+}
+
+uint64_t Histogram::countBelow(uint64_t bound) const noexcept {
+    // the bound is expected on a bucket boundary, e.g. a power of two
+    int end = bound == 0 ? 0 : indexOf(bound - 1) + 1;
+    uint64_t n = 0;
+    for (int i = 0; i < end; i++)
+        n += buckets[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+void Histogram::reset() noexcept {
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+}
+
+namespace {
+
+enum class MetricType {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+struct Series {
+    std::string labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+};
+
+struct Family {
+    MetricType type;
+    std::string help;
+    std::map<std::string, Series> series;
+};
+
+struct Registry {
+    std::mutex lock;
+    std::map<std::string, Family> families;
+};
+
+// never destroyed, the metrics may still be updated while the process exits
+Registry& registry() {
+    static auto* instance = new Registry();
+    return *instance;
+}
+
+std::string formatLabels(const Metrics::Labels& labels) {
+    std::string str {};
+    for (const auto& [name, value] : labels) {
+        str.append(str.empty() ? "" : ",").append(name).append("=\"");
+        for (auto c : value) {
+            if (c == '\\' || c == '"')
+                str.append(1, '\\');
+            if (c == '\n')
+                str.append("\\n");
+            else
+                str.append(1, c);
+        }
+        str.append("\"");
+    }
+    return str;
+}
+
+Series& lookup(const std::string& name, const std::string& help, const Metrics::Labels& labels, MetricType type) {
+    auto& family = registry().families.try_emplace(name, Family {type, help, {}}).first->second;
+    if (family.type != type)
+        throw std::invalid_argument("Metric " + name + " already registered with another type");
+
+    auto key = formatLabels(labels);
+    auto& series = family.series[key];
+    series.labels = key;
+    return series;
+}
+
+void appendSample(fmt::memory_buffer& out, const std::string& name, const std::string& labels, double value) {
+    if (labels.empty())
+        fmt::format_to(std::back_inserter(out), "{} {}\n", name, value);
+    else
+        fmt::format_to(std::back_inserter(out), "{}{{{}}} {}\n", name, labels, value);
+}
+
+} // namespace
+
+Counter& Metrics::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    auto& series = lookup(name, help, labels, MetricType::COUNTER);
+    if (!series.counter)
+        series.counter = std::make_unique<Counter>();
+    return *series.counter;
+}
+
+Gauge& Metrics::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    auto& series = lookup(name, help, labels, MetricType::GAUGE);
+    if (!series.gauge)
+        series.gauge = std::make_unique<Gauge>();
+    return *series.gauge;
+}
+
+Histogram& Metrics::histogram(const std::string& name, const std::string& help, const Labels& labels, double scale) {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    auto& series = lookup(name, help, labels, MetricType::HISTOGRAM);
+    if (!series.histogram)
+        series.histogram = std::make_unique<Histogram>(scale);
+    return *series.histogram;
+}
+
+std::string Metrics::scrape() {
+    // the exported buckets end before every other power of two of the histogram unit
+    static const int EXPORTED_EXPONENTS = 27;
+
+    fmt::memory_buffer out;
+    std::lock_guard<std::mutex> guard(registry().lock);
+    for (const auto& [name, family] : registry().families) {
+        static const char* TYPES[] = { "counter", "gauge", "histogram" };
+        fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n",
+                name, family.help, name, TYPES[(int)family.type]);
+
+        for (const auto& [key, series] : family.series) {
+            switch (family.type) {
+            case MetricType::COUNTER:
+                appendSample(out, name, key, (double)series.counter->get());
+                break;
+
+            case MetricType::GAUGE:
+                appendSample(out, name, key, (double)series.gauge->get());
+                break;
+
+            case MetricType::HISTOGRAM: {
+                const auto& h = *series.histogram;
+                auto prefix = key.empty() ? std::string() : key + ",";
+                for (int exponent = 0; exponent < EXPORTED_EXPONENTS; exponent += 2) {
+                    // le is inclusive, the values below a power of two are at most one less
+                    uint64_t bound = 1ULL << exponent;
+                    fmt::format_to(std::back_inserter(out), "{}_bucket{{{}le=\"{}\"}} {}\n",
+                            name, prefix, (bound - 1) * h.getScale(), h.countBelow(bound));
+                }
+
+                auto count = h.count();
+                fmt::format_to(std::back_inserter(out), "{}_bucket{{{}le=\"+Inf\"}} {}\n", name, prefix, count);
+                appendSample(out, name + "_sum", key, h.sum() * h.getScale());
+                appendSample(out, name + "_count", key, (double)count);
+                break;
+            }
+            }
+        }
+    }
+
+    return fmt::to_string(out);
+}
+
+} // namespace carrier
+} // namespace elastos
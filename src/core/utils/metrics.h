@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace elastos {
+namespace carrier {
+
+class Counter {
+public:
+    void inc(uint64_t n = 1) noexcept {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const noexcept {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> value {0};
+};
+
+class Gauge {
+public:
+    void set(int64_t v) noexcept {
+        value.store(v, std::memory_order_relaxed);
+    }
+
+    void inc(int64_t n = 1) noexcept {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void dec(int64_t n = 1) noexcept {
+        value.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    int64_t get() const noexcept {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64_t> value {0};
+};
+
+/*
+ * Log-linear histogram in the HDR style: the values below 8 have their own
+ * buckets, every power of two above is split in 8 sub-buckets, so a value
+ * is known within 12.5%. Recording is a few relaxed atomic adds. The values
+ * are integers in the histogram's unit, the scale converts them to the base
+ * unit when exported, e.g. 1e-6 for microseconds to seconds.
+ */
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr int BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS;
+
+    explicit Histogram(double scale = 1.0) : scale(scale) {}
+
+    void record(uint64_t value) noexcept {
+        buckets[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    double getScale() const noexcept {
+        return scale;
+    }
+
+    uint64_t count() const noexcept;
+
+    uint64_t sum() const noexcept {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    // The value at the given percentile (0 - 100), the upper bound of its bucket
+    uint64_t percentile(double p) const noexcept;
+
+    // Number of the recorded values less than the bound
+    uint64_t countBelow(uint64_t bound) const noexcept;
+
+    void reset() noexcept;
+
+    static int indexOf(uint64_t value) noexcept {
+        if (value < SUB_BUCKETS)
+            return (int)value;
+
+        int exponent = highestBit(value);
+        if (exponent > MAX_EXPONENT)
+            return BUCKETS - 1;
+
+        int sub = (int)(value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    // The smallest value of the bucket
+    static uint64_t lowerBound(int index) noexcept {
+        if (index < SUB_BUCKETS)
+            return index;
+
+        int exponent = index / SUB_BUCKETS + SUB_BITS - 1;
+        uint64_t sub = index % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << (exponent - SUB_BITS);
+    }
+
+private:
+    static int highestBit(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1)
+            bit++;
+        return bit;
+#endif
+    }
+
+    const double scale;
+    std::atomic<uint64_t> buckets[BUCKETS] {};
+    std::atomic<uint64_t> total {0};
+};
+
+// Records the time elapsed in the scope in microseconds
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram) noexcept
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+/*
+ * The process wide metrics registry, exported in the Prometheus text format.
+ * Like the loggers the metrics are looked up by name, the lookup takes a
+ * lock: resolve them once and keep the reference, it stays valid for the
+ * life of the process. The same name and labels always give the same metric.
+ */
+class Metrics {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    static Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    static Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    static Histogram& histogram(const std::string& name, const std::string& help,
+            const Labels& labels = {}, double scale = 1.0);
+
+    // All the metrics in the Prometheus text exposition format
+    static std::string scrape();
+};
+
+} // namespace carrier
+} // namespace elastos
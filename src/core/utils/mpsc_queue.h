@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Bounded lock-free queue for many producer threads and a single consumer,
+ * a ring of cells each tagged with the sequence number of the position it
+ * holds (D. Vyukov's bounded queue). The producers claim a position with a
+ * CAS and publish the cell by bumping its sequence, the consumer never
+ * contends with them. The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+    explicit MPSCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        cells = std::make_unique<Cell[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /*
+     * Returns the number of queued elements including the new one, or 0 if
+     * the queue is full. A producer seeing 1 knows the consumer has drained
+     * the queue and may be about to sleep, it may also be a false alarm.
+     */
+    size_t push(T value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return 0;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_seq_cst);
+
+        // the consumer may have taken it already, count it anyway
+        intptr_t queued = (intptr_t)(pos + 1 - head.load(std::memory_order_seq_cst));
+        return queued > 0 ? (size_t)queued : 1;
+    }
+
+    // Only called from the consumer thread
+    bool pop(T& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        auto& cell = cells[pos & mask];
+        if (cell.sequence.load(std::memory_order_seq_cst) != pos + 1)
+            return false;
+
+        value = std::move(cell.value);
+        cell.value = T {};
+        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Approximate while the producers are pushing
+    size_t size() const noexcept {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    size_t capacity() const noexcept {
+        return mask + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence {0};
+        T value {};
+    };
+
+    std::unique_ptr<Cell[]> cells {};
+    size_t mask {0};
+
+    // the producers and the consumer touch different cache lines
+    alignas(64) std::atomic<size_t> tail {0};
+    alignas(64) std::atomic<size_t> head {0};
+};
+
+} // namespace carrier
+} // namespace elastos
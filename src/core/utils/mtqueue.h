@@ -24,6 +24,7 @@
 
 #include <list>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <memory>
@@ -70,10 +71,21 @@ public:
     MTQueue(std::initializer_list<value_type> list)
         : MTQueue(list.begin(), list.end()) {}
 
-    void push(const value_type &new_value) {
+    /*
+     * Returns the number of queued elements including the new one.
+     * */
+    size_t push(const value_type &new_value) {
         std::lock_guard<std::mutex> lk(mut);
         data_queue.push(std::move(new_value));
         data_cond.notify_one();
+        return data_queue.size();
+    }
+
+    size_t push(value_type &&new_value) {
+        std::lock_guard<std::mutex> lk(mut);
+        data_queue.push(std::move(new_value));
+        data_cond.notify_one();
+        return data_queue.size();
     }
 
     void add(const value_type &new_value) {
@@ -93,6 +105,19 @@ public:
         return pop();
     }
 
+    /*
+     * Wait up to timeout for an element, returns false if the queue stays empty.
+     * */
+    bool pop(value_type& value, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lk(mut);
+        if (!data_cond.wait_for(lk, timeout, [this] { return !data_queue.empty(); }))
+            return false;
+
+        value = std::move(data_queue.front());
+        data_queue.pop();
+        return true;
+    }
+
     value_type peek() const {
         std::lock_guard<std::mutex> lk(mut);
         if (data_queue.empty())
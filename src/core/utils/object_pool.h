@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+#include "constants.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * A free list of heap blocks of one size. The blocks are plain
+ * ::operator new allocations, so a block may go back to the heap or come
+ * from it whenever the list is empty, full or the pooling is disabled.
+ */
+class BlockPool {
+public:
+    BlockPool(size_t blockSize, size_t maxBlocks) noexcept
+        : blockSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize), maxBlocks(maxBlocks) {}
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    void* allocate() {
+        if (isEnabled()) {
+            std::lock_guard<std::mutex> lk(lock);
+            if (head != nullptr) {
+                auto block = head;
+                head = block->next;
+                count--;
+                return block;
+            }
+        }
+
+        return ::operator new(blockSize);
+    }
+
+    void deallocate(void* block) noexcept {
+        if (isEnabled()) {
+            std::lock_guard<std::mutex> lk(lock);
+            if (count < maxBlocks) {
+                head = new (block) FreeBlock {head};
+                count++;
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(lock);
+        return count;
+    }
+
+    // Process wide switch, the benchmarks compare the pooled and the heap allocations
+    static void setEnabled(bool enabled) noexcept {
+        BlockPool::enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    static bool isEnabled() noexcept {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t blockSize;
+    size_t maxBlocks;
+
+    mutable std::mutex lock;
+    FreeBlock* head {nullptr};
+    size_t count {0};
+
+    static inline std::atomic<bool> enabled {true};
+};
+
+/*
+ * Allocator over one BlockPool per allocated type, meant for
+ * std::allocate_shared: the object and its control block come from the
+ * pool of the rebound type. The pools are never destroyed, the pooled
+ * objects may outlive the static objects.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n != 1)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        return static_cast<T*>(pool().allocate());
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1)
+            ::operator delete(p);
+        else
+            pool().deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept {
+        return false;
+    }
+
+private:
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not pooled");
+
+    static BlockPool& pool() {
+        static auto* pool = new BlockPool(sizeof(T), Constants::RPC_OBJECT_POOL_SIZE);
+        return *pool;
+    }
+};
+
+/*
+ * The shared objects that usually live as long as a packet is handled:
+ * the parsed messages, the nodes they carry and the responses to them.
+ * Whoever keeps one longer just keeps its block, the tasks copy the nodes
+ * they retain anyway.
+ */
+template <typename T, typename... Args>
+inline std::shared_ptr<T> makePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace carrier
+} // namespace elastos
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Fixed size ring of trivially copyable records, the oldest records are
+ * overwritten. Any thread appends a record with a fetch_add and a few
+ * relaxed stores. Each slot is guarded by a sequence number, the snapshot
+ * skips the slots a writer is in the middle of. The capacity is rounded up
+ * to a power of two.
+ */
+template <typename T>
+class RecordRing {
+    static_assert(std::is_trivially_copyable_v<T>, "Records must be trivially copyable");
+
+public:
+    explicit RecordRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        slots = std::make_unique<Slot[]>(size);
+        mask = size - 1;
+    }
+
+    RecordRing(const RecordRing&) = delete;
+    RecordRing& operator=(const RecordRing&) = delete;
+
+    size_t capacity() const noexcept {
+        return mask + 1;
+    }
+
+    // Total records appended since created, including the overwritten ones
+    uint64_t recorded() const noexcept {
+        return head.load(std::memory_order_relaxed);
+    }
+
+    void push(const T& record) noexcept {
+        uint64_t words[WORDS] {};
+        std::memcpy(words, &record, sizeof(T));
+
+        uint64_t position = head.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = slots[position & mask];
+        // odd while written, a reader racing with the writer sees the mismatch
+        slot.sequence.store(position * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        slot.sequence.store(position * 2 + 2, std::memory_order_release);
+    }
+
+    // Copies the consistent records, oldest first
+    std::vector<T> snapshot() const {
+        std::vector<T> records {};
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity() ? end - capacity() : 0;
+        records.reserve(end - begin);
+
+        for (uint64_t position = begin; position < end; position++) {
+            const auto& slot = slots[position & mask];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != position * 2 + 2)
+                continue;
+
+            uint64_t words[WORDS];
+            for (size_t i = 0; i < WORDS; i++)
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            T record;
+            std::memcpy(&record, words, sizeof(T));
+            records.push_back(record);
+        }
+
+        return records;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> sequence {0};
+        std::atomic<uint64_t> words[WORDS] {};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> head {0};
+};
+
+} // namespace carrier
+} // namespace elastos
@@ -24,16 +24,63 @@
 
 #include <cstdlib>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
 
 namespace elastos {
 namespace carrier {
 
-inline uint64_t currentTimeMillis() {
+inline uint64_t systemTimeMillis() {
     auto now = std::chrono::system_clock::now();
     auto ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
     auto value = ms.time_since_epoch();
     return value.count();
 }
 
+/*
+ * A clock moved by hand. While one is alive, currentTimeMillis() returns its
+ * time instead of the system time for all the nodes of the process, e.g. the
+ * SimulatedNetwork moves it from one event to the next.
+ */
+class VirtualClock {
+public:
+    explicit VirtualClock(uint64_t start = systemTimeMillis()) noexcept : time(start) {
+        current.store(this, std::memory_order_release);
+    }
+
+    ~VirtualClock() {
+        VirtualClock* self = this;
+        current.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    }
+
+    VirtualClock(const VirtualClock&) = delete;
+    VirtualClock& operator=(const VirtualClock&) = delete;
+
+    uint64_t now() const noexcept {
+        return time.load(std::memory_order_relaxed);
+    }
+
+    void set(uint64_t now) noexcept {
+        time.store(now, std::memory_order_relaxed);
+    }
+
+    void advance(uint64_t millis) noexcept {
+        time.fetch_add(millis, std::memory_order_relaxed);
+    }
+
+    static const VirtualClock* installed() noexcept {
+        return current.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<uint64_t> time;
+    static inline std::atomic<VirtualClock*> current {nullptr};
+};
+
+inline uint64_t currentTimeMillis() {
+    auto clock = VirtualClock::installed();
+    return clock != nullptr ? clock->now() : systemTimeMillis();
+}
+
 } // namespace carrier
 } // namespace elastos
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+
+#include "record_ring.h"
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Ring of binary packet records for the post-mortem analysis, the oldest
+ * records are overwritten. Any thread appends a record without a lock and
+ * nothing gets formatted until the records are dumped.
+ */
+class TraceRing {
+public:
+    enum class Direction : uint8_t {
+        SENT = 0,
+        RECEIVED = 1
+    };
+
+    struct Record {
+        uint64_t timestamp;     // microseconds since the epoch
+        int32_t txid;
+        uint16_t size;          // datagram size, saturated
+        uint16_t port;
+        Direction direction;
+        uint8_t type;           // message type and method bits
+        uint8_t family;
+        uint8_t addressLength;
+        uint8_t address[16];
+    };
+
+    explicit TraceRing(size_t capacity) : ring(capacity) {}
+
+    size_t capacity() const noexcept {
+        return ring.capacity();
+    }
+
+    // Total records appended since created, including the overwritten ones
+    uint64_t recorded() const noexcept {
+        return ring.recorded();
+    }
+
+    void record(Direction direction, uint8_t type, int32_t txid, size_t size,
+            uint8_t family, const uint8_t* address, size_t addressLength, uint16_t port) noexcept {
+        Record r {};
+        r.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        r.txid = txid;
+        r.size = size > UINT16_MAX ? UINT16_MAX : (uint16_t)size;
+        r.port = port;
+        r.direction = direction;
+        r.type = type;
+        r.family = family;
+        r.addressLength = addressLength > sizeof(r.address) ? sizeof(r.address) : (uint8_t)addressLength;
+        if (address != nullptr)
+            std::memcpy(r.address, address, r.addressLength);
+
+        ring.push(r);
+    }
+
+    // Copies the consistent records, oldest first
+    std::vector<Record> snapshot() const {
+        return ring.snapshot();
+    }
+
+private:
+    RecordRing<Record> ring;
+};
+
+} // namespace carrier
+} // namespace elastos
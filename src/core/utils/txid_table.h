@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <cstdint>
+
+namespace elastos {
+namespace carrier {
+
+/*
+ * Flat open-addressing table of the in-flight calls keyed by transaction id.
+ * The table picks the txid itself: the low bits are the index of a free
+ * slot, the high bits the generation of that slot, bumped every time the
+ * slot is reused. Every entry sits in its home slot, so lookups are a single
+ * probe, removals don't need tombstones, and a late response or timeout for
+ * a reused slot can't match the new entry. The table doubles when half
+ * full. Only the thread running the RPC server touches it, size() can be
+ * read from any thread.
+ */
+template <typename T>
+class TxidTable {
+public:
+    explicit TxidTable(size_t capacity = 64, uint32_t generation = 0) {
+        bits = MIN_BITS;
+        while ((size_t(1) << bits) < capacity && bits < MAX_BITS)
+            bits++;
+
+        slots.resize(size_t(1) << bits);
+        for (auto& slot : slots)
+            slot.generation = generation;
+    }
+
+    TxidTable(const TxidTable&) = delete;
+    TxidTable& operator=(const TxidTable&) = delete;
+
+    /*
+     * Stores the value in a free slot and returns its txid, a positive
+     * non-zero integer.
+     */
+    int insert(T value) {
+        if (count.load(std::memory_order_relaxed) * 2 >= slots.size() && bits < MAX_BITS)
+            grow();
+        if (count.load(std::memory_order_relaxed) == slots.size())
+            throw std::runtime_error("Too many transactions in flight");
+
+        size_t mask = slots.size() - 1;
+        while (slots[cursor].txid != 0)
+            cursor = (cursor + 1) & mask;
+
+        auto& slot = slots[cursor];
+        int txid;
+        do {
+            slot.generation = (slot.generation + 1) & ((uint32_t(1) << (31 - bits)) - 1);
+            txid = static_cast<int>((slot.generation << bits) | cursor);
+        } while (txid == 0);
+
+        slot.txid = txid;
+        slot.value = std::move(value);
+        count.fetch_add(1, std::memory_order_relaxed);
+        cursor = (cursor + 1) & mask;
+        return txid;
+    }
+
+    T* find(int txid) noexcept {
+        if (txid <= 0)
+            return nullptr;
+
+        auto& slot = slots[txid & (slots.size() - 1)];
+        return slot.txid == txid ? &slot.value : nullptr;
+    }
+
+    bool remove(int txid) noexcept {
+        if (txid <= 0)
+            return false;
+
+        auto& slot = slots[txid & (slots.size() - 1)];
+        if (slot.txid != txid)
+            return false;
+
+        slot.txid = 0;
+        slot.value = T {};
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t size() const noexcept {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const noexcept {
+        return slots.size();
+    }
+
+    void clear() {
+        for (auto& slot : slots) {
+            slot.txid = 0;
+            slot.value = T {};
+        }
+        count.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static const int MIN_BITS = 4;
+    static const int MAX_BITS = 20;     // keeps 11 generation bits
+
+    struct Slot {
+        int txid {0};
+        uint32_t generation {0};
+        T value {};
+    };
+
+    /*
+     * The live entries keep their txids, their low bits are distinct so they
+     * don't collide in the larger table. The generations continue from where
+     * the old slots were, the new txids still differ from the recent ones.
+     */
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        bits++;
+
+        size_t mask = slots.size() - 1;
+        for (size_t i = 0; i < old.size(); i++) {
+            uint32_t generation = (old[i].generation >> 1) + 1;
+            slots[i].generation = generation;
+            slots[i + old.size()].generation = generation;
+        }
+
+        for (auto& slot : old) {
+            if (slot.txid == 0)
+                continue;
+
+            auto& to = slots[slot.txid & mask];
+            to.txid = slot.txid;
+            to.value = std::move(slot.value);
+        }
+
+        cursor = old.size();
+    }
+
+    std::vector<Slot> slots {};
+    int bits {MIN_BITS};
+    size_t cursor {0};
+    std::atomic<size_t> count {0};
+};
+
+} // namespace carrier
+} // namespace elastos
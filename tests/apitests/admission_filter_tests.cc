@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include "carrier/id.h"
+#include "carrier/socket_address.h"
+#include "admission_filter.h"
+#include "admission_filter_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(AdmissionFilterTests);
+
+using Verdict = AdmissionFilter::Verdict;
+
+// the filter only needs a non-zero clock
+static const uint64_t START = 1000000;
+
+void AdmissionFilterTests::setUp() {
+}
+
+void AdmissionFilterTests::testSourceLimit() {
+    AdmissionFilter::Limits limits;
+    limits.sourceRate = 10;
+    limits.senderRate = 0;
+    limits.newSenderRate = 0;
+    AdmissionFilter filter(limits);
+
+    SocketAddress source("192.168.1.10", 39001);
+    auto sender = Id::random();
+
+    // the burst, then nothing until the bucket refills
+    int burst = limits.sourceRate * AdmissionFilter::BURST_SECONDS;
+    for (int i = 0; i < burst; i++)
+        CPPUNIT_ASSERT(filter.admit(sender, source, START) == Verdict::ACCEPTED);
+    CPPUNIT_ASSERT(filter.admit(sender, source, START) == Verdict::SOURCE_LIMITED);
+
+    // another port is another source
+    SocketAddress other("192.168.1.10", 39002);
+    CPPUNIT_ASSERT(filter.admit(sender, other, START) == Verdict::ACCEPTED);
+
+    // 10 packets/s, one token every 100ms
+    CPPUNIT_ASSERT(filter.admit(sender, source, START + 50) == Verdict::SOURCE_LIMITED);
+    CPPUNIT_ASSERT(filter.admit(sender, source, START + 150) == Verdict::ACCEPTED);
+    CPPUNIT_ASSERT(filter.admit(sender, source, START + 150) == Verdict::SOURCE_LIMITED);
+
+    auto stats = filter.getStats();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)burst + 2, stats.accepted);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)3, stats.sourceLimited);
+}
+
+void AdmissionFilterTests::testSenderLimit() {
+    AdmissionFilter::Limits limits;
+    limits.sourceRate = 0;
+    limits.senderRate = 5;
+    limits.newSenderRate = 0;
+    AdmissionFilter filter(limits);
+
+    // the same id from the rotating ports
+    auto sender = Id::random();
+    int burst = limits.senderRate * AdmissionFilter::BURST_SECONDS;
+    for (int i = 0; i < burst; i++) {
+        SocketAddress source("10.0.0.1", 40000 + i);
+        CPPUNIT_ASSERT(filter.admit(sender, source, START) == Verdict::ACCEPTED);
+    }
+
+    SocketAddress source("10.0.0.1", 50000);
+    CPPUNIT_ASSERT(filter.admit(sender, source, START) == Verdict::SENDER_LIMITED);
+    CPPUNIT_ASSERT(filter.admit(Id::random(), source, START) == Verdict::ACCEPTED);
+}
+
+void AdmissionFilterTests::testNewSenderLimit() {
+    AdmissionFilter::Limits limits;
+    limits.sourceRate = 0;
+    limits.senderRate = 1000;
+    limits.newSenderRate = 20;
+    AdmissionFilter filter(limits);
+
+    SocketAddress source("10.0.0.2", 39001);
+    auto known = Id::random();
+    CPPUNIT_ASSERT(filter.admit(known, source, START) == Verdict::ACCEPTED);
+
+    // the sybil ids, each one costs a key derivation
+    int admitted = 0;
+    for (int i = 0; i < 1000; i++) {
+        if (filter.admit(Id::random(), source, START) == Verdict::ACCEPTED)
+            admitted++;
+    }
+    CPPUNIT_ASSERT_EQUAL(limits.newSenderRate * AdmissionFilter::BURST_SECONDS - 1, admitted);
+
+    // the senders seen before don't need a derivation
+    CPPUNIT_ASSERT(filter.admit(known, source, START) == Verdict::ACCEPTED);
+    CPPUNIT_ASSERT(filter.admit(Id::random(), source, START) == Verdict::KEY_LIMITED);
+    CPPUNIT_ASSERT(filter.admit(Id::random(), source, START + 100) == Verdict::ACCEPTED);
+
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000 - admitted + 1, filter.getStats().keyLimited);
+}
+
+void AdmissionFilterTests::testBlocklist() {
+    AdmissionFilter::Limits limits;
+    limits.blocklistFailures = 4;
+    limits.blocklistDuration = 1000;
+    AdmissionFilter filter(limits);
+
+    SocketAddress attacker("10.0.0.3", 39001);
+    SocketAddress honest("10.0.0.4", 39001);
+    auto sender = Id::random();
+
+    for (int i = 0; i < limits.blocklistFailures - 1; i++)
+        filter.failure(attacker, START);
+    CPPUNIT_ASSERT(!filter.isBlocked(attacker, START));
+    CPPUNIT_ASSERT(filter.admit(sender, attacker, START) == Verdict::ACCEPTED);
+
+    filter.failure(attacker, START);
+    CPPUNIT_ASSERT(filter.isBlocked(attacker, START));
+    CPPUNIT_ASSERT(filter.admit(sender, attacker, START) == Verdict::BLOCKED);
+    CPPUNIT_ASSERT(filter.admit(sender, honest, START) == Verdict::ACCEPTED);
+
+    // the block expires
+    CPPUNIT_ASSERT(filter.admit(sender, attacker, START + limits.blocklistDuration) == Verdict::ACCEPTED);
+
+    // the failures outside of the window don't add up
+    for (int i = 0; i < limits.blocklistFailures * 2; i++)
+        filter.failure(honest, START + i * AdmissionFilter::FAILURE_WINDOW);
+    CPPUNIT_ASSERT(!filter.isBlocked(honest, START + limits.blocklistFailures * 2 * AdmissionFilter::FAILURE_WINDOW));
+
+    auto stats = filter.getStats();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, stats.blocklisted);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, stats.blocked);
+
+    filter.clear();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, filter.getStats().accepted);
+}
+
+void AdmissionFilterTests::testSpoofedFailures() {
+    AdmissionFilter::Limits limits;
+    limits.blocklistFailures = 4;
+    limits.blocklistDuration = 1000;
+    AdmissionFilter filter(limits);
+
+    SocketAddress peer("10.0.0.5", 39001);
+    auto sender = Id::random();
+
+    // the peer talks, meanwhile forged garbage arrives "from" its address
+    uint64_t now = START;
+    for (int i = 0; i < limits.blocklistFailures * 4; i++, now += 10) {
+        CPPUNIT_ASSERT(filter.admit(sender, peer, now) == Verdict::ACCEPTED);
+        filter.success(peer, now);
+
+        filter.failure(peer, now + 1);
+        filter.failure(peer, now + 2);
+    }
+
+    CPPUNIT_ASSERT(!filter.isBlocked(peer, now));
+    CPPUNIT_ASSERT(filter.admit(sender, peer, now) == Verdict::ACCEPTED);
+
+    auto stats = filter.getStats();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, stats.blocklisted);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, stats.blocked);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)limits.blocklistFailures * 8, stats.spared);
+
+    // once the peer has been quiet for long, the failures count again
+    now += AdmissionFilter::AUTHENTICATED_WINDOW;
+    for (int i = 0; i < limits.blocklistFailures; i++)
+        filter.failure(peer, now);
+    CPPUNIT_ASSERT(filter.isBlocked(peer, now));
+}
+
+void AdmissionFilterTests::tearDown() {
+}
+
+}  // namespace test
@@ -147,6 +147,35 @@ void CryptoTester::testSignatrue()
     CPPUNIT_ASSERT(signature.verify(multisign, keyPair.publicKey()) == false);
 }
 
+void CryptoTester::testBatchVerify()
+{
+    auto keyPair1 = Signature::KeyPair();
+    auto keyPair2 = Signature::KeyPair();
+
+    std::vector<uint8_t> data1 = { 0x01, 0x02, 0x03 };
+    std::vector<uint8_t> data2 = { 0x04, 0x05 };
+    auto sig1 = keyPair1.privateKey().sign(data1);
+    auto sig2 = keyPair1.privateKey().sign(data2);
+
+    Signature::BatchVerifier batch;
+    batch.add(data1, sig1, keyPair1.publicKey());
+    batch.add(data2, sig2, keyPair1.publicKey());
+    batch.add(data1, sig1, keyPair1.publicKey());               // repeated
+    CPPUNIT_ASSERT(batch.verify());
+    CPPUNIT_ASSERT(batch.getFailures().empty());
+
+    batch.add(data2, sig1, keyPair1.publicKey());               // wrong data
+    batch.add(data1, sig1, keyPair2.publicKey());               // wrong key
+    batch.add(data1, Blob(sig1.data(), 32), keyPair1.publicKey()); // truncated
+    batch.add(data2, sig1, keyPair1.publicKey());               // repeated failure
+    CPPUNIT_ASSERT(!batch.verify());
+    CPPUNIT_ASSERT(batch.getFailures() == std::vector<size_t>({3, 4, 5, 6}));
+
+    batch.clear();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, batch.size());
+    CPPUNIT_ASSERT(batch.verify());
+}
+
 void CryptoTester::testPublicKey()
 {
     auto keyPair = Signature::KeyPair();
@@ -31,6 +31,7 @@ class CryptoTester : public CppUnit::TestFixture {
     CPPUNIT_TEST_SUITE(CryptoTester);
     CPPUNIT_TEST(testEncryption);
     CPPUNIT_TEST(testSignatrue);
+    CPPUNIT_TEST(testBatchVerify);
     CPPUNIT_TEST(testPublicKey);
     CPPUNIT_TEST(testCrytoContext);
     CPPUNIT_TEST_SUITE_END();
@@ -41,6 +42,7 @@ class CryptoTester : public CppUnit::TestFixture {
 
     void testEncryption();
     void testSignatrue();
+    void testBatchVerify();
     void testPublicKey();
     void testCrytoContext();
 };
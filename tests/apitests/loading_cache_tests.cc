@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include "utils/loading_cache.h"
+#include "loading_cache_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(LoadingCacheTests);
+
+class CountingCache : public LocadingCache<int, int> {
+public:
+    CountingCache(int ttl, size_t capacity) : LocadingCache(ttl, capacity) {}
+
+    std::atomic<int> loads {0};
+    std::atomic<int> removals {0};
+
+private:
+    int load(const int& key) override {
+        loads++;
+        return key * 10;
+    }
+
+    void onRemoval(const int& val) override {
+        removals++;
+    }
+};
+
+void LoadingCacheTests::setUp() {
+}
+
+void LoadingCacheTests::testLoad() {
+    CountingCache cache(60000, 64);
+
+    CPPUNIT_ASSERT_EQUAL(10, *cache.get(1));
+    CPPUNIT_ASSERT_EQUAL(20, *cache.get(2));
+    CPPUNIT_ASSERT_EQUAL(10, *cache.get(1));
+    CPPUNIT_ASSERT_EQUAL(2, cache.loads.load());
+    CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+}
+
+void LoadingCacheTests::testEviction() {
+    CountingCache cache(60000, 64);
+    size_t capacity = cache.capacity();
+
+    // keep a reference, it must survive the eviction of its entry
+    auto pinned = cache.get(0);
+    for (int i = 1; i < 1000; i++)
+        cache.get(i);
+
+    CPPUNIT_ASSERT(cache.size() <= capacity);
+    CPPUNIT_ASSERT_EQUAL(1000 - (int)cache.size(), cache.removals.load());
+    CPPUNIT_ASSERT_EQUAL(0, *pinned);
+}
+
+void LoadingCacheTests::testExpiration() {
+    CountingCache cache(0, 64);
+
+    cache.get(1);
+    cache.get(2);
+    cache.handleExpiration();
+    CPPUNIT_ASSERT_EQUAL((size_t)0, cache.size());
+    CPPUNIT_ASSERT_EQUAL(2, cache.removals.load());
+
+    CPPUNIT_ASSERT_EQUAL(10, *cache.get(1));
+    CPPUNIT_ASSERT_EQUAL(3, cache.loads.load());
+}
+
+void LoadingCacheTests::testConcurrentGet() {
+    CountingCache cache(60000, 256);
+
+    std::vector<std::thread> threads {};
+    std::atomic<int> errors {0};
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 20000; i++) {
+                int key = (i * 7 + t) % 512;
+                if (*cache.get(key) != key * 10)
+                    errors++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    CPPUNIT_ASSERT_EQUAL(0, errors.load());
+    CPPUNIT_ASSERT(cache.size() <= cache.capacity());
+    // a thread losing the race to load a key drops its own copy
+    CPPUNIT_ASSERT(cache.removals.load() <= cache.loads.load() - (int)cache.size());
+}
+
+void LoadingCacheTests::tearDown() {
+}
+
+}  // namespace test
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <random>
+#include <limits>
+
+#include "carrier/node_info.h"
+#include "carrier/peer_info.h"
+#include "carrier/value.h"
+#include "utils/cbor.h"
+#include "messages/message.h"
+#include "messages/ping_request.h"
+#include "messages/ping_response.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+#include "messages/find_value_request.h"
+#include "messages/find_value_response.h"
+#include "messages/store_value_request.h"
+#include "messages/store_value_response.h"
+#include "messages/find_peer_request.h"
+#include "messages/find_peer_response.h"
+#include "messages/announce_peer_request.h"
+#include "messages/announce_peer_response.h"
+#include "messages/error_message.h"
+
+#include "utils.h"
+#include "cbor_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(CborTests);
+
+static std::vector<uint8_t> randomBytes(std::mt19937& rng, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (auto& b : bytes)
+        b = (uint8_t)rng();
+    return bytes;
+}
+
+static std::list<Sp<NodeInfo>> randomNodes(std::mt19937& rng, bool ipv6) {
+    std::list<Sp<NodeInfo>> nodes {};
+    int count = rng() % 9;
+    for (int i = 0; i < count; i++)
+        nodes.push_back(std::make_shared<NodeInfo>(Id::random(), randomBytes(rng, ipv6 ? 16 : 4), rng() % 65536));
+    return nodes;
+}
+
+static Value randomValue(std::mt19937& rng) {
+    auto data = randomBytes(rng, 1 + rng() % 1200);
+    if (rng() % 2)
+        return Value::of({}, {}, {}, {}, 0, {}, data);
+
+    auto pk = Id::random();
+    auto recipient = Id::random();
+    auto nonce = randomBytes(rng, 24);
+    auto sig = randomBytes(rng, 64);
+    return Value::of(pk.blob(), {}, (rng() % 2) ? recipient.blob() : Blob(), nonce, rng() % 100000, sig, data);
+}
+
+static PeerInfo randomPeer(std::mt19937& rng, const Id& peerId) {
+    auto nodeId = Id::random();
+    auto origin = (rng() % 2) ? Id::random() : nodeId;
+    auto alt = (rng() % 2) ? std::string("https://peer.example.com:") + std::to_string(rng() % 65536) : std::string();
+    auto sig = randomBytes(rng, 64);
+    return PeerInfo::of(peerId.blob(), {}, nodeId.blob(), origin.blob(), rng() % 65536, alt, sig);
+}
+
+// One message of every type with random fields, the values of every size class included
+static std::list<Sp<Message>> randomMessages(std::mt19937& rng) {
+    std::list<Sp<Message>> messages {};
+    auto txid = [&]() { return (int)rng(); };
+
+    messages.push_back(std::make_shared<PingRequest>());
+    messages.push_back(std::make_shared<PingResponse>(txid()));
+
+    auto findNode = std::make_shared<FindNodeRequest>(Id::random(), rng() % 2);
+    findNode->setWant4(rng() % 2);
+    findNode->setWant6(rng() % 2);
+    messages.push_back(findNode);
+
+    auto findNodeResponse = std::make_shared<FindNodeResponse>(txid());
+    findNodeResponse->setNodes4(randomNodes(rng, false));
+    findNodeResponse->setNodes6(randomNodes(rng, true));
+    findNodeResponse->setToken((rng() % 2) ? txid() : 0);
+    messages.push_back(findNodeResponse);
+
+    auto findValue = std::make_shared<FindValueRequest>(Id::random());
+    findValue->setWant4(rng() % 2);
+    findValue->setWant6(rng() % 2);
+    findValue->setSequenceNumber((rng() % 2) ? rng() % 100000 : -1);
+    messages.push_back(findValue);
+
+    auto findValueResponse = std::make_shared<FindValueResponse>(txid());
+    findValueResponse->setNodes4(randomNodes(rng, false));
+    findValueResponse->setNodes6(randomNodes(rng, true));
+    if (rng() % 2)
+        findValueResponse->setValue(randomValue(rng));
+    messages.push_back(findValueResponse);
+
+    auto storeValue = std::make_shared<StoreValueRequest>(randomValue(rng), txid());
+    if (rng() % 2)
+        storeValue->setExpectedSequenceNumber(rng() % 100000);
+    messages.push_back(storeValue);
+    messages.push_back(std::make_shared<StoreValueResponse>(txid()));
+
+    auto findPeer = std::make_shared<FindPeerRequest>(Id::random());
+    findPeer->setWant4(rng() % 2);
+    findPeer->setWant6(rng() % 2);
+    messages.push_back(findPeer);
+
+    auto findPeerResponse = std::make_shared<FindPeerResponse>(txid());
+    findPeerResponse->setNodes4(randomNodes(rng, false));
+    findPeerResponse->setNodes6(randomNodes(rng, true));
+    std::list<PeerInfo> peers {};
+    auto peerId = Id::random();
+    int count = rng() % 5;
+    for (int i = 0; i < count; i++)
+        peers.push_back(randomPeer(rng, peerId));
+    findPeerResponse->setPeers(peers);
+    messages.push_back(findPeerResponse);
+
+    messages.push_back(std::make_shared<AnnouncePeerRequest>(randomPeer(rng, Id::random()), txid()));
+    messages.push_back(std::make_shared<AnnouncePeerResponse>(txid()));
+
+    std::string reason(rng() % 300, 'E');
+    messages.push_back(std::make_shared<ErrorMessage>(Message::Method::FIND_VALUE, txid(), (int)rng(), reason));
+
+    for (auto& msg : messages) {
+        if (msg->getType() == Message::Type::REQUEST)
+            msg->setTxid(txid());
+        msg->setVersion((rng() % 2) ? (int)rng() : 0);
+    }
+    return messages;
+}
+
+// Re-encodes the JSON with the indefinite length maps and arrays, like the streaming encoders do
+static void toIndefiniteCbor(const nlohmann::json& json, std::vector<uint8_t>& out) {
+    if (json.is_object()) {
+        out.push_back(0xbf);
+        for (const auto& [key, value] : json.items()) {
+            auto encodedKey = nlohmann::json::to_cbor(key);
+            out.insert(out.end(), encodedKey.begin(), encodedKey.end());
+            toIndefiniteCbor(value, out);
+        }
+        out.push_back(CborWriter::BREAK);
+    } else if (json.is_array()) {
+        out.push_back(0x9f);
+        for (const auto& value : json)
+            toIndefiniteCbor(value, out);
+        out.push_back(CborWriter::BREAK);
+    } else {
+        auto encoded = nlohmann::json::to_cbor(json);
+        out.insert(out.end(), encoded.begin(), encoded.end());
+    }
+}
+
+void CborTests::setUp() {
+}
+
+void CborTests::testPrimitives() {
+    std::vector<int64_t> integers {
+        0, 1, 23, 24, 255, 256, 65535, 65536, 0xffffffffLL, 0x100000000LL,
+        std::numeric_limits<int64_t>::max(),
+        -1, -24, -25, -256, -257, -65536, -65537, -0x100000000LL, -0x100000001LL,
+        std::numeric_limits<int32_t>::min(), std::numeric_limits<int64_t>::min()
+    };
+
+    for (auto value : integers) {
+        std::vector<uint8_t> encoded {};
+        CborWriter(encoded).writeInteger(value);
+        CPPUNIT_ASSERT(nlohmann::json::to_cbor(nlohmann::json(value)) == encoded);
+
+        CborReader reader(encoded);
+        CPPUNIT_ASSERT_EQUAL(value, reader.readInteger());
+        CPPUNIT_ASSERT(reader.atEnd());
+    }
+
+    for (size_t size : {0, 1, 23, 24, 255, 256, 65535, 65536}) {
+        std::vector<uint8_t> bytes(size, 'B');
+        std::string text(size, 'T');
+
+        std::vector<uint8_t> encoded {};
+        CborWriter writer(encoded);
+        writer.writeArray(2);
+        writer.writeBytes(bytes);
+        writer.writeText(text);
+
+        auto json = nlohmann::json::array({ nlohmann::json::binary(bytes), text });
+        CPPUNIT_ASSERT(nlohmann::json::to_cbor(json) == encoded);
+
+        CborReader reader(encoded);
+        auto array = reader.enterArray();
+        reader.expectNext(array);
+        auto blob = reader.readBytes();
+        CPPUNIT_ASSERT(std::vector<uint8_t>(blob.cbegin(), blob.cend()) == bytes);
+        reader.expectNext(array);
+        CPPUNIT_ASSERT(reader.readText() == text);
+        CPPUNIT_ASSERT(!reader.hasNext(array));
+        CPPUNIT_ASSERT(reader.atEnd());
+    }
+}
+
+void CborTests::testRoundTrip() {
+    std::mt19937 rng(Utils::getRandomValue());
+
+    for (int round = 0; round < 200; round++) {
+        for (auto& msg : randomMessages(rng)) {
+            auto encoded = msg->serialize();
+            CPPUNIT_ASSERT(encoded.size() <= (size_t)msg->estimateSize());
+
+            // the same bytes the JSON DOM based encoding produced
+            auto json = nlohmann::json::from_cbor(encoded);
+            CPPUNIT_ASSERT(nlohmann::json::to_cbor(json) == encoded);
+
+            auto parsed = Message::parse(encoded.data(), encoded.size());
+            CPPUNIT_ASSERT_EQUAL(msg->getType(), parsed->getType());
+            CPPUNIT_ASSERT_EQUAL(msg->getMethod(), parsed->getMethod());
+            CPPUNIT_ASSERT_EQUAL(msg->getTxid(), parsed->getTxid());
+            CPPUNIT_ASSERT_EQUAL(msg->getVersion(), parsed->getVersion());
+            CPPUNIT_ASSERT(parsed->serialize() == encoded);
+        }
+    }
+}
+
+void CborTests::testIndefiniteLength() {
+    std::mt19937 rng(Utils::getRandomValue());
+
+    for (int round = 0; round < 50; round++) {
+        for (auto& msg : randomMessages(rng)) {
+            auto encoded = msg->serialize();
+
+            std::vector<uint8_t> indefinite {};
+            toIndefiniteCbor(nlohmann::json::from_cbor(encoded), indefinite);
+
+            auto parsed = Message::parse(indefinite.data(), indefinite.size());
+            CPPUNIT_ASSERT(parsed->serialize() == encoded);
+        }
+    }
+}
+
+void CborTests::testUnknownFields() {
+    std::mt19937 rng(Utils::getRandomValue());
+
+    for (auto& msg : randomMessages(rng)) {
+        auto encoded = msg->serialize();
+
+        // the top level fields a newer peer may add, the bodies stay strict
+        auto json = nlohmann::json::from_cbor(encoded);
+        json["a"] = nlohmann::json::array({ 1, -2, "three", nlohmann::json::binary({ 4 }), nullptr });
+        json["z"] = { { "nested", { { "map", true } } } };
+
+        auto extended = nlohmann::json::to_cbor(json);
+        auto parsed = Message::parse(extended.data(), extended.size());
+        CPPUNIT_ASSERT(parsed->serialize() == encoded);
+    }
+}
+
+void CborTests::testMalformed() {
+    std::mt19937 rng(Utils::getRandomValue());
+
+    for (auto& msg : randomMessages(rng)) {
+        auto encoded = msg->serialize();
+
+        // every truncation misses a map entry at least
+        for (size_t size = 0; size < encoded.size(); size++) {
+            std::vector<uint8_t> truncated(encoded.begin(), encoded.begin() + size);
+            CPPUNIT_ASSERT_THROW(Message::parse(truncated.data(), truncated.size()), std::exception);
+        }
+
+        std::vector<uint8_t> trailing(encoded);
+        trailing.push_back(0);
+        CPPUNIT_ASSERT_THROW(Message::parse(trailing.data(), trailing.size()), std::exception);
+
+        // the corrupted ones either parse or throw, never read past the buffer
+        for (int round = 0; round < 500; round++) {
+            std::vector<uint8_t> mutated(encoded);
+            int flips = 1 + rng() % 4;
+            for (int i = 0; i < flips; i++)
+                mutated[rng() % mutated.size()] = (uint8_t)rng();
+
+            try {
+                auto parsed = Message::parse(mutated.data(), mutated.size());
+                parsed->serialize();
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    // the nesting is bounded
+    std::vector<uint8_t> nested { 0xa2, 0x61, 'x' };
+    nested.insert(nested.end(), 1000, 0x81);
+    nested.insert(nested.end(), { 0x00, 0x61, 'y', 0x00 });
+    CPPUNIT_ASSERT_THROW(Message::parse(nested.data(), nested.size()), std::exception);
+}
+
+void CborTests::tearDown() {
+}
+
+}  // namespace test
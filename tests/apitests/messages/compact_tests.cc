@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+
+#include "constants.h"
+#include "messages/message.h"
+#include "messages/ping_request.h"
+#include "messages/ping_response.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+#include "messages/find_value_request.h"
+
+#include "utils.h"
+#include "compact_tests.h"
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(CompactTests);
+
+void CompactTests::setUp() {
+}
+
+void CompactTests::testSupportsCompact() {
+    auto name = Constants::NODE_SHORT_NAME;
+    CPPUNIT_ASSERT(Message::supportsCompact(Version::build(name, Message::COMPACT_MIN_VERSION)));
+    CPPUNIT_ASSERT(Message::supportsCompact(Version::build(name, Message::COMPACT_MIN_VERSION + 1)));
+    CPPUNIT_ASSERT(!Message::supportsCompact(Version::build(name, 1)));
+    CPPUNIT_ASSERT(!Message::supportsCompact(0));
+
+    // the other implementations keep CBOR
+    std::string other = "OR";
+    CPPUNIT_ASSERT(!Message::supportsCompact(Version::build(other, Message::COMPACT_MIN_VERSION)));
+    CPPUNIT_ASSERT(!Message::supportsCompact(VERSION));
+}
+
+void CompactTests::testPing() {
+    int txid = Utils::getRandomInteger(62);
+
+    auto request = PingRequest();
+    request.setTxid(txid);
+    request.setVersion(VERSION);
+    request.setCompact(true);
+
+    auto serialized = request.serialize();
+    CPPUNIT_ASSERT_EQUAL((size_t)10, serialized.size());
+    CPPUNIT_ASSERT_EQUAL((uint8_t)Message::COMPACT_FORMAT, serialized[0]);
+
+    auto parsed = Message::parse(serialized.data(), serialized.size());
+    CPPUNIT_ASSERT(Message::Type::REQUEST == parsed->getType());
+    CPPUNIT_ASSERT(Message::Method::PING == parsed->getMethod());
+    CPPUNIT_ASSERT(txid == parsed->getTxid());
+    CPPUNIT_ASSERT(VERSION_STR == parsed->getReadableVersion());
+    CPPUNIT_ASSERT(parsed->isCompact());
+
+    auto response = PingResponse(txid);
+    response.setVersion(VERSION);
+    response.setCompact(true);
+    serialized = response.serialize();
+
+    parsed = Message::parse(serialized.data(), serialized.size());
+    CPPUNIT_ASSERT(Message::Type::RESPONSE == parsed->getType());
+    CPPUNIT_ASSERT(Message::Method::PING == parsed->getMethod());
+    CPPUNIT_ASSERT(txid == parsed->getTxid());
+    CPPUNIT_ASSERT(parsed->serialize() == serialized);
+}
+
+void CompactTests::testFindNodeRequest() {
+    auto target = Id::random();
+    int txid = Utils::getRandomInteger(62);
+
+    auto msg = FindNodeRequest(target, true);
+    msg.setTxid(txid);
+    msg.setVersion(VERSION);
+    msg.setWant4(true);
+    msg.setWant6(false);
+    msg.setCompact(true);
+
+    auto serialized = msg.serialize();
+    CPPUNIT_ASSERT_EQUAL((size_t)(10 + Id::BYTES + 1), serialized.size());
+    CPPUNIT_ASSERT(serialized.size() < FindNodeRequest(target).serialize().size());
+
+    auto parsed = Message::parse(serialized.data(), serialized.size());
+    auto _msg = std::static_pointer_cast<FindNodeRequest>(parsed);
+    CPPUNIT_ASSERT(Message::Method::FIND_NODE == _msg->getMethod());
+    CPPUNIT_ASSERT(txid == _msg->getTxid());
+    CPPUNIT_ASSERT(target == _msg->getTarget());
+    CPPUNIT_ASSERT(_msg->doesWant4());
+    CPPUNIT_ASSERT(!_msg->doesWant6());
+    CPPUNIT_ASSERT(_msg->doesWantToken());
+}
+
+void CompactTests::testFindNodeResponse() {
+    int txid = Utils::getRandomInteger(62);
+
+    std::list<std::shared_ptr<NodeInfo>> nodes4 {};
+    std::list<std::shared_ptr<NodeInfo>> nodes6 {};
+    for (int i = 0; i < 8; i++) {
+        nodes4.push_back(std::make_shared<NodeInfo>(Id::random(), "192.168.1." + std::to_string(i + 1), 39001 + i));
+        nodes6.push_back(std::make_shared<NodeInfo>(Id::random(), "2001:db8::" + std::to_string(i + 1), 39001 + i));
+    }
+
+    auto msg = FindNodeResponse(txid);
+    msg.setVersion(VERSION);
+    msg.setNodes4(nodes4);
+    msg.setNodes6(nodes6);
+    msg.setToken(0x12345678);
+
+    auto cbor = msg.serialize();
+    msg.setCompact(true);
+    auto serialized = msg.serialize();
+    CPPUNIT_ASSERT_EQUAL((size_t)(10 + 4 + 1 + 8 * 38 + 1 + 8 * 50), serialized.size());
+    CPPUNIT_ASSERT(serialized.size() < cbor.size());
+    CPPUNIT_ASSERT(serialized.size() <= msg.estimateSize());
+
+    auto parsed = Message::parse(serialized.data(), serialized.size());
+    auto _msg = std::static_pointer_cast<FindNodeResponse>(parsed);
+    CPPUNIT_ASSERT(Message::Type::RESPONSE == _msg->getType());
+    CPPUNIT_ASSERT(Message::Method::FIND_NODE == _msg->getMethod());
+    CPPUNIT_ASSERT(txid == _msg->getTxid());
+    CPPUNIT_ASSERT(VERSION_STR == _msg->getReadableVersion());
+    CPPUNIT_ASSERT(0x12345678 == _msg->getToken());
+    auto _nodes4 = _msg->getNodes4();
+    auto _nodes6 = _msg->getNodes6();
+    CPPUNIT_ASSERT(Utils::arrayEquals(nodes4, _nodes4));
+    CPPUNIT_ASSERT(Utils::arrayEquals(nodes6, _nodes6));
+
+    // no token, no nodes
+    auto empty = FindNodeResponse(txid);
+    empty.setCompact(true);
+    serialized = empty.serialize();
+    parsed = Message::parse(serialized.data(), serialized.size());
+    _msg = std::static_pointer_cast<FindNodeResponse>(parsed);
+    CPPUNIT_ASSERT(0 == _msg->getToken());
+    CPPUNIT_ASSERT(_msg->getNodes4().empty());
+    CPPUNIT_ASSERT(_msg->getNodes6().empty());
+}
+
+void CompactTests::testOtherMethods() {
+    // no compact form, stays CBOR
+    auto msg = FindValueRequest(Id::random());
+    msg.setTxid(0x12345678);
+    msg.setVersion(VERSION);
+    auto cbor = msg.serialize();
+
+    msg.setCompact(true);
+    CPPUNIT_ASSERT(!msg.isCompact());
+    CPPUNIT_ASSERT(msg.serialize() == cbor);
+
+    // and isn't accepted in the compact layout
+    std::vector<uint8_t> forged { Message::COMPACT_FORMAT, 0x26, 0, 0, 0, 1, 0, 0, 0, 0 };
+    CPPUNIT_ASSERT_THROW(Message::parse(forged.data(), forged.size()), std::exception);
+}
+
+void CompactTests::testMalformed() {
+    auto msg = FindNodeResponse(0x12345678);
+    std::list<std::shared_ptr<NodeInfo>> nodes4 {};
+    for (int i = 0; i < 4; i++)
+        nodes4.push_back(std::make_shared<NodeInfo>(Id::random(), "192.168.1.1", 39001 + i));
+    msg.setNodes4(nodes4);
+    msg.setCompact(true);
+    auto serialized = msg.serialize();
+
+    for (size_t size = 1; size < serialized.size(); size++)
+        CPPUNIT_ASSERT_THROW(Message::parse(serialized.data(), size), std::exception);
+
+    serialized.push_back(0);
+    CPPUNIT_ASSERT_THROW(Message::parse(serialized.data(), serialized.size()), std::exception);
+}
+
+void CompactTests::tearDown() {
+}
+
+}  // namespace test
@@ -259,6 +259,41 @@ void FindNodeTests::testFindNodeResponseSize() {
     CPPUNIT_ASSERT(serialized.size() <= msg.estimateSize());
 }
 
+void FindNodeTests::testFindNodeResponseFitSize() {
+    std::list<std::shared_ptr<NodeInfo>> nodes4 {};
+    std::list<std::shared_ptr<NodeInfo>> nodes6 {};
+    for (int i = 0; i < 8; i++) {
+        nodes4.push_back(std::make_shared<NodeInfo>(Id::random(), "251.251.251.251", 65535 - i));
+        nodes6.push_back(std::make_shared<NodeInfo>(Id::random(), "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff", 65535 - i));
+    }
+
+    auto msg = FindNodeResponse(0xF7654321);
+    msg.setId(Id::random());
+    msg.setVersion(VERSION);
+    msg.setNodes4(nodes4);
+    msg.setNodes6(nodes6);
+    msg.setToken(0x78901234);
+
+    // fits already, nothing dropped
+    CPPUNIT_ASSERT(msg.fitSize(msg.estimateSize()));
+    CPPUNIT_ASSERT_EQUAL((size_t)8, msg.getNodes4().size());
+    CPPUNIT_ASSERT_EQUAL((size_t)8, msg.getNodes6().size());
+
+    // the farthest ones are dropped, both families kept
+    CPPUNIT_ASSERT(msg.fitSize(600));
+    CPPUNIT_ASSERT(msg.estimateSize() <= 600);
+    CPPUNIT_ASSERT(msg.serialize().size() <= 600);
+    CPPUNIT_ASSERT(!msg.getNodes4().empty());
+    CPPUNIT_ASSERT(!msg.getNodes6().empty());
+    CPPUNIT_ASSERT(msg.getNodes4().front() == nodes4.front());
+    CPPUNIT_ASSERT(msg.getNodes6().front() == nodes6.front());
+
+    CPPUNIT_ASSERT(!msg.fitSize(32));
+    CPPUNIT_ASSERT(msg.getNodes4().empty());
+    CPPUNIT_ASSERT(msg.getNodes6().empty());
+    CPPUNIT_ASSERT_EQUAL(0x78901234, msg.getToken());
+}
+
 void
 FindNodeTests::testFindNodeResponse4() {
     auto id = Id::random();
@@ -38,6 +38,7 @@ class FindNodeTests : public MessageTests, public CppUnit::TestFixture {
     CPPUNIT_TEST(testFindNodeRequest46);
     CPPUNIT_TEST(testFindNodeRequest46WithAt);
     CPPUNIT_TEST(testFindNodeResponseSize);
+    CPPUNIT_TEST(testFindNodeResponseFitSize);
     CPPUNIT_TEST(testFindNodeResponse4);
     CPPUNIT_TEST(testFindNodeResponse4WithToken);
     CPPUNIT_TEST(testFindNodeResponse6);
@@ -58,6 +59,7 @@ public:
     void testFindNodeRequest46();
     void testFindNodeRequest46WithAt();
     void testFindNodeResponseSize();
+    void testFindNodeResponseFitSize();
     void testFindNodeResponse4();
     void testFindNodeResponse4WithToken();
     void testFindNodeResponse6();
@@ -216,6 +216,61 @@ void FindPeerTests::testFindPeerResponseSize2() {
     CPPUNIT_ASSERT(serialized.size() <= msg.estimateSize());
 }
 
+void FindPeerTests::testFindPeerResponseFitSize() {
+    std::list<PeerInfo> peers {};
+    std::vector<uint8_t> sig(64);
+    Id pid = Id::random();
+    for (int i = 0; i < 8; i++) {
+        Random::buffer(sig.data(), sig.size());
+        peers.push_back(PeerInfo::of(pid.blob(), {}, Id::random().blob(), {}, 65535 - i, {}, sig));
+    }
+
+    auto msg = FindPeerResponse(0xF7654321);
+    msg.setId(Id::random());
+    msg.setVersion(VERSION);
+    msg.setToken(0x87654321);
+    msg.setPeers(peers);
+
+    CPPUNIT_ASSERT(msg.fitSize(500));
+    CPPUNIT_ASSERT(msg.serialize().size() <= 500);
+    CPPUNIT_ASSERT(msg.getPeers().size() < 8);
+    CPPUNIT_ASSERT(msg.getPeers().front().getNodeId() == peers.front().getNodeId());
+
+    // the last peer is kept even if it doesn't fit
+    CPPUNIT_ASSERT(!msg.fitSize(100));
+    CPPUNIT_ASSERT_EQUAL((size_t)1, msg.getPeers().size());
+}
+
+void FindPeerTests::testFindPeerResponseValidPeers() {
+    auto keypair = Signature::KeyPair::random();
+    std::list<PeerInfo> valid {};
+    std::list<PeerInfo> peers {};
+    std::vector<uint8_t> sig(64);
+    for (int i = 0; i < 6; i++) {
+        if (i % 3 == 1) {
+            // a forged record of the same peer
+            Random::buffer(sig.data(), sig.size());
+            peers.push_back(PeerInfo::of(Id(keypair.publicKey()).blob(), {}, Id::random().blob(), {}, 65535 - i, {}, sig));
+        } else {
+            auto peer = PeerInfo::create(keypair, Id::random(), 65535 - i);
+            valid.push_back(peer);
+            peers.push_back(peer);
+        }
+    }
+
+    auto msg = FindPeerResponse(0xF7654321);
+    msg.setPeers(peers);
+
+    CPPUNIT_ASSERT(!msg.isSignatureValid());
+    CPPUNIT_ASSERT(valid == msg.getValidPeers());
+
+    msg.setPeers(valid);
+    auto serialized = msg.serialize();
+    auto parsed = std::static_pointer_cast<FindPeerResponse>(Message::parse(serialized.data(), serialized.size()));
+    CPPUNIT_ASSERT(parsed->isSignatureValid());
+    CPPUNIT_ASSERT(valid == parsed->getValidPeers());
+}
+
 void FindPeerTests::testFindPeerResponse4() {
     auto id = Id::random();
     int txid = Utils::getRandomValue();
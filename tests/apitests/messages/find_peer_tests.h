@@ -36,6 +36,8 @@ class FindPeerTests : public MessageTests, public CppUnit::TestFixture {
     CPPUNIT_TEST(testFindPeerRequest46);
     CPPUNIT_TEST(testFindPeerResponseSize);
     CPPUNIT_TEST(testFindPeerResponseSize2);
+    CPPUNIT_TEST(testFindPeerResponseFitSize);
+    CPPUNIT_TEST(testFindPeerResponseValidPeers);
     CPPUNIT_TEST(testFindPeerResponse4);
     CPPUNIT_TEST(testFindPeerResponse6);
     CPPUNIT_TEST(testFindPeerResponse46);
@@ -51,6 +53,8 @@ public:
     void testFindPeerRequest46();
     void testFindPeerResponseSize();
     void testFindPeerResponseSize2();
+    void testFindPeerResponseFitSize();
+    void testFindPeerResponseValidPeers();
     void testFindPeerResponse4();
     void testFindPeerResponse6();
     void testFindPeerResponse46();
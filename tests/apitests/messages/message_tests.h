@@ -23,6 +23,8 @@
 #pragma once
 
 #include <string>
+#include <iostream>
+#include <nlohmann/json.hpp>
 
 #include "crypto/hex.h"
 #include "messages/message.h"
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <stdexcept>
+
+#include "utils/metrics.h"
+#include "metrics_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(MetricsTests);
+
+void MetricsTests::setUp() {
+}
+
+void MetricsTests::testRegistry() {
+    auto& counter = Metrics::counter("test_registry_total", "Test counter", {{ "method", "ping" }});
+    counter.inc();
+    counter.inc(2);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)3, counter.get());
+
+    // the same name and labels give the same metric
+    CPPUNIT_ASSERT(&counter == &Metrics::counter("test_registry_total", "Test counter", {{ "method", "ping" }}));
+    CPPUNIT_ASSERT(&counter != &Metrics::counter("test_registry_total", "Test counter", {{ "method", "find_node" }}));
+
+    auto& gauge = Metrics::gauge("test_registry_gauge", "Test gauge");
+    gauge.set(10);
+    gauge.dec(3);
+    gauge.inc();
+    CPPUNIT_ASSERT_EQUAL((int64_t)8, gauge.get());
+
+    // a name has only one type
+    CPPUNIT_ASSERT_THROW(Metrics::gauge("test_registry_total", "Test counter"), std::invalid_argument);
+}
+
+void MetricsTests::testBuckets() {
+    // every value falls in the bucket bounded by its neighbours
+    for (uint64_t value = 0; value < 100000; value++) {
+        int index = Histogram::indexOf(value);
+        CPPUNIT_ASSERT(Histogram::lowerBound(index) <= value);
+        CPPUNIT_ASSERT(value < Histogram::lowerBound(index + 1));
+    }
+
+    // within 12.5% above the exact buckets
+    for (int exponent = 3; exponent < Histogram::MAX_EXPONENT; exponent++) {
+        uint64_t value = (1ULL << exponent) + 1;
+        int index = Histogram::indexOf(value);
+        CPPUNIT_ASSERT(Histogram::lowerBound(index + 1) - Histogram::lowerBound(index) <= value / 8);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(Histogram::BUCKETS - 1, Histogram::indexOf(UINT64_MAX));
+}
+
+void MetricsTests::testPercentiles() {
+    Histogram histogram;
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, histogram.percentile(50));
+
+    for (uint64_t value = 1; value <= 1000; value++)
+        histogram.record(value);
+
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000, histogram.count());
+    CPPUNIT_ASSERT_EQUAL((uint64_t)500500, histogram.sum());
+
+    auto p50 = histogram.percentile(50);
+    auto p99 = histogram.percentile(99);
+    CPPUNIT_ASSERT(p50 >= 500 && p50 <= 500 * 9 / 8);
+    CPPUNIT_ASSERT(p99 >= 990 && p99 <= 990 * 9 / 8);
+    CPPUNIT_ASSERT(histogram.percentile(100) >= 1000);
+
+    CPPUNIT_ASSERT_EQUAL((uint64_t)511, histogram.countBelow(512));
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000, histogram.countBelow(1024));
+
+    histogram.reset();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, histogram.count());
+}
+
+void MetricsTests::testScrape() {
+    Metrics::counter("test_scrape_total", "Scraped counter", {{ "direction", "sent" }}).inc(5);
+    auto& histogram = Metrics::histogram("test_scrape_seconds", "Scraped histogram", {}, 1e-3);
+    histogram.record(3);
+    histogram.record(100);
+
+    auto text = Metrics::scrape();
+    CPPUNIT_ASSERT(text.find("# HELP test_scrape_total Scraped counter\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("# TYPE test_scrape_total counter\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_scrape_total{direction=\"sent\"} 5\n") != std::string::npos);
+
+    CPPUNIT_ASSERT(text.find("# TYPE test_scrape_seconds histogram\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_scrape_seconds_bucket{le=\"0.003\"} 1\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_scrape_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_scrape_seconds_sum 0.103") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_scrape_seconds_count 2\n") != std::string::npos);
+}
+
+void MetricsTests::testScrapeBoundary() {
+    // a value on a power of two belongs to the bucket above the one ending before it
+    auto& histogram = Metrics::histogram("test_boundary_milliseconds", "Boundary histogram", {}, 1);
+    histogram.record(1023);
+    histogram.record(1024);
+
+    auto text = Metrics::scrape();
+    CPPUNIT_ASSERT(text.find("test_boundary_milliseconds_bucket{le=\"255\"} 0\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_boundary_milliseconds_bucket{le=\"1023\"} 1\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_boundary_milliseconds_bucket{le=\"4095\"} 2\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_boundary_milliseconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+
+    // the same edges once scaled, (2^12 - 1) ms is in le="4.095", 2^12 ms is not
+    auto& scaled = Metrics::histogram("test_boundary_seconds", "Scaled boundary histogram", {}, 1e-3);
+    scaled.record(4095);
+    scaled.record(4096);
+
+    text = Metrics::scrape();
+    CPPUNIT_ASSERT(text.find("test_boundary_seconds_bucket{le=\"4.095\"} 1\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_boundary_seconds_bucket{le=\"16.383\"} 2\n") != std::string::npos);
+    CPPUNIT_ASSERT(text.find("test_boundary_seconds_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+}
+
+void MetricsTests::tearDown() {
+}
+
+}  // namespace test
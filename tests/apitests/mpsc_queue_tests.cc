@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "utils/mpsc_queue.h"
+#include "mpsc_queue_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(MPSCQueueTests);
+
+void MPSCQueueTests::setUp() {
+}
+
+void MPSCQueueTests::testOrder() {
+    MPSCQueue<int> queue(8);
+
+    int value;
+    CPPUNIT_ASSERT(!queue.pop(value));
+
+    CPPUNIT_ASSERT_EQUAL((size_t)1, queue.push(1));
+    CPPUNIT_ASSERT_EQUAL((size_t)2, queue.push(2));
+    CPPUNIT_ASSERT_EQUAL((size_t)3, queue.push(3));
+
+    for (int i = 1; i <= 3; i++) {
+        CPPUNIT_ASSERT(queue.pop(value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+    }
+    CPPUNIT_ASSERT(!queue.pop(value));
+
+    // drained, the next push is the first one again
+    CPPUNIT_ASSERT_EQUAL((size_t)1, queue.push(4));
+}
+
+void MPSCQueueTests::testFull() {
+    MPSCQueue<int> queue(6);
+    CPPUNIT_ASSERT_EQUAL((size_t)8, queue.capacity());
+
+    for (int i = 0; i < 8; i++)
+        CPPUNIT_ASSERT(queue.push(i) > 0);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, queue.push(8));
+
+    int value;
+    CPPUNIT_ASSERT(queue.pop(value));
+    CPPUNIT_ASSERT_EQUAL(0, value);
+    CPPUNIT_ASSERT(queue.push(8) > 0);
+    CPPUNIT_ASSERT_EQUAL((size_t)8, queue.size());
+}
+
+void MPSCQueueTests::testProducers() {
+    const int PRODUCERS = 4;
+    const int COUNT = 100000;
+    MPSCQueue<int> queue(1024);
+
+    std::vector<std::thread> producers {};
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < COUNT; i++) {
+                while (queue.push(p * COUNT + i) == 0)
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // each producer's values come out in its own order
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * COUNT) {
+        int value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int p = value / COUNT;
+        CPPUNIT_ASSERT_EQUAL(next[p], value % COUNT);
+        next[p]++;
+        received++;
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+
+    int value;
+    CPPUNIT_ASSERT(!queue.pop(value));
+}
+
+void MPSCQueueTests::tearDown() {
+}
+
+}  // namespace test
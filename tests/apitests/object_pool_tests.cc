@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include "carrier/node_info.h"
+#include "utils/object_pool.h"
+#include "object_pool_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(ObjectPoolTests);
+
+void ObjectPoolTests::setUp() {
+}
+
+void ObjectPoolTests::testRecycle() {
+    BlockPool pool(64, 2);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, pool.size());
+
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    auto c = pool.allocate();
+    CPPUNIT_ASSERT(a != b && b != c && a != c);
+
+    // bounded, the third block goes back to the heap
+    pool.deallocate(a);
+    pool.deallocate(b);
+    pool.deallocate(c);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, pool.size());
+
+    auto d = pool.allocate();
+    CPPUNIT_ASSERT(d == b);
+    auto e = pool.allocate();
+    CPPUNIT_ASSERT(e == a);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, pool.size());
+
+    pool.deallocate(d);
+    pool.deallocate(e);
+}
+
+void ObjectPoolTests::testDisabled() {
+    BlockPool pool(64, 8);
+
+    auto a = pool.allocate();
+    BlockPool::setEnabled(false);
+    pool.deallocate(a);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, pool.size());
+
+    // the blocks taken while disabled are recycled once enabled again
+    auto b = pool.allocate();
+    BlockPool::setEnabled(true);
+    pool.deallocate(b);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, pool.size());
+    CPPUNIT_ASSERT(pool.allocate() == b);
+    pool.deallocate(b);
+}
+
+void ObjectPoolTests::testMakePooled() {
+    auto id = Id::random();
+    auto node = makePooled<NodeInfo>(id, SocketAddress("192.168.1.1", 39001));
+    CPPUNIT_ASSERT(node->getId() == id);
+    CPPUNIT_ASSERT_EQUAL(39001, node->getPort());
+
+    // the retained one keeps its block, the released one is reused
+    std::weak_ptr<NodeInfo> weak = node;
+    auto retained = node;
+    const NodeInfo* address = node.get();
+    node.reset();
+    CPPUNIT_ASSERT(!weak.expired());
+
+    retained.reset();
+    CPPUNIT_ASSERT(weak.expired());
+    weak.reset();
+
+    auto reused = makePooled<NodeInfo>(Id::random(), SocketAddress("192.168.1.2", 39002));
+    CPPUNIT_ASSERT(reused.get() == address);
+    CPPUNIT_ASSERT_EQUAL(39002, reused->getPort());
+}
+
+void ObjectPoolTests::tearDown() {
+    BlockPool::setEnabled(true);
+}
+
+}  // namespace test
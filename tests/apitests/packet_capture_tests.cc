@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <carrier.h>
+#include "packet_capture.h"
+#include "packet_replay.h"
+#include "utils.h"
+#include "packet_capture_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(PacketCaptureTests);
+
+namespace {
+
+struct Receiver : public Transport::Listener {
+    std::vector<std::vector<uint8_t>> received {};
+    std::vector<SocketAddress> from {};
+    Transport* transport {nullptr};
+    SocketAddress self {};
+
+    void onReceive(const uint8_t* data, size_t size, const SocketAddress& peer) override {
+        received.emplace_back(data, data + size);
+        from.push_back(peer);
+        // answers every datagram
+        transport->send(self, data, size, peer);
+    }
+
+    uint64_t onPoll() override {
+        return Transport::NO_DEADLINE;
+    }
+};
+
+}
+
+void PacketCaptureTests::setUp() {
+    path = Utils::getPwdStorage("packet_capture_tests.cap");
+}
+
+void PacketCaptureTests::testRoundTrip() {
+    auto nodeId = Id::random();
+    auto peer4 = SocketAddress("44.0.0.1", 39001);
+    auto peer6 = SocketAddress("2001:db8::1", 39002);
+    std::vector<uint8_t> small {1, 2, 3};
+    std::vector<uint8_t> large(1400, 0x5a);
+
+    {
+        PacketCapture capture(path, nodeId);
+        auto start = PacketCapture::now();
+        capture.write(PacketCapture::Direction::INBOUND, peer4, small.data(), small.size(), start + 10);
+        capture.write(PacketCapture::Direction::OUTBOUND, peer6, large.data(), large.size(), start + 250000);
+        capture.write(PacketCapture::Direction::INBOUND, peer6, nullptr, 0, start + 250000);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)3, capture.getRecords());
+    }
+
+    PacketCaptureReader reader(path);
+    CPPUNIT_ASSERT(reader.getNodeId() == nodeId);
+
+    auto start = reader.getStartTime();
+    PacketCapture::Record record;
+
+    CPPUNIT_ASSERT(reader.next(record));
+    CPPUNIT_ASSERT(record.direction == PacketCapture::Direction::INBOUND);
+    CPPUNIT_ASSERT(record.peer == peer4);
+    CPPUNIT_ASSERT(record.data == small);
+    auto first = record.timestamp;
+    CPPUNIT_ASSERT(first >= start);
+
+    CPPUNIT_ASSERT(reader.next(record));
+    CPPUNIT_ASSERT(record.direction == PacketCapture::Direction::OUTBOUND);
+    CPPUNIT_ASSERT(record.peer == peer6);
+    CPPUNIT_ASSERT(record.data == large);
+    CPPUNIT_ASSERT_EQUAL(first + 249990, record.timestamp);
+
+    CPPUNIT_ASSERT(reader.next(record));
+    CPPUNIT_ASSERT(record.peer == peer6);
+    CPPUNIT_ASSERT(record.data.empty());
+    CPPUNIT_ASSERT_EQUAL(first + 249990, record.timestamp);
+
+    CPPUNIT_ASSERT(!reader.next(record));
+}
+
+void PacketCaptureTests::testInvalidFile() {
+    CPPUNIT_ASSERT_THROW(PacketCaptureReader {path + ".missing"}, std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a capture file at all";
+    }
+    CPPUNIT_ASSERT_THROW(PacketCaptureReader {path}, std::runtime_error);
+
+    // cut in the middle of a record
+    std::vector<uint8_t> data(100, 1);
+    {
+        PacketCapture capture(path, Id::random());
+        capture.write(PacketCapture::Direction::INBOUND, SocketAddress("44.0.0.1", 39001), data.data(), data.size());
+    }
+    std::vector<char> content;
+    {
+        std::ifstream in(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), content.size() - 10);
+    }
+
+    PacketCaptureReader reader(path);
+    PacketCapture::Record record;
+    CPPUNIT_ASSERT_THROW(reader.next(record), std::runtime_error);
+}
+
+void PacketCaptureTests::testReplay() {
+    auto nodeId = Id::random();
+    auto peer = SocketAddress("44.0.0.1", 39001);
+    {
+        PacketCapture capture(path, nodeId);
+        auto start = PacketCapture::now();
+        for (uint8_t i = 0; i < 10; i++) {
+            std::vector<uint8_t> data(10, i);
+            capture.write(PacketCapture::Direction::INBOUND, peer, data.data(), data.size(), start + i * 20000);
+            capture.write(PacketCapture::Direction::OUTBOUND, peer, data.data(), data.size(), start + i * 20000 + 1000);
+        }
+    }
+
+    // at the double speed, the 180ms of the capture take 90ms
+    {
+        PacketReplay replay(path);
+        CPPUNIT_ASSERT(replay.getNodeId() == nodeId);
+        CPPUNIT_ASSERT_THROW(replay.run(), std::runtime_error);
+
+        Receiver receiver;
+        receiver.transport = &replay;
+        receiver.self = replay.bind(SocketAddress("44.0.0.2", 39001), receiver);
+
+        auto stats = replay.run(2.0);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)10, stats.replayed);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)10, stats.skipped);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)10, stats.sent);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)100, stats.sentBytes);
+        CPPUNIT_ASSERT(stats.elapsed >= 90);
+
+        CPPUNIT_ASSERT_EQUAL((size_t)10, receiver.received.size());
+        for (uint8_t i = 0; i < 10; i++) {
+            CPPUNIT_ASSERT(receiver.received[i] == std::vector<uint8_t>(10, i));
+            CPPUNIT_ASSERT(receiver.from[i] == peer);
+        }
+
+        replay.unbind(receiver.self);
+    }
+
+    // as fast as possible
+    {
+        PacketReplay replay(path);
+        Receiver receiver;
+        receiver.transport = &replay;
+        receiver.self = replay.bind(SocketAddress("44.0.0.2", 39001), receiver);
+
+        auto stats = replay.run(0);
+        CPPUNIT_ASSERT_EQUAL((uint64_t)10, stats.replayed);
+        CPPUNIT_ASSERT(stats.elapsed < 90);
+        replay.unbind(receiver.self);
+    }
+}
+
+void PacketCaptureTests::testWorkerCapture() {
+    auto storagePath = Utils::getPwdStorage("packet_capture_tests_data");
+    Utils::removeStorage(storagePath);
+
+    // the receive workers hand the datagrams on without going through handlePacket
+    auto builder = DefaultConfiguration::Builder {};
+    builder.setIPv4Address("127.0.0.1");
+    builder.setListeningPort(42290);
+    builder.setStoragePath(storagePath);
+    builder.setRPCWorkers(2);
+    builder.setRPCCaptureFile(path);
+
+    auto node = std::make_shared<Node>(builder.build());
+    node->start();
+
+    // undecryptable, dropped right after they are captured
+    std::vector<uint8_t> data(64, 0x5a);
+    auto to = SocketAddress("127.0.0.1", 42290);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    CPPUNIT_ASSERT(fd >= 0);
+    for (int i = 0; i < 3; i++)
+        sendto(fd, data.data(), data.size(), 0, to.addr(), to.length());
+    ::close(fd);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    auto nodeId = node->getId();
+    node->stop();
+    node.reset();
+
+    PacketCaptureReader reader(path);
+    CPPUNIT_ASSERT(reader.getNodeId() == nodeId);
+
+    int captured = 0;
+    PacketCapture::Record record;
+    while (reader.next(record)) {
+        if (record.direction == PacketCapture::Direction::INBOUND && record.data == data)
+            captured++;
+    }
+    CPPUNIT_ASSERT_EQUAL(3, captured);
+
+    Utils::removeStorage(storagePath);
+}
+
+void PacketCaptureTests::tearDown() {
+    std::remove(path.c_str());
+}
+
+}  // namespace test
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "constants.h"
+#include "rtt_estimator.h"
+#include "response_timeout_filter.h"
+#include "rtt_estimator_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(RTTEstimatorTests);
+
+void RTTEstimatorTests::setUp() {
+}
+
+void RTTEstimatorTests::testFirstSample() {
+    RTTEstimator rtt;
+    CPPUNIT_ASSERT(!rtt.hasSamples());
+
+    rtt.update(100);
+    CPPUNIT_ASSERT(rtt.hasSamples());
+    CPPUNIT_ASSERT_EQUAL(100, rtt.getSRTT());
+    CPPUNIT_ASSERT_EQUAL(50, rtt.getRTTVar());
+    // srtt + 4 * rttvar
+    CPPUNIT_ASSERT_EQUAL(300, rtt.getTimeout(0, 10000));
+}
+
+void RTTEstimatorTests::testConverge() {
+    RTTEstimator rtt;
+    rtt.update(1000);
+    for (int i = 0; i < 100; i++)
+        rtt.update(40);
+
+    CPPUNIT_ASSERT(rtt.getSRTT() >= 40 && rtt.getSRTT() <= 42);
+    CPPUNIT_ASSERT(rtt.getRTTVar() <= 2);
+    CPPUNIT_ASSERT(rtt.getTimeout(0, 10000) < 60);
+}
+
+void RTTEstimatorTests::testTimeoutBounds() {
+    RTTEstimator rtt;
+    rtt.update(5);
+    CPPUNIT_ASSERT_EQUAL(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN,
+            rtt.getTimeout(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN, Constants::RPC_CALL_TIMEOUT_MAX));
+
+    rtt.update(60000);
+    CPPUNIT_ASSERT_EQUAL(Constants::RPC_CALL_TIMEOUT_MAX,
+            rtt.getTimeout(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN, Constants::RPC_CALL_TIMEOUT_MAX));
+}
+
+void RTTEstimatorTests::testTimeoutFilter() {
+    ResponseTimeoutFilter filter;
+    CPPUNIT_ASSERT_EQUAL(Constants::RPC_CALL_STALL_TIMEOUT, filter.getStallTimeout());
+
+    // 95% of the round trips within 300ms, a few slow ones
+    for (int i = 0; i < 1000; i++)
+        filter.update(i % 20 == 0 ? 1500 : 100 + (i % 10) * 20);
+
+    int timeout = filter.getStallTimeout();
+    CPPUNIT_ASSERT(timeout >= 200 && timeout <= 300);
+
+    // the old samples decay away
+    for (int i = 0; i < 4000; i++)
+        filter.update(1);
+    CPPUNIT_ASSERT_EQUAL(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN, filter.getStallTimeout());
+
+    filter.reset();
+    CPPUNIT_ASSERT_EQUAL(Constants::RPC_CALL_STALL_TIMEOUT, filter.getStallTimeout());
+}
+
+void RTTEstimatorTests::tearDown() {
+}
+
+}  // namespace test
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+#include <random>
+#include <thread>
+
+#include <carrier.h>
+
+#include "utils/time.h"
+#include "scheduler.h"
+#include "scheduler_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(SchedulerTests);
+
+static void runUntil(Scheduler& scheduler, uint64_t deadline) {
+    while (currentTimeMillis() < deadline) {
+        scheduler.syncTime();
+        scheduler.run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    scheduler.syncTime();
+    scheduler.run();
+}
+
+void SchedulerTests::setUp() {
+}
+
+void SchedulerTests::testOrder() {
+    Scheduler scheduler;
+    std::mt19937 random(1);
+    std::uniform_int_distribution<long> delays(0, 600);
+
+    std::vector<uint64_t> expected {};
+    std::vector<uint64_t> fired {};
+    for (int i = 0; i < 1000; i++) {
+        auto delay = delays(random);
+        uint64_t due = currentTimeMillis() + delay;
+        scheduler.add([&fired, &expected, due]() {
+            CPPUNIT_ASSERT(currentTimeMillis() >= due);
+            fired.push_back(due);
+        }, delay);
+        expected.push_back(due);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)1000, scheduler.size());
+    CPPUNIT_ASSERT(scheduler.getNextJobTime() <= *std::min_element(expected.begin(), expected.end()));
+
+    runUntil(scheduler, currentTimeMillis() + 700);
+
+    CPPUNIT_ASSERT_EQUAL(expected.size(), fired.size());
+    CPPUNIT_ASSERT(std::is_sorted(fired.begin(), fired.end()));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, scheduler.size());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(), scheduler.getNextJobTime());
+}
+
+void SchedulerTests::testCancel() {
+    Scheduler scheduler;
+    int fired = 0;
+
+    std::vector<Sp<Scheduler::Job>> jobs {};
+    for (int i = 0; i < 100; i++)
+        jobs.push_back(scheduler.add([&]() { fired++; }, 50 + i));
+
+    for (int i = 0; i < 100; i += 2)
+        jobs[i]->cancel();
+
+    CPPUNIT_ASSERT_EQUAL((size_t)50, scheduler.size());
+    CPPUNIT_ASSERT(!jobs[0]->isArmed());
+    CPPUNIT_ASSERT(jobs[1]->isArmed());
+
+    runUntil(scheduler, currentTimeMillis() + 200);
+    CPPUNIT_ASSERT_EQUAL(50, fired);
+
+    // cancelling the only job leaves the scheduler without deadline
+    auto job = scheduler.add([&]() { fired++; }, 1000);
+    CPPUNIT_ASSERT(scheduler.getNextJobTime() != std::numeric_limits<uint64_t>::max());
+    job->cancel();
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(), scheduler.getNextJobTime());
+}
+
+void SchedulerTests::testFixedDelay() {
+    Scheduler scheduler;
+    int fired = 0;
+
+    auto job = scheduler.add([&]() { fired++; }, 0, 20);
+
+    runUntil(scheduler, currentTimeMillis() + 90);
+    CPPUNIT_ASSERT(fired >= 3 && fired <= 5);
+    CPPUNIT_ASSERT(job->isArmed());
+
+    job->cancel();
+    int count = fired;
+    runUntil(scheduler, currentTimeMillis() + 50);
+    CPPUNIT_ASSERT_EQUAL(count, fired);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, scheduler.size());
+}
+
+void SchedulerTests::testRearm() {
+    Scheduler scheduler;
+    int fired = 0;
+
+    auto job = scheduler.add([&]() { fired++; }, 5000);
+    scheduler.edit(job, 10);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, scheduler.size());
+
+    runUntil(scheduler, currentTimeMillis() + 100);
+    CPPUNIT_ASSERT_EQUAL(1, fired);
+}
+
+void SchedulerTests::testFarFuture() {
+    Scheduler scheduler;
+    int fired = 0;
+
+    // beyond the wheels, on the overflow list
+    long delay = 60L * 24 * 3600 * 1000;
+    uint64_t due = currentTimeMillis() + delay;
+    auto job = scheduler.add([&]() { fired++; }, delay);
+    CPPUNIT_ASSERT(scheduler.getNextJobTime() <= due);
+
+    scheduler.add([&]() { fired++; }, 10);
+    runUntil(scheduler, currentTimeMillis() + 50);
+    CPPUNIT_ASSERT_EQUAL(1, fired);
+    CPPUNIT_ASSERT(job->isArmed());
+
+    // jumping close to the due time cascades it back to the wheels
+    scheduler.syncTime(due - 1);
+    scheduler.run();
+    CPPUNIT_ASSERT_EQUAL(1, fired);
+    scheduler.syncTime(due);
+    scheduler.run();
+    CPPUNIT_ASSERT_EQUAL(2, fired);
+}
+
+void SchedulerTests::tearDown() {
+}
+
+}  // namespace test
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include "carrier/signature.h"
+#include "crypto/signature_cache.h"
+#include "signature_cache_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(SignatureCacheTests);
+
+void SignatureCacheTests::setUp() {
+}
+
+void SignatureCacheTests::testVerify() {
+    SignatureCache cache(64);
+    auto keyPair = Signature::KeyPair::random();
+    std::vector<uint8_t> data(128, 0x5a);
+    auto sig = keyPair.privateKey().sign(data);
+
+    CPPUNIT_ASSERT(cache.verify(data, sig, keyPair.publicKey()));
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, cache.getMisses());
+    CPPUNIT_ASSERT(cache.contains(SignatureCache::digest(data, sig, keyPair.publicKey())));
+
+    CPPUNIT_ASSERT(cache.verify(data, sig, keyPair.publicKey()));
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, cache.getHits());
+
+    cache.clear();
+    CPPUNIT_ASSERT(!cache.contains(SignatureCache::digest(data, sig, keyPair.publicKey())));
+}
+
+void SignatureCacheTests::testTampered() {
+    SignatureCache cache(64);
+    auto keyPair = Signature::KeyPair::random();
+    auto other = Signature::KeyPair::random();
+    std::vector<uint8_t> data(128, 0x5a);
+    auto sig = keyPair.privateKey().sign(data);
+    CPPUNIT_ASSERT(cache.verify(data, sig, keyPair.publicKey()));
+
+    // a cached signature doesn't vouch for other data or another key
+    auto tampered = data;
+    tampered[0] ^= 0x01;
+    CPPUNIT_ASSERT(!cache.verify(tampered, sig, keyPair.publicKey()));
+    CPPUNIT_ASSERT(!cache.verify(data, sig, other.publicKey()));
+
+    // the failures are not recorded
+    CPPUNIT_ASSERT(!cache.verify(tampered, sig, keyPair.publicKey()));
+    CPPUNIT_ASSERT_EQUAL((uint64_t)0, cache.getHits());
+    CPPUNIT_ASSERT_EQUAL((uint64_t)4, cache.getMisses());
+}
+
+void SignatureCacheTests::testBounded() {
+    SignatureCache cache(16);
+    CPPUNIT_ASSERT_EQUAL((size_t)16, cache.capacity());
+
+    for (int i = 0; i < 1000; i++) {
+        SignatureCache::Digest digest {};
+        digest[0] = i & 0xff;
+        digest[1] = i >> 8;
+        digest[31] = 1;
+        cache.put(digest);
+    }
+
+    int kept = 0;
+    for (int i = 0; i < 1000; i++) {
+        SignatureCache::Digest digest {};
+        digest[0] = i & 0xff;
+        digest[1] = i >> 8;
+        digest[31] = 1;
+        kept += cache.contains(digest) ? 1 : 0;
+    }
+    CPPUNIT_ASSERT(kept <= 16);
+    CPPUNIT_ASSERT(kept > 0);
+}
+
+void SignatureCacheTests::tearDown() {
+}
+
+}  // namespace test
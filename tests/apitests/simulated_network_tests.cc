@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+#include <chrono>
+
+#include <carrier.h>
+#include "exceptions/dht_error.h"
+#include "utils/time.h"
+#include "simulated_network.h"
+#include "utils.h"
+#include "simulated_network_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(SimulatedNetworkTests);
+
+namespace {
+
+struct Receiver : public Transport::Listener {
+    struct Datagram {
+        std::vector<uint8_t> data;
+        SocketAddress from;
+        uint64_t time;
+    };
+
+    std::vector<Datagram> received {};
+    uint64_t deadline {Transport::NO_DEADLINE};
+    int polls {0};
+
+    void onReceive(const uint8_t* data, size_t size, const SocketAddress& from) override {
+        received.push_back({ {data, data + size}, from, currentTimeMillis() });
+    }
+
+    uint64_t onPoll() override {
+        polls++;
+        if (deadline != Transport::NO_DEADLINE && currentTimeMillis() >= deadline)
+            deadline = Transport::NO_DEADLINE;
+        return deadline;
+    }
+};
+
+}
+
+void SimulatedNetworkTests::setUp() {
+}
+
+void SimulatedNetworkTests::testDelivery() {
+    SimulatedNetwork network {1, 1000000};
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000000, currentTimeMillis());
+
+    SimulatedNetwork::LinkProfile profile {};
+    profile.latency = 50;
+    network.setProfile(profile);
+
+    Receiver r1, r2;
+    auto a1 = network.bind(SocketAddress("44.0.0.1", 39001), r1);
+    auto a2 = network.bind(SocketAddress("44.0.0.2", 39001), r2);
+
+    uint8_t data[] = { 1, 2, 3, 4 };
+    CPPUNIT_ASSERT_EQUAL(4, network.send(a1, data, sizeof(data), a2));
+    CPPUNIT_ASSERT(r2.received.empty());
+
+    network.runFor(49);
+    CPPUNIT_ASSERT(r2.received.empty());
+
+    network.runFor(1);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, r2.received.size());
+    CPPUNIT_ASSERT(r2.received[0].from == a1);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000050, r2.received[0].time);
+    CPPUNIT_ASSERT(r2.received[0].data == std::vector<uint8_t>(data, data + sizeof(data)));
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1000050, network.now());
+
+    // nobody bound on the destination
+    network.send(a1, data, sizeof(data), SocketAddress("44.0.0.3", 39001));
+    network.runFor(100);
+
+    auto stats = network.getStats();
+    CPPUNIT_ASSERT_EQUAL((uint64_t)2, stats.sent);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, stats.delivered);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)1, stats.unreachable);
+    CPPUNIT_ASSERT_EQUAL((uint64_t)8, stats.bytes);
+
+    // not bound on the source
+    CPPUNIT_ASSERT_EQUAL(-1, network.send(SocketAddress("44.0.0.3", 39001), data, sizeof(data), a2));
+
+    network.unbind(a1);
+    network.unbind(a2);
+}
+
+void SimulatedNetworkTests::testLinkProfile() {
+    SimulatedNetwork network {7};
+
+    Receiver r1, r2, r3;
+    auto a1 = network.bind(SocketAddress("44.0.0.1", 39001), r1);
+    auto a2 = network.bind(SocketAddress("44.0.0.2", 39001), r2);
+    auto a3 = network.bind(SocketAddress("44.0.0.3", 39001), r3);
+
+    // 1000 bytes at 100 KB/s take 10ms on the uplink, they queue behind each other
+    SimulatedNetwork::LinkProfile slow {};
+    slow.latency = 10;
+    slow.bandwidth = 100000;
+    network.setProfile(a1, slow);
+
+    auto start = network.now();
+    std::vector<uint8_t> data(1000);
+    for (int i = 0; i < 3; i++)
+        network.send(a1, data.data(), data.size(), a2);
+    network.runFor(100);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)3, r2.received.size());
+    CPPUNIT_ASSERT_EQUAL(start + 20, r2.received[0].time);
+    CPPUNIT_ASSERT_EQUAL(start + 30, r2.received[1].time);
+    CPPUNIT_ASSERT_EQUAL(start + 40, r2.received[2].time);
+
+    // all lost
+    SimulatedNetwork::LinkProfile lossy {};
+    lossy.loss = 1.0;
+    network.setProfile(a3, lossy);
+    for (int i = 0; i < 10; i++)
+        network.send(a3, data.data(), data.size(), a2);
+    network.runFor(100);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)3, r2.received.size());
+    CPPUNIT_ASSERT_EQUAL((uint64_t)10, network.getStats().lost);
+
+    // the jitter stays in its bounds
+    SimulatedNetwork::LinkProfile jittery {};
+    jittery.latency = 30;
+    jittery.jitter = 20;
+    network.setProfile(a3, jittery);
+    start = network.now();
+    for (int i = 0; i < 100; i++)
+        network.send(a3, data.data(), data.size(), a1);
+    network.runFor(100);
+
+    CPPUNIT_ASSERT_EQUAL((size_t)100, r1.received.size());
+    for (const auto& d : r1.received) {
+        CPPUNIT_ASSERT(d.time >= start + 30);
+        CPPUNIT_ASSERT(d.time <= start + 50);
+    }
+
+    network.unbind(a1);
+    network.unbind(a2);
+    network.unbind(a3);
+}
+
+void SimulatedNetworkTests::testBind() {
+    SimulatedNetwork network {};
+
+    Receiver r1, r2;
+    auto a1 = network.bind(SocketAddress("44.0.0.1", 0), r1);
+    auto a2 = network.bind(SocketAddress("44.0.0.1", 0), r2);
+    CPPUNIT_ASSERT(a1.port() != 0);
+    CPPUNIT_ASSERT(a2.port() != 0);
+    CPPUNIT_ASSERT(a1 != a2);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, network.getNumberOfEndpoints());
+
+    CPPUNIT_ASSERT_THROW(network.bind(a1, r2), DhtError);
+
+    network.unbind(a1);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, network.getNumberOfEndpoints());
+    CPPUNIT_ASSERT(network.bind(a1, r2) == a1);
+
+    network.unbind(a1);
+    network.unbind(a2);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, network.getNumberOfEndpoints());
+}
+
+void SimulatedNetworkTests::testPoll() {
+    SimulatedNetwork network {};
+
+    Receiver r;
+    auto a = network.bind(SocketAddress("44.0.0.1", 39001), r);
+
+    auto start = network.now();
+    r.deadline = start + 1000;
+    network.wakeup(r);
+    network.runFor(0);
+    CPPUNIT_ASSERT_EQUAL(1, r.polls);
+
+    // polled again at the deadline it returned, not before
+    network.runFor(999);
+    CPPUNIT_ASSERT_EQUAL(1, r.polls);
+    network.runFor(1);
+    CPPUNIT_ASSERT_EQUAL(2, r.polls);
+
+    // the virtual clock jumps over the idle time
+    r.deadline = start + 3600 * 1000;
+    network.wakeup(r);
+    bool done = network.runUntil([&]() { return r.polls == 4; }, 24 * 3600 * 1000);
+    CPPUNIT_ASSERT(done);
+    CPPUNIT_ASSERT_EQUAL(start + 3600 * 1000, network.now());
+
+    // no polls once unbound
+    r.deadline = network.now() + 10;
+    network.wakeup(r);
+    network.unbind(a);
+    network.runFor(100);
+    CPPUNIT_ASSERT_EQUAL(4, r.polls);
+}
+
+void SimulatedNetworkTests::testNodes() {
+    const int NODES = 16;
+
+    auto dataDir = Utils::getPwdStorage("simulated_network_tests_data");
+    Utils::removeStorage(dataDir);
+
+    auto network = std::make_shared<SimulatedNetwork>(42);
+    std::vector<Sp<Node>> nodes {};
+
+    for (int i = 0; i < NODES; i++) {
+        auto b = DefaultConfiguration::Builder {};
+        b.setIPv4Address("44.0.1." + std::to_string(i + 1));
+        b.setListeningPort(39001);
+        b.setStoragePath(dataDir + Utils::PATH_SEP + "node" + std::to_string(i));
+
+        auto node = std::make_shared<Node>(b.build());
+        node->setTransport(network);
+        node->start();
+        nodes.push_back(node);
+    }
+
+    auto seed = NodeInfo {nodes[0]->getId(), SocketAddress("44.0.1.1", 39001)};
+    for (int i = 1; i < NODES; i++)
+        nodes[i]->bootstrap(seed);
+
+    // minutes of the network pass in the test in no time
+    auto wallStart = std::chrono::steady_clock::now();
+    network->runFor(5 * 60 * 1000);
+    CPPUNIT_ASSERT(std::chrono::steady_clock::now() - wallStart < std::chrono::seconds(60));
+
+    auto target = nodes[NODES - 1]->getId();
+    auto future = nodes[1]->findNode(target);
+    bool done = network->runUntil([&]() {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }, 60 * 1000);
+    CPPUNIT_ASSERT(done);
+
+    auto found = future.get();
+    CPPUNIT_ASSERT(!found.empty());
+    CPPUNIT_ASSERT(found.front()->getId() == target);
+    CPPUNIT_ASSERT(network->getStats().delivered > 0);
+
+    for (auto& node : nodes)
+        node->stop();
+    nodes.clear();
+
+    CPPUNIT_ASSERT_EQUAL((size_t)0, network->getNumberOfEndpoints());
+    Utils::removeStorage(dataDir);
+}
+
+void SimulatedNetworkTests::tearDown() {
+}
+
+}  // namespace test
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+#include "utils/metrics.h"
+#include "stage_tracer.h"
+#include "stage_tracer_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(StageTracerTests);
+
+void StageTracerTests::setUp() {
+}
+
+void StageTracerTests::testHistograms() {
+    auto& histogram = Metrics::histogram("carrier_rpc_stage_seconds", "", {
+            { "stage", "storage" }, { "method", "store_value" } }, 1e-9);
+    auto count = histogram.count();
+
+    auto start = StageTracer::now();
+    StageTracer::record(StageTracer::Stage::STORAGE, Message::Method::STORE_VALUE, start, start + 5000);
+    {
+        StageTracer::Span span(StageTracer::Stage::STORAGE, Message::Method::STORE_VALUE);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(count + 2, histogram.count());
+    CPPUNIT_ASSERT(histogram.sum() >= 5000);
+}
+
+void StageTracerTests::testChromeTrace() {
+    auto start = StageTracer::now();
+    StageTracer::record(StageTracer::Stage::DECRYPT, Message::Method::FIND_NODE, start, start + 2000);
+    StageTracer::record(StageTracer::Stage::PARSE, Message::Method::FIND_NODE, start + 2000, start + 3000);
+
+    std::stringstream ss;
+    StageTracer::dumpChromeTrace(ss);
+    auto trace = nlohmann::json::parse(ss.str());
+
+    auto& events = trace["traceEvents"];
+    CPPUNIT_ASSERT(events.is_array());
+    CPPUNIT_ASSERT(events.size() >= 2);
+
+    // the latest events are last
+    auto& decrypt = events[events.size() - 2];
+    auto& parse = events[events.size() - 1];
+    CPPUNIT_ASSERT_EQUAL(std::string("decrypt"), decrypt["name"].get<std::string>());
+    CPPUNIT_ASSERT_EQUAL(std::string("find_node"), decrypt["cat"].get<std::string>());
+    CPPUNIT_ASSERT_EQUAL(std::string("X"), decrypt["ph"].get<std::string>());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, decrypt["dur"].get<double>(), 1e-9);
+    CPPUNIT_ASSERT_EQUAL(std::string("parse"), parse["name"].get<std::string>());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(decrypt["ts"].get<double>() + 2.0, parse["ts"].get<double>(), 1e-6);
+    CPPUNIT_ASSERT_EQUAL(decrypt["tid"].get<int>(), parse["tid"].get<int>());
+}
+
+void StageTracerTests::tearDown() {
+}
+
+}  // namespace test
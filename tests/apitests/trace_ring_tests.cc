@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+#include <cstring>
+
+#include "utils/trace_ring.h"
+#include "trace_ring_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(TraceRingTests);
+
+static const uint8_t ADDRESS[4] = { 192, 168, 1, 1 };
+
+void TraceRingTests::setUp() {
+}
+
+void TraceRingTests::testRecord() {
+    TraceRing ring(3);
+    CPPUNIT_ASSERT_EQUAL((size_t)4, ring.capacity());
+    CPPUNIT_ASSERT(ring.snapshot().empty());
+
+    ring.record(TraceRing::Direction::SENT, 0x22, 0x12345678, 120, 2, ADDRESS, sizeof(ADDRESS), 39001);
+    ring.record(TraceRing::Direction::RECEIVED, 0x42, 0x12345678, 100000, 2, ADDRESS, sizeof(ADDRESS), 39001);
+
+    auto records = ring.snapshot();
+    CPPUNIT_ASSERT_EQUAL((size_t)2, records.size());
+
+    auto& r = records.front();
+    CPPUNIT_ASSERT(TraceRing::Direction::SENT == r.direction);
+    CPPUNIT_ASSERT_EQUAL((uint8_t)0x22, r.type);
+    CPPUNIT_ASSERT_EQUAL((int32_t)0x12345678, r.txid);
+    CPPUNIT_ASSERT_EQUAL((uint16_t)120, r.size);
+    CPPUNIT_ASSERT_EQUAL((uint16_t)39001, r.port);
+    CPPUNIT_ASSERT_EQUAL((uint8_t)sizeof(ADDRESS), r.addressLength);
+    CPPUNIT_ASSERT(std::memcmp(ADDRESS, r.address, sizeof(ADDRESS)) == 0);
+    CPPUNIT_ASSERT(r.timestamp > 0);
+
+    // the size saturates
+    CPPUNIT_ASSERT(TraceRing::Direction::RECEIVED == records.back().direction);
+    CPPUNIT_ASSERT_EQUAL((uint16_t)UINT16_MAX, records.back().size);
+    CPPUNIT_ASSERT(records.back().timestamp >= r.timestamp);
+}
+
+void TraceRingTests::testOverwrite() {
+    TraceRing ring(8);
+    for (int i = 0; i < 20; i++)
+        ring.record(TraceRing::Direction::SENT, 0x21, i, 64, 2, ADDRESS, sizeof(ADDRESS), 39001);
+
+    CPPUNIT_ASSERT_EQUAL((uint64_t)20, ring.recorded());
+
+    // only the latest records are kept, oldest first
+    auto records = ring.snapshot();
+    CPPUNIT_ASSERT_EQUAL((size_t)8, records.size());
+    for (int i = 0; i < 8; i++)
+        CPPUNIT_ASSERT_EQUAL(12 + i, records[i].txid);
+}
+
+void TraceRingTests::testWriters() {
+    const int WRITERS = 4;
+    const int COUNT = 100000;
+    TraceRing ring(1024);
+
+    std::vector<std::thread> writers {};
+    for (int w = 0; w < WRITERS; w++) {
+        writers.emplace_back([&, w]() {
+            for (int i = 0; i < COUNT; i++)
+                ring.record(TraceRing::Direction::RECEIVED, 0x41, w * COUNT + i, w, 2, ADDRESS, sizeof(ADDRESS), w);
+        });
+    }
+
+    // the snapshots taken while writing never see a torn record
+    for (int round = 0; round < 100; round++) {
+        for (auto& r : ring.snapshot()) {
+            CPPUNIT_ASSERT_EQUAL((int)r.size, r.txid / COUNT);
+            CPPUNIT_ASSERT_EQUAL(r.port, r.size);
+        }
+    }
+
+    for (auto& writer : writers)
+        writer.join();
+
+    CPPUNIT_ASSERT_EQUAL((uint64_t)WRITERS * COUNT, ring.recorded());
+    CPPUNIT_ASSERT_EQUAL(ring.capacity(), ring.snapshot().size());
+}
+
+void TraceRingTests::tearDown() {
+}
+
+}  // namespace test
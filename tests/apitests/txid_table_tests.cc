@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <set>
+#include <map>
+#include <random>
+
+#include "utils/txid_table.h"
+#include "txid_table_tests.h"
+
+using namespace elastos::carrier;
+
+namespace test {
+CPPUNIT_TEST_SUITE_REGISTRATION(TxidTableTests);
+
+void TxidTableTests::setUp() {
+}
+
+void TxidTableTests::testInsertFindRemove() {
+    TxidTable<int> table(16);
+
+    std::map<int, int> txids {};
+    for (int i = 1; i <= 8; i++) {
+        int txid = table.insert(i);
+        CPPUNIT_ASSERT(txid > 0);
+        CPPUNIT_ASSERT(txids.find(txid) == txids.end());
+        txids[txid] = i;
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)8, table.size());
+
+    for (auto& [txid, value] : txids) {
+        auto found = table.find(txid);
+        CPPUNIT_ASSERT(found != nullptr);
+        CPPUNIT_ASSERT_EQUAL(value, *found);
+    }
+
+    CPPUNIT_ASSERT(table.find(0) == nullptr);
+    CPPUNIT_ASSERT(table.find(-1) == nullptr);
+
+    for (auto& [txid, value] : txids) {
+        CPPUNIT_ASSERT(table.remove(txid));
+        CPPUNIT_ASSERT(!table.remove(txid));
+        CPPUNIT_ASSERT(table.find(txid) == nullptr);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)0, table.size());
+}
+
+void TxidTableTests::testStaleTxid() {
+    TxidTable<int> table(16);
+
+    // keep reusing the slots, a removed txid never matches a later entry
+    std::set<int> stale {};
+    for (int i = 0; i < 10000; i++) {
+        int txid = table.insert(i);
+        CPPUNIT_ASSERT(stale.find(txid) == stale.end());
+
+        CPPUNIT_ASSERT(table.remove(txid));
+        CPPUNIT_ASSERT(table.find(txid) == nullptr);
+        stale.insert(txid);
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)16, table.capacity());
+}
+
+void TxidTableTests::testGrow() {
+    TxidTable<int> table(16);
+    std::mt19937 random(3);
+
+    std::map<int, int> live {};
+    std::set<int> issued {};
+    for (int i = 0; i < 5000; i++) {
+        if (!live.empty() && random() % 3 == 0) {
+            auto it = live.begin();
+            std::advance(it, random() % live.size());
+            CPPUNIT_ASSERT(table.remove(it->first));
+            live.erase(it);
+        } else {
+            int txid = table.insert(i);
+            CPPUNIT_ASSERT(issued.insert(txid).second);
+            live[txid] = i;
+        }
+    }
+
+    CPPUNIT_ASSERT(table.capacity() >= live.size() * 2);
+    CPPUNIT_ASSERT_EQUAL(live.size(), table.size());
+    for (auto& [txid, value] : live) {
+        auto found = table.find(txid);
+        CPPUNIT_ASSERT(found != nullptr);
+        CPPUNIT_ASSERT_EQUAL(value, *found);
+    }
+}
+
+void TxidTableTests::tearDown() {
+}
+
+}  // namespace test
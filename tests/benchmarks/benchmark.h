@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <chrono>
+#include <functional>
+
+namespace test {
+
+class BenchmarkContext {
+public:
+    BenchmarkContext(const std::string& name, const std::map<std::string, std::string>& params, int duration)
+        : name(name), params(params), duration(duration) {}
+
+    const std::string& getName() const {
+        return name;
+    }
+
+    // Seconds every measurement of the benchmark is expected to run
+    int getDuration() const {
+        return duration;
+    }
+
+    std::string getParam(const std::string& key, const std::string& def) const {
+        auto it = params.find(key);
+        return it != params.end() ? it->second : def;
+    }
+
+    int getParam(const std::string& key, int def) const {
+        auto it = params.find(key);
+        return it != params.end() ? std::stoi(it->second) : def;
+    }
+
+    std::vector<int> getParamList(const std::string& key, const std::vector<int>& def) const;
+
+    void report(const std::string& metric, double value, const std::string& unit = "");
+
+    struct Metric {
+        std::string name;
+        double value;
+        std::string unit;
+    };
+
+    const std::list<Metric>& getMetrics() const {
+        return metrics;
+    }
+
+private:
+    std::string name;
+    std::map<std::string, std::string> params;
+    int duration;
+    std::list<Metric> metrics {};
+};
+
+class Benchmarks {
+public:
+    using Body = std::function<void(BenchmarkContext&)>;
+
+    static Benchmarks& get();
+
+    void add(const std::string& name, Body body) {
+        bodies.emplace(name, body);
+    }
+
+    const std::map<std::string, Body>& all() const {
+        return bodies;
+    }
+
+private:
+    std::map<std::string, Body> bodies {};
+};
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const std::string& name, Benchmarks::Body body) {
+        Benchmarks::get().add(name, body);
+    }
+};
+
+#define CARRIER_BENCHMARK(name) \
+    static void name(test::BenchmarkContext&); \
+    static test::BenchmarkRegistration name##_registration(#name, name); \
+    static void name(test::BenchmarkContext& ctx)
+
+class Stopwatch {
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    void reset() {
+        start = std::chrono::steady_clock::now();
+    }
+
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    uint64_t elapsedNanos() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Prevents the compiler from optimizing out the benchmarked expression
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/*
+ * Calls the body in batches for the duration of the benchmark, after a
+ * warm up batch, and returns the nanoseconds per call.
+ */
+template <typename Body>
+double measureNanos(const BenchmarkContext& ctx, Body&& body, int batch = 1000) {
+    for (int i = 0; i < batch; i++)
+        body();
+
+    uint64_t calls = 0;
+    Stopwatch sw;
+    while (sw.elapsedSeconds() < ctx.getDuration()) {
+        for (int i = 0; i < batch; i++)
+            body();
+        calls += batch;
+    }
+
+    return (double)sw.elapsedNanos() / calls;
+}
+
+}  // namespace test
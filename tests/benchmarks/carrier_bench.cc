@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <signal.h>
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+
+#include "utils/log.h"
+#include "dht.h"
+#include "routing_table.h"
+#include "benchmark.h"
+#include "loopback.h"
+
+using namespace test;
+
+/*
+ * carrier-bench: a load generator against a local cluster. N nodes listen on
+ * 127.0.0.1, 127.0.0.2, ... (or on 127.0.0.1 with consecutive ports), learn
+ * each other before the run, then random nodes issue a weighted mix of the
+ * node API operations at a fixed open loop rate. The throughput and the
+ * latency percentiles of each operation are printed in JSON, for tracking
+ * the regressions across builds.
+ *
+ * The DHT only keeps the loopback addresses in the routing tables of the
+ * development builds, configure with -DENABLE_CARRIER_DEVELOPMENT=TRUE.
+ */
+
+enum BenchOperation {
+    FIND_NODE,
+    FIND_VALUE,
+    STORE_VALUE,
+    FIND_PEER,
+    ANNOUNCE_PEER,
+    OPERATIONS
+};
+
+static const char* OPERATION_NAMES[OPERATIONS] = {
+    "find_node", "find_value", "store_value", "find_peer", "announce_peer"
+};
+
+struct Options {
+    int nodes {16};
+    int port {39100};
+    bool singleAddress {false};
+    int rate {50};
+    int duration {30};
+    int warmup {5};
+    int concurrency {256};
+    std::string mix {"find_node=40,find_value=20,store_value=10,find_peer=20,announce_peer=10"};
+    std::string output {};
+    std::string logLevel {"warn"};
+    unsigned seed {42};
+};
+
+static Options parseArgs(int argc, char **argv)
+{
+    Options options;
+
+    CLI::App app("Elastos Carrier cluster load benchmark", "carrier-bench");
+    app.add_option("-n, --nodes", options.nodes, "Number of the nodes of the cluster");
+    app.add_option("-p, --port", options.port, "Listening port of the first node");
+    app.add_flag("--single-address", options.singleAddress, "Run all the nodes on 127.0.0.1 with consecutive ports");
+    app.add_option("-r, --rate", options.rate, "Operations started per second");
+    app.add_option("-d, --duration", options.duration, "Seconds of the measured run");
+    app.add_option("-w, --warmup", options.warmup, "Seconds of the load before the measurement");
+    app.add_option("-c, --concurrency", options.concurrency, "Maximum operations in flight, the others are dropped");
+    app.add_option("-m, --mix", options.mix, "Weights of the operations, as name=weight,...");
+    app.add_option("-o, --output", options.output, "Write the JSON results to the file instead of stdout");
+    app.add_option("--log-level", options.logLevel, "Log level of the nodes");
+    app.add_option("--seed", options.seed, "Seed of the random operations");
+
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::Error &e) {
+        int rc = app.exit(e);
+        std::exit(rc);
+    }
+
+    return options;
+}
+
+static std::vector<int> parseMix(const std::string& mix)
+{
+    std::vector<int> weights(OPERATIONS, 0);
+    std::stringstream ss(mix);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        auto pos = item.find('=');
+        auto name = item.substr(0, pos);
+        auto op = std::find(OPERATION_NAMES, OPERATION_NAMES + OPERATIONS, name) - OPERATION_NAMES;
+        if (pos == std::string::npos || op == OPERATIONS)
+            throw std::invalid_argument("Invalid operation mix: " + item);
+        weights[op] = std::stoi(item.substr(pos + 1));
+    }
+
+    if (std::accumulate(weights.begin(), weights.end(), 0) <= 0)
+        throw std::invalid_argument("Empty operation mix");
+    return weights;
+}
+
+/*
+ * The latencies of the completed operations, in microseconds.
+ */
+struct LatencyStats {
+    std::vector<uint64_t> samples {};
+    uint64_t errors {0};
+
+    uint64_t percentile(double p) const {
+        if (samples.empty())
+            return 0;
+        auto index = (size_t)std::ceil(p / 100.0 * samples.size());
+        return samples[std::clamp(index, (size_t)1, samples.size()) - 1];
+    }
+
+    nlohmann::json toJson(double seconds) {
+        std::sort(samples.begin(), samples.end());
+        auto mean = samples.empty() ? 0.0 :
+                std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        return {
+            {"completed", samples.size()},
+            {"errors", errors},
+            {"throughput", samples.size() / seconds},
+            {"latency_ms", {
+                {"mean", mean / 1000.0},
+                {"p50", percentile(50) / 1000.0},
+                {"p99", percentile(99) / 1000.0},
+                {"p999", percentile(99.9) / 1000.0},
+                {"max", (samples.empty() ? 0 : samples.back()) / 1000.0}
+            }}
+        };
+    }
+};
+
+class LoadGenerator {
+public:
+    LoadGenerator(std::vector<std::unique_ptr<LoopbackNode>>& nodes, const std::vector<int>& weights,
+            int concurrency, unsigned seed)
+        : nodes(nodes), weights(weights.begin(), weights.end()), concurrency(concurrency), random(seed) {}
+
+    // Issues the operations at the rate for the seconds, measured unless warming up
+    void run(int rate, int seconds, bool measured);
+
+    void drain(int seconds);
+
+    nlohmann::json report(double seconds);
+
+    uint64_t getDropped() const {
+        return dropped;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        BenchOperation op;
+        Clock::time_point start;
+        bool measured;
+        std::function<bool()> done;     // true once completed, throws on failure
+    };
+
+    void issue(bool measured);
+    void collect();
+
+    template <typename T>
+    std::function<bool()> waitFor(std::future<T> future) {
+        auto shared = std::make_shared<std::future<T>>(std::move(future));
+        return [shared]() {
+            if (shared->wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+            shared->get();
+            return true;
+        };
+    }
+
+    std::vector<std::unique_ptr<LoopbackNode>>& nodes;
+    std::discrete_distribution<int> weights;
+    int concurrency;
+    std::mt19937 random;
+
+    std::vector<Id> values {};
+    std::vector<Id> peers {};
+
+    std::list<Pending> pending {};
+    LatencyStats stats[OPERATIONS] {};
+    uint64_t dropped {0};
+};
+
+void LoadGenerator::issue(bool measured)
+{
+    if ((int)pending.size() >= concurrency) {
+        if (measured)
+            dropped++;
+        return;
+    }
+
+    auto op = (BenchOperation)weights(random);
+    auto& node = nodes[std::uniform_int_distribution<size_t>(0, nodes.size() - 1)(random)]->get();
+    auto start = Clock::now();
+    std::function<bool()> done;
+
+    switch (op) {
+    case FIND_NODE:
+        done = waitFor(node.findNode(Id::random()));
+        break;
+
+    case FIND_VALUE: {
+        auto id = values.empty() ? Id::random() : values[random() % values.size()];
+        done = waitFor(node.findValue(id));
+        break;
+    }
+
+    case STORE_VALUE: {
+        std::vector<uint8_t> data(64);
+        std::generate(data.begin(), data.end(), [this]() { return (uint8_t)random(); });
+        auto value = Value::createValue(data);
+        values.push_back(value.getId());
+        done = waitFor(node.storeValue(value));
+        break;
+    }
+
+    case FIND_PEER: {
+        auto id = peers.empty() ? Id::random() : peers[random() % peers.size()];
+        done = waitFor(node.findPeer(id, 1));
+        break;
+    }
+
+    case ANNOUNCE_PEER: {
+        auto peer = PeerInfo::create(node.getId(), 8000 + random() % 1000);
+        peers.push_back(peer.getId());
+        done = waitFor(node.announcePeer(peer));
+        break;
+    }
+
+    default:
+        return;
+    }
+
+    pending.push_back({op, start, measured, std::move(done)});
+}
+
+void LoadGenerator::collect()
+{
+    for (auto it = pending.begin(); it != pending.end();) {
+        bool completed;
+        bool failed = false;
+        try {
+            completed = it->done();
+        } catch (const std::exception&) {
+            completed = true;
+            failed = true;
+        }
+
+        if (!completed) {
+            ++it;
+            continue;
+        }
+
+        if (it->measured) {
+            auto& s = stats[it->op];
+            if (failed)
+                s.errors++;
+            else
+                s.samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - it->start).count());
+        }
+        it = pending.erase(it);
+    }
+}
+
+void LoadGenerator::run(int rate, int seconds, bool measured)
+{
+    auto start = Clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    uint64_t issued = 0;
+
+    // open loop, the operations start on their schedule whatever the latency
+    while (Clock::now() < end) {
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        while (issued < elapsed * rate) {
+            issue(measured);
+            issued++;
+        }
+
+        collect();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void LoadGenerator::drain(int seconds)
+{
+    auto end = Clock::now() + std::chrono::seconds(seconds);
+    while (!pending.empty() && Clock::now() < end) {
+        collect();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+nlohmann::json LoadGenerator::report(double seconds)
+{
+    LatencyStats overall {};
+    auto operations = nlohmann::json::object();
+    for (int op = 0; op < OPERATIONS; op++) {
+        auto& s = stats[op];
+        overall.samples.insert(overall.samples.end(), s.samples.begin(), s.samples.end());
+        overall.errors += s.errors;
+        if (!s.samples.empty() || s.errors > 0)
+            operations[OPERATION_NAMES[op]] = s.toJson(seconds);
+    }
+
+    auto result = overall.toJson(seconds);
+    result["dropped"] = dropped;
+    result["unfinished"] = pending.size();
+    result["operations"] = operations;
+    return result;
+}
+
+static int routingTableSize(LoopbackNode& node)
+{
+    auto dht = node.get().getDHT(DHT::Type::IPV4);
+    return dht != nullptr ? dht->getRoutingTable().getNumBucketEntries() : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    auto options = parseArgs(argc, argv);
+
+    std::vector<int> weights;
+    try {
+        weights = parseMix(options.mix);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (options.nodes < 2 || options.rate <= 0 || options.duration <= 0) {
+        std::cerr << "Needs 2 nodes or more, a positive rate and duration" << std::endl;
+        return 1;
+    }
+
+#ifdef SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    Logger::setLogLevel(options.logLevel);
+
+    std::vector<std::unique_ptr<LoopbackNode>> nodes {};
+    for (int i = 0; i < options.nodes; i++) {
+        auto ip = options.singleAddress ? std::string("127.0.0.1") : "127.0.0." + std::to_string(i + 1);
+        int port = options.singleAddress ? options.port + i : options.port;
+        nodes.push_back(std::make_unique<LoopbackNode>(ip, port));
+    }
+
+    // every node learns the others before the load starts
+    for (auto& node : nodes) {
+        for (auto& other : nodes) {
+            if (node != other)
+                node->get().bootstrap(NodeInfo {other->getId(), other->getAddress()});
+        }
+    }
+
+    int expected = std::min(options.nodes - 1, 8);
+    Stopwatch sw;
+    while (sw.elapsedSeconds() < 30) {
+        bool ready = std::all_of(nodes.begin(), nodes.end(), [&](auto& node) {
+            return routingTableSize(*node) >= expected;
+        });
+        if (ready)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    int populated = std::numeric_limits<int>::max();
+    for (auto& node : nodes)
+        populated = std::min(populated, routingTableSize(*node));
+    if (populated == 0) {
+        std::cerr << "The routing tables stay empty, the loopback addresses need a build with "
+                  << "ENABLE_CARRIER_DEVELOPMENT" << std::endl;
+        return 1;
+    }
+
+    LoadGenerator generator(nodes, weights, options.concurrency, options.seed);
+    if (options.warmup > 0)
+        generator.run(options.rate, options.warmup, false);
+
+    sw.reset();
+    generator.run(options.rate, options.duration, true);
+    double seconds = sw.elapsedSeconds();
+    generator.drain(30);
+
+    auto result = generator.report(seconds);
+    nlohmann::json report = {
+        {"benchmark", "carrier-bench"},
+        {"nodes", options.nodes},
+        {"routing_table_min", populated},
+        {"rate", options.rate},
+        {"duration", seconds},
+        {"concurrency", options.concurrency},
+        {"mix", options.mix},
+        {"seed", options.seed},
+        {"results", result}
+    };
+
+    if (options.output.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.output);
+        out << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
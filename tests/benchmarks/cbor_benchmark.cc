@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <carrier.h>
+
+#include "messages/message.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+#include "messages/find_peer_response.h"
+#include "messages/store_value_request.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+static std::list<Sp<NodeInfo>> benchmarkNodes(int count, bool ipv6) {
+    std::list<Sp<NodeInfo>> nodes {};
+    for (int i = 0; i < count; i++)
+        nodes.push_back(std::make_shared<NodeInfo>(Id::random(),
+                ipv6 ? "2001:db8::1" : "192.168.1.1", 39001 + i));
+    return nodes;
+}
+
+/*
+ * Encoding and decoding the common DHT messages: the streaming CBOR codec
+ * against the JSON DOM round trip the messages used before, which decoded
+ * every packet into a nlohmann::json tree and encoded one for every reply.
+ * The DOM figures cover the CBOR part only, not the fields conversion.
+ *   -p rounds=20000
+ */
+CARRIER_BENCHMARK(cbor_message_codec) {
+    int rounds = ctx.getParam("rounds", 20000);
+
+    auto findNode = std::make_shared<FindNodeRequest>(Id::random(), true);
+    findNode->setTxid(0x12345678);
+    findNode->setWant4(true);
+
+    auto nodes = std::make_shared<FindNodeResponse>(0x12345678);
+    nodes->setNodes4(benchmarkNodes(8, false));
+    nodes->setNodes6(benchmarkNodes(8, true));
+    nodes->setToken(0x7654321);
+
+    auto peers = std::make_shared<FindPeerResponse>(0x12345678);
+    peers->setNodes4(benchmarkNodes(8, false));
+    std::list<PeerInfo> list {};
+    auto keypair = Signature::KeyPair::random();
+    for (int i = 0; i < 8; i++)
+        list.push_back(PeerInfo::create(keypair, Id::random(), 39001 + i));
+    peers->setPeers(list);
+
+    auto store = std::make_shared<StoreValueRequest>(Value::createSignedValue(std::vector<uint8_t>(1024, 'D')), 0x7654321);
+    store->setTxid(0x12345678);
+
+    std::list<std::pair<std::string, Sp<Message>>> messages {
+        { "find_node", findNode },
+        { "find_node_response", nodes },
+        { "find_peer_response", peers },
+        { "store_value", store }
+    };
+
+    for (auto& [name, msg] : messages) {
+        auto encoded = msg->serialize();
+
+        std::vector<uint8_t> buffer {};
+        buffer.reserve(msg->estimateSize());
+        Stopwatch sw;
+        for (int round = 0; round < rounds; round++) {
+            buffer.clear();
+            msg->serialize(buffer);
+            doNotOptimize(buffer.data());
+        }
+        double serializeNanos = (double)sw.elapsedNanos() / rounds;
+
+        sw.reset();
+        for (int round = 0; round < rounds; round++) {
+            auto parsed = Message::parse(encoded.data(), encoded.size());
+            doNotOptimize(parsed);
+        }
+        double parseNanos = (double)sw.elapsedNanos() / rounds;
+
+        auto json = nlohmann::json::from_cbor(encoded);
+        sw.reset();
+        for (int round = 0; round < rounds; round++) {
+            buffer.clear();
+            nlohmann::json::to_cbor(json, buffer);
+            doNotOptimize(buffer.data());
+        }
+        double domSerializeNanos = (double)sw.elapsedNanos() / rounds;
+
+        sw.reset();
+        for (int round = 0; round < rounds; round++) {
+            auto root = nlohmann::json::from_cbor(encoded);
+            doNotOptimize(root);
+        }
+        double domParseNanos = (double)sw.elapsedNanos() / rounds;
+
+        ctx.report(name + "_bytes", encoded.size(), "B");
+        ctx.report(name + "_serialize_ns", serializeNanos, "ns");
+        ctx.report(name + "_parse_ns", parseNanos, "ns");
+        ctx.report(name + "_dom_serialize_ns", domSerializeNanos, "ns");
+        ctx.report(name + "_dom_parse_ns", domParseNanos, "ns");
+        ctx.report(name + "_parse_speedup", domParseNanos / parseNanos);
+        ctx.report(name + "_parse_mb_per_s", encoded.size() * 1000.0 / parseNanos, "MB/s");
+    }
+}
+
+}  // namespace test
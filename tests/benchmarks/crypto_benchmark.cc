@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include <carrier.h>
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * The crypto of every packet and of the signed records: the CryptoBox
+ * encryption and decryption of a payload with the precomputed shared key
+ * of two nodes, and the Ed25519 signing and verification of one.
+ *   -p size=64,512,1280
+ */
+CARRIER_BENCHMARK(crypto_primitives) {
+    auto sizes = ctx.getParamList("size", {64, 512, 1280});
+
+    CryptoBox::KeyPair alice {};
+    CryptoBox::KeyPair bob {};
+    CryptoBox box(bob.publicKey(), alice.privateKey());
+    auto nonce = CryptoBox::Nonce::random();
+
+    auto keypair = Signature::KeyPair::random();
+
+    for (auto size : sizes) {
+        std::vector<uint8_t> plain(size, 'D');
+        auto cipher = box.encrypt(plain, nonce);
+        auto signature = keypair.privateKey().sign(plain);
+
+        std::vector<uint8_t> cipherBuffer(cipher.size());
+        std::vector<uint8_t> plainBuffer(plain.size());
+        Blob cipherOut(cipherBuffer);
+        Blob plainOut(plainBuffer);
+
+        auto prefix = "size_" + std::to_string(size);
+        auto encryptNanos = measureNanos(ctx, [&]() {
+            box.encrypt(cipherOut, plain, nonce);
+            doNotOptimize(cipherBuffer.data());
+        });
+        auto decryptNanos = measureNanos(ctx, [&]() {
+            box.decrypt(plainOut, cipher, nonce);
+            doNotOptimize(plainBuffer.data());
+        });
+
+        ctx.report(prefix + "_encrypt_ns", encryptNanos, "ns");
+        ctx.report(prefix + "_decrypt_ns", decryptNanos, "ns");
+        ctx.report(prefix + "_encrypt_mb_per_s", size * 1000.0 / encryptNanos, "MB/s");
+
+        ctx.report(prefix + "_sign_ns", measureNanos(ctx, [&]() {
+            doNotOptimize(keypair.privateKey().sign(plain));
+        }, 100), "ns");
+        ctx.report(prefix + "_verify_ns", measureNanos(ctx, [&]() {
+            doNotOptimize(keypair.publicKey().verify(plain, signature));
+        }, 100), "ns");
+    }
+}
+
+}  // namespace test
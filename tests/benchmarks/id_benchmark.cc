@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+
+#include <carrier.h>
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * The Id primitives on the routing and lookup paths: the XOR distance, the
+ * distance comparison that orders the lookup candidates, and the base58
+ * and hex codecs of the ids in the logs, the storage and the APIs. Cycles
+ * through a set of random ids so the branches don't settle on one input.
+ *   -p ids=1024
+ */
+CARRIER_BENCHMARK(id_primitives) {
+    int count = ctx.getParam("ids", 1024);
+
+    std::vector<Id> ids {};
+    std::vector<std::string> base58 {};
+    std::vector<std::string> hex {};
+    for (int i = 0; i < count; i++) {
+        ids.push_back(Id::random());
+        base58.push_back(ids.back().toBase58String());
+        hex.push_back(ids.back().toHexString());
+    }
+
+    auto target = Id::random();
+    size_t i = 0;
+    auto next = [&]() {
+        i = (i + 1) % ids.size();
+        return i;
+    };
+
+    ctx.report("distance_ns", measureNanos(ctx, [&]() {
+        auto n = next();
+        doNotOptimize(ids[n].distance(target));
+    }), "ns");
+
+    ctx.report("three_way_compare_ns", measureNanos(ctx, [&]() {
+        auto n = next();
+        doNotOptimize(target.threeWayCompare(ids[n], ids[(n + 1) % ids.size()]));
+    }), "ns");
+
+    ctx.report("base58_encode_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(ids[next()].toBase58String());
+    }), "ns");
+
+    ctx.report("base58_decode_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(Id::ofBase58(base58[next()]));
+    }), "ns");
+
+    ctx.report("hex_encode_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(ids[next()].toHexString());
+    }), "ns");
+
+    ctx.report("hex_decode_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(Id::ofHex(hex[next()]));
+    }), "ns");
+}
+
+}  // namespace test
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <vector>
+#include <queue>
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+#include "constants.h"
+#include "rtt_estimator.h"
+#include "response_timeout_filter.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * Discrete event simulation of lookups against a population of nodes with
+ * spread out round trip times and a share of dead nodes. A lookup keeps up
+ * to MAX_CONCURRENT_TASK_REQUESTS non-stalled calls in flight and completes
+ * after k responses or once only stalled calls are left.
+ */
+class LookupSimulation {
+public:
+    enum class Policy {
+        Legacy,     // the call holds its request slot until it times out
+        Fixed,      // stall after RPC_CALL_STALL_TIMEOUT
+        Adaptive    // stall after the per node or the global RTT estimate
+    };
+
+    LookupSimulation(Policy policy, int nodes, double deadRatio, unsigned seed)
+        : policy(policy), random(seed), estimators(nodes) {
+        std::bernoulli_distribution dead(deadRatio);
+        std::lognormal_distribution<double> rtt(std::log(80.0), 0.8);
+        for (int i = 0; i < nodes; i++) {
+            alive.push_back(!dead(random));
+            baseRtt.push_back(std::clamp(rtt(random), 5.0, 3000.0));
+        }
+    }
+
+    // returns the completion time of the lookup in milliseconds
+    uint64_t lookup(int candidates, int k) {
+        std::uniform_int_distribution<int> pick(0, (int)alive.size() - 1);
+        std::uniform_real_distribution<double> jitter(0.8, 1.5);
+
+        struct Call {
+            int node;
+            uint64_t sent;
+            bool stalled;
+            bool finished;
+        };
+
+        struct Event {
+            uint64_t time;
+            int call;
+            bool response;
+            bool operator>(const Event& other) const { return time > other.time; }
+        };
+
+        std::vector<Call> calls {};
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events {};
+        uint64_t now = 0;
+        int active = 0;
+        int responses = 0;
+
+        auto send = [&]() {
+            int node = pick(random);
+            int id = (int)calls.size();
+            calls.push_back({node, now, false, false});
+            active++;
+
+            events.push({now + stallTimeout(node), id, false});
+            if (alive[node]) {
+                auto rtt = (uint64_t)(baseRtt[node] * jitter(random));
+                if (rtt < (uint64_t)Constants::RPC_CALL_TIMEOUT_MAX)
+                    events.push({now + rtt, id, true});
+            }
+        };
+
+        int sent = 0;
+        while (active < Constants::MAX_CONCURRENT_TASK_REQUESTS && sent < candidates) {
+            send();
+            sent++;
+        }
+
+        while (!events.empty()) {
+            auto event = events.top();
+            events.pop();
+            now = event.time;
+
+            auto& call = calls[event.call];
+            if (call.finished)
+                continue;
+
+            if (event.response) {
+                call.finished = true;
+                if (!call.stalled)
+                    active--;
+                responses++;
+
+                int rtt = (int)(now - call.sent);
+                estimators[call.node].update(rtt);
+                filter.update(rtt);
+            } else {
+                if (call.stalled)
+                    continue;
+                call.stalled = true;
+                active--;
+            }
+
+            if (responses >= k)
+                break;
+
+            while (active < Constants::MAX_CONCURRENT_TASK_REQUESTS && sent < candidates) {
+                send();
+                sent++;
+            }
+
+            if (active == 0 && sent >= candidates)
+                break;
+        }
+
+        return now;
+    }
+
+private:
+    int stallTimeout(int node) const {
+        switch (policy) {
+        case Policy::Legacy:
+            return Constants::RPC_CALL_TIMEOUT_MAX;
+        case Policy::Fixed:
+            return Constants::RPC_CALL_STALL_TIMEOUT;
+        default:
+            if (estimators[node].hasSamples())
+                return estimators[node].getTimeout(Constants::RPC_CALL_TIMEOUT_BASELINE_MIN,
+                        Constants::RPC_CALL_TIMEOUT_MAX);
+            return filter.getStallTimeout();
+        }
+    }
+
+    Policy policy;
+    std::mt19937 random;
+    std::vector<bool> alive {};
+    std::vector<double> baseRtt {};
+    std::vector<RTTEstimator> estimators;
+    ResponseTimeoutFilter filter {};
+};
+
+/*
+ * Lookup completion times with the legacy, the fixed 2s and the adaptive
+ * RTT based stall timers, simulated, no network involved.
+ *   -p nodes=5000 -p dead=30 (percent) -p lookups=2000 -p candidates=64 -p k=8
+ */
+CARRIER_BENCHMARK(lookup_rtt_simulation) {
+    int nodes = ctx.getParam("nodes", 5000);
+    int dead = ctx.getParam("dead", 30);
+    int lookups = ctx.getParam("lookups", 2000);
+    int candidates = ctx.getParam("candidates", 64);
+    int k = ctx.getParam("k", 8);
+    unsigned seed = ctx.getParam("seed", 42);
+
+    std::vector<std::pair<std::string, LookupSimulation::Policy>> policies {
+        {"legacy", LookupSimulation::Policy::Legacy},
+        {"fixed", LookupSimulation::Policy::Fixed},
+        {"adaptive", LookupSimulation::Policy::Adaptive}
+    };
+
+    double legacyMean = 0;
+    for (const auto& [name, policy] : policies) {
+        // same population and candidate choices for every policy
+        LookupSimulation sim(policy, nodes, dead / 100.0, seed);
+
+        // warm up the estimators
+        for (int i = 0; i < lookups / 10; i++)
+            sim.lookup(candidates, k);
+
+        std::vector<uint64_t> times {};
+        for (int i = 0; i < lookups; i++)
+            times.push_back(sim.lookup(candidates, k));
+        std::sort(times.begin(), times.end());
+
+        double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        ctx.report(name + "_mean_ms", mean, "ms");
+        ctx.report(name + "_p50_ms", times[times.size() / 2], "ms");
+        ctx.report(name + "_p90_ms", times[times.size() * 9 / 10], "ms");
+        ctx.report(name + "_p99_ms", times[times.size() * 99 / 100], "ms");
+
+        if (policy == LookupSimulation::Policy::Legacy)
+            legacyMean = mean;
+        else
+            ctx.report(name + "_speedup", legacyMean / mean, "x");
+    }
+}
+
+}  // namespace test
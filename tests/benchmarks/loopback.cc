@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+#include "messages/ping_request.h"
+#include "crypto_context.h"
+#include "constants.h"
+#include "utils.h"
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+LoopbackNode::LoopbackNode(const std::string& ip, int port, Customizer customize) {
+    storagePath = Utils::getPwdStorage("benchmarks") + Utils::PATH_SEP + ip + "-" + std::to_string(port);
+    Utils::removeStorage(storagePath);
+
+    auto builder = DefaultConfiguration::Builder {};
+    builder.setIPv4Address(ip);
+    builder.setListeningPort(port);
+    builder.setStoragePath(storagePath);
+    builder.setRPCAdmissionControl(false);
+    if (customize)
+        customize(builder);
+
+    node = std::make_shared<Node>(builder.build());
+    node->start();
+    address = SocketAddress(ip, port);
+}
+
+LoopbackNode::~LoopbackNode() {
+    node->stop();
+    node.reset();
+    Utils::removeStorage(storagePath);
+}
+
+// Serializes and encrypts a PING request the way a node sends it
+static void buildPing(const Id& sender, const CryptoContext& ctx, int txid, std::vector<uint8_t>& packet) {
+    static thread_local auto shortName = Constants::NODE_SHORT_NAME;
+
+    auto request = std::make_shared<PingRequest>();
+    request->setTxid(txid);
+    request->setVersion(Version::build(shortName, Constants::NODE_VERSION));
+
+    auto plain = request->serialize();
+    auto cipher = ctx.encrypt({plain});
+    packet.resize(ID_BYTES + cipher.size());
+    std::memcpy(packet.data(), sender.data(), ID_BYTES);
+    std::memcpy(packet.data() + ID_BYTES, cipher.data(), cipher.size());
+}
+
+static void closeSocket(int sock) {
+#if defined(_WIN32) || defined(_WIN64)
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+void PingFlooder::client(int seconds) {
+    auto keyPair = Signature::KeyPair::random();
+    auto id = Id(keyPair.publicKey());
+    auto ctx = CryptoContext(CryptoBox::PublicKey::fromSignatureKey(*target.toKey()),
+            CryptoBox::KeyPair::fromSignatureKeyPair(keyPair));
+
+    int sock = socket(address.family(), SOCK_DGRAM, 0);
+    if (sock < 0)
+        return;
+
+    struct timeval tv {0, 10000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (char*)&tv, sizeof(tv));
+
+    std::vector<uint8_t> packet {};
+    std::array<uint8_t, 1500> buf;
+    int txid = 1;
+    int outstanding = 0;
+    uint64_t paced = 0;
+
+    Stopwatch sw;
+    while (sw.elapsedSeconds() < seconds) {
+        while (outstanding < window) {
+            if (rate > 0 && paced >= sw.elapsedSeconds() * rate)
+                break;
+
+            buildPing(id, ctx, txid++, packet);
+            if (sendto(sock, (char*)packet.data(), packet.size(), 0, address.addr(), address.length()) < 0)
+                break;
+
+            sent++;
+            paced++;
+            outstanding++;
+        }
+
+        auto rc = recv(sock, (char*)buf.data(), buf.size(), 0);
+        if (rc > 0) {
+            received++;
+            outstanding--;
+        } else {
+            // assume the outstanding requests were dropped
+            outstanding = 0;
+        }
+    }
+
+    closeSocket(sock);
+}
+
+double PingFlooder::run(int seconds) {
+    sent = 0;
+    received = 0;
+
+    std::vector<std::thread> threads {};
+    Stopwatch sw;
+    for (int i = 0; i < clients; i++)
+        threads.emplace_back(&PingFlooder::client, this, seconds);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return received / sw.elapsedSeconds();
+}
+
+SybilFlooder::SybilFlooder(const Id& target, const SocketAddress& address, const std::string& source,
+        int attackers, int identities, int garbagePercent)
+        : address(address), source(source), attackers(attackers) {
+    auto targetKey = CryptoBox::PublicKey::fromSignatureKey(*target.toKey());
+
+    packets.resize(identities);
+    for (int i = 0; i < identities; i++) {
+        auto keyPair = Signature::KeyPair::random();
+        auto id = Id(keyPair.publicKey());
+
+        if (i * 100 < garbagePercent * identities) {
+            auto garbage = Utils::getRandomData(64);
+            packets[i].resize(ID_BYTES + garbage.size());
+            std::memcpy(packets[i].data(), id.data(), ID_BYTES);
+            std::memcpy(packets[i].data() + ID_BYTES, garbage.data(), garbage.size());
+        } else {
+            auto ctx = CryptoContext(targetKey, CryptoBox::KeyPair::fromSignatureKeyPair(keyPair));
+            buildPing(id, ctx, i + 1, packets[i]);
+        }
+    }
+}
+
+void SybilFlooder::attacker(int seconds, size_t first) {
+    auto bindAddr = SocketAddress(source, 0);
+    int sock = socket(bindAddr.family(), SOCK_DGRAM, 0);
+    if (sock < 0)
+        return;
+
+    if (bind(sock, bindAddr.addr(), bindAddr.length()) < 0) {
+        closeSocket(sock);
+        return;
+    }
+
+    Stopwatch sw;
+    size_t i = first;
+    while (sw.elapsedSeconds() < seconds) {
+        // check the clock every few hundred packets only
+        for (int n = 0; n < 256; n++) {
+            // interleave the garbage and the valid ones
+            const auto& packet = packets[(i * 7919) % packets.size()];
+            i++;
+            if (sendto(sock, (char*)packet.data(), packet.size(), 0, address.addr(), address.length()) > 0)
+                sent++;
+        }
+    }
+
+    closeSocket(sock);
+}
+
+double SybilFlooder::run(int seconds) {
+    sent = 0;
+
+    std::vector<std::thread> threads {};
+    Stopwatch sw;
+    for (int i = 0; i < attackers; i++)
+        threads.emplace_back(&SybilFlooder::attacker, this, seconds, i * packets.size() / attackers);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return sent / sw.elapsedSeconds();
+}
+
+}  // namespace test
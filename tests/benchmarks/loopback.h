@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include <carrier.h>
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * A node listening on the loopback interface, the storage is removed
+ * when the node is destroyed. The admission control is off unless the
+ * customizer enables it, the flooders would be rate limited otherwise.
+ */
+class LoopbackNode {
+public:
+    using Customizer = std::function<void(DefaultConfiguration::Builder&)>;
+
+    LoopbackNode(const std::string& ip, int port, Customizer customize = {});
+    ~LoopbackNode();
+
+    Node& get() {
+        return *node;
+    }
+
+    const Id& getId() const {
+        return node->getId();
+    }
+
+    const SocketAddress& getAddress() const {
+        return address;
+    }
+
+private:
+    Sp<Node> node {};
+    SocketAddress address {};
+    std::string storagePath {};
+};
+
+/*
+ * Floods a node with encrypted PING requests from a number of client
+ * sockets, each one keeps a window of outstanding requests. A non-zero
+ * rate paces each client to that many requests per second.
+ */
+class PingFlooder {
+public:
+    PingFlooder(const Id& target, const SocketAddress& address, int clients = 4, int window = 64, int rate = 0)
+        : target(target), address(address), clients(clients), window(window), rate(rate) {}
+
+    // Returns the PING responses received per second
+    double run(int seconds);
+
+    uint64_t getSent() const {
+        return sent;
+    }
+
+    uint64_t getReceived() const {
+        return received;
+    }
+
+private:
+    void client(int seconds);
+
+    Id target;
+    SocketAddress address;
+    int clients;
+    int window;
+    int rate;
+
+    std::atomic<uint64_t> sent {0};
+    std::atomic<uint64_t> received {0};
+};
+
+/*
+ * Floods a node from one source address the way tests/sybil_attacher does,
+ * the packets claim the ids of a pool of sybil identities. The valid PING
+ * requests cost the node a key derivation and a decryption each, the rest
+ * are garbage which fails to decrypt. The packets are built up front, the
+ * attackers only send.
+ */
+class SybilFlooder {
+public:
+    SybilFlooder(const Id& target, const SocketAddress& address, const std::string& source = "127.0.0.2",
+            int attackers = 2, int identities = 4096, int garbagePercent = 50);
+
+    // Returns the packets sent per second
+    double run(int seconds);
+
+    uint64_t getSent() const {
+        return sent;
+    }
+
+private:
+    void attacker(int seconds, size_t first);
+
+    SocketAddress address;
+    std::string source;
+    int attackers;
+
+    std::vector<std::vector<uint8_t>> packets {};
+    std::atomic<uint64_t> sent {0};
+};
+
+}  // namespace test
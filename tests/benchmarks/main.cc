@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+#include <stddef.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+
+#include "benchmark.h"
+
+using namespace test;
+
+struct Options {
+    std::vector<std::string> benchmarks {};
+    std::vector<std::string> params {};
+    int duration {5};
+    bool json {false};
+    bool list {false};
+};
+
+static Options parseArgs(int argc, char **argv)
+{
+    Options options;
+
+    CLI::App app("Elastos Carrier benchmarks", "benchmarks");
+    app.add_option("-b, --benchmark", options.benchmarks, "Benchmarks to run, all benchmarks by default");
+    app.add_option("-p, --param", options.params, "Benchmark parameter as key=value");
+    app.add_option("-d, --duration", options.duration, "Seconds of each measurement");
+    app.add_flag("-j, --json", options.json, "Print the results in JSON");
+    app.add_flag("-l, --list", options.list, "List the available benchmarks");
+
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::Error &e) {
+        int rc = app.exit(e);
+        std::exit(rc);
+    }
+
+    return options;
+}
+
+int main(int argc, char* argv[])
+{
+    auto options = parseArgs(argc, argv);
+    const auto& all = Benchmarks::get().all();
+
+    if (options.list) {
+        for (const auto& [name, body] : all)
+            std::cout << name << std::endl;
+        return 0;
+    }
+
+    std::map<std::string, std::string> params {};
+    for (const auto& param : options.params) {
+        auto pos = param.find('=');
+        if (pos == std::string::npos) {
+            std::cout << "Invalid parameter: " << param << std::endl;
+            return 1;
+        }
+        params[param.substr(0, pos)] = param.substr(pos + 1);
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+#ifdef SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    auto results = nlohmann::json::array();
+    int rc = 0;
+
+    for (const auto& [name, body] : all) {
+        if (!options.benchmarks.empty() &&
+                std::find(options.benchmarks.begin(), options.benchmarks.end(), name) == options.benchmarks.end())
+            continue;
+
+        BenchmarkContext ctx(name, params, options.duration);
+        try {
+            if (!options.json)
+                std::cout << "Running " << name << " ..." << std::endl;
+            body(ctx);
+        } catch (const std::exception& e) {
+            std::cerr << "Benchmark " << name << " failed: " << e.what() << std::endl;
+            rc = 1;
+            continue;
+        }
+
+        auto metrics = nlohmann::json::object();
+        for (const auto& metric : ctx.getMetrics()) {
+            if (!options.json)
+                std::cout << "  " << metric.name << ": " << metric.value << " " << metric.unit << std::endl;
+            metrics[metric.name] = metric.value;
+        }
+        results.push_back({{"name", name}, {"metrics", metrics}});
+    }
+
+    if (options.json)
+        std::cout << results.dump(2) << std::endl;
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    return rc;
+}
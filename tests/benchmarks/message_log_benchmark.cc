@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+
+#include <carrier.h>
+
+#include "utils/log.h"
+#include "utils/trace_ring.h"
+#include "messages/message.h"
+#include "messages/find_node_response.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * Per packet cost of the message logging on the RPC hot path with the
+ * debug records disabled: the message formatted eagerly as the argument,
+ * the same record with the lazy formatter, and the binary trace ring.
+ *   -p rounds=100000
+ */
+CARRIER_BENCHMARK(message_log_disabled) {
+    int rounds = ctx.getParam("rounds", 100000);
+
+    auto log = Logger::get("MessageLogBenchmark");
+    log->setLevel(Level::Info);
+
+    std::list<Sp<NodeInfo>> nodes {};
+    for (int i = 0; i < 8; i++)
+        nodes.push_back(std::make_shared<NodeInfo>(Id::random(), "192.168.1.1", 39001 + i));
+
+    auto msg = std::make_shared<FindNodeResponse>(0x12345678);
+    msg->setNodes4(nodes);
+    msg->setToken(0x7654321);
+    auto peer = SocketAddress("192.168.1.1", 39001);
+
+    Stopwatch sw;
+    for (int round = 0; round < rounds; round++)
+        log->debug("Received {}/{} from {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
+                peer.toString(), 400, static_cast<std::string>(*msg));
+    ctx.report("eager_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+    sw.reset();
+    for (int round = 0; round < rounds; round++) {
+        if (log->isDebugEnabled())
+            log->debug("Received {}/{} from {}: [{}] {}", msg->getMethodString(), msg->getTypeString(),
+                    peer.toString(), 400, *msg);
+    }
+    ctx.report("lazy_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+    TraceRing ring(4096);
+    sw.reset();
+    for (int round = 0; round < rounds; round++)
+        ring.record(TraceRing::Direction::RECEIVED, (uint8_t)msg->getTypeBits(), msg->getTxid(), 400,
+                (uint8_t)peer.family(), peer.inaddr(), peer.inaddrLength(), peer.port());
+    ctx.report("trace_ring_ns", (double)sw.elapsedNanos() / rounds, "ns");
+}
+
+}  // namespace test
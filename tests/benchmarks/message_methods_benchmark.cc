@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+
+#include <carrier.h>
+
+#include "messages/message.h"
+#include "messages/error_message.h"
+#include "messages/ping_request.h"
+#include "messages/ping_response.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+#include "messages/find_value_request.h"
+#include "messages/find_value_response.h"
+#include "messages/store_value_request.h"
+#include "messages/store_value_response.h"
+#include "messages/find_peer_request.h"
+#include "messages/find_peer_response.h"
+#include "messages/announce_peer_request.h"
+#include "messages/announce_peer_response.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+static std::list<Sp<NodeInfo>> methodNodes(int count) {
+    std::list<Sp<NodeInfo>> nodes {};
+    for (int i = 0; i < count; i++)
+        nodes.push_back(std::make_shared<NodeInfo>(Id::random(), "192.168.1.1", 39001 + i));
+    return nodes;
+}
+
+/*
+ * Serializing and parsing the request, the response and the error of
+ * every RPC method, with full lists of nodes in the lookup responses.
+ *   -p nodes=8
+ */
+CARRIER_BENCHMARK(message_methods) {
+    int nodes = ctx.getParam("nodes", 8);
+
+    auto keypair = Signature::KeyPair::random();
+    auto value = Value::createSignedValue(std::vector<uint8_t>(256, 'D'));
+    auto peer = PeerInfo::create(keypair, Id::random(), 39001);
+
+    auto ping = std::make_shared<PingRequest>();
+    auto pong = std::make_shared<PingResponse>(0x12345678);
+
+    auto findNode = std::make_shared<FindNodeRequest>(Id::random(), true);
+    findNode->setWant4(true);
+    auto findNodeResponse = std::make_shared<FindNodeResponse>(0x12345678);
+    findNodeResponse->setNodes4(methodNodes(nodes));
+    findNodeResponse->setToken(0x7654321);
+
+    auto findValue = std::make_shared<FindValueRequest>(value.getId());
+    findValue->setWant4(true);
+    auto findValueResponse = std::make_shared<FindValueResponse>(0x12345678);
+    findValueResponse->setValue(value);
+
+    auto storeValue = std::make_shared<StoreValueRequest>(value, 0x7654321);
+    auto storeValueResponse = std::make_shared<StoreValueResponse>(0x12345678);
+
+    auto findPeer = std::make_shared<FindPeerRequest>(peer.getId());
+    findPeer->setWant4(true);
+    auto findPeerResponse = std::make_shared<FindPeerResponse>(0x12345678);
+    findPeerResponse->setNodes4(methodNodes(nodes));
+    findPeerResponse->setPeers({ peer });
+
+    auto announcePeer = std::make_shared<AnnouncePeerRequest>(peer, 0x7654321);
+    auto announcePeerResponse = std::make_shared<AnnouncePeerResponse>(0x12345678);
+
+    auto error = std::make_shared<ErrorMessage>(Message::Method::FIND_VALUE, 0x12345678,
+            203, "Invalid token for STORE VALUE request");
+
+    std::list<std::pair<std::string, Sp<Message>>> messages {
+        { "ping", ping },
+        { "ping_response", pong },
+        { "find_node", findNode },
+        { "find_node_response", findNodeResponse },
+        { "find_value", findValue },
+        { "find_value_response", findValueResponse },
+        { "store_value", storeValue },
+        { "store_value_response", storeValueResponse },
+        { "find_peer", findPeer },
+        { "find_peer_response", findPeerResponse },
+        { "announce_peer", announcePeer },
+        { "announce_peer_response", announcePeerResponse },
+        { "error", error }
+    };
+
+    std::vector<uint8_t> buffer {};
+    for (auto& [name, msg] : messages) {
+        msg->setTxid(0x12345678);
+        auto encoded = msg->serialize();
+        buffer.reserve(msg->estimateSize());
+
+        ctx.report(name + "_bytes", encoded.size(), "B");
+        ctx.report(name + "_serialize_ns", measureNanos(ctx, [&]() {
+            buffer.clear();
+            msg->serialize(buffer);
+            doNotOptimize(buffer.data());
+        }), "ns");
+        ctx.report(name + "_parse_ns", measureNanos(ctx, [&]() {
+            doNotOptimize(Message::parse(encoded.data(), encoded.size()));
+        }), "ns");
+    }
+}
+
+}  // namespace test
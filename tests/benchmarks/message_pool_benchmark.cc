@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+
+#include <carrier.h>
+
+#include "messages/message.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+#include "task/closest_candidates.h"
+#include "utils/object_pool.h"
+
+#include "benchmark.h"
+#include "alloc_counter.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * One round of a node lookup without the sockets and the crypto: for every
+ * concurrent request the responder parses the FIND_NODE request and builds
+ * its response, the requester parses the response and adds the nodes to
+ * the lookup candidates. Counts the heap allocations per round with the
+ * messages and nodes from the object pools and straight from the heap.
+ *   -p requests=10 -p nodes=8
+ */
+CARRIER_BENCHMARK(message_pool_lookup_round) {
+    int requests = ctx.getParam("requests", Constants::MAX_CONCURRENT_TASK_REQUESTS);
+    int nodes = ctx.getParam("nodes", Constants::MAX_ENTRIES_PER_BUCKET);
+
+    auto target = Id::random();
+    auto request = std::make_shared<FindNodeRequest>(target);
+    request->setTxid(0x12345678);
+    request->setWant4(true);
+    auto encodedRequest = request->serialize();
+
+    // every responder returns its own closest nodes
+    std::vector<std::list<Sp<NodeInfo>>> closest(requests);
+    for (auto& list : closest) {
+        for (int i = 0; i < nodes; i++)
+            list.push_back(std::make_shared<NodeInfo>(Id::random(), SocketAddress("192.168.1.1", 39001 + i)));
+    }
+
+    std::vector<uint8_t> buffer {};
+    buffer.reserve(Constants::RPC_PACKET_BUFFER_SIZE);
+
+    auto round = [&]() {
+        ClosestCandidates candidates(target, Constants::MAX_ENTRIES_PER_BUCKET * 3);
+        for (const auto& list : closest) {
+            auto received = Message::parse(encodedRequest.data(), encodedRequest.size());
+            auto response = makePooled<FindNodeResponse>(received->getTxid());
+            response->setNodes4(list);
+            buffer.clear();
+            response->serialize(buffer);
+
+            auto msg = Message::parse(buffer.data(), buffer.size());
+            candidates.add(std::static_pointer_cast<FindNodeResponse>(msg)->getNodes4());
+        }
+        doNotOptimize(candidates.size());
+    };
+
+    auto parse = [&]() {
+        auto msg = Message::parse(buffer.data(), buffer.size());
+        doNotOptimize(msg);
+    };
+
+    for (bool pooled : { false, true }) {
+        BlockPool::setEnabled(pooled);
+        std::string prefix = pooled ? "pooled" : "heap";
+
+        // warm up the pools and the allocator
+        for (int i = 0; i < 100; i++)
+            round();
+
+        uint64_t rounds = 0;
+        uint64_t allocations = AllocationCounter::count();
+        Stopwatch sw;
+        while (sw.elapsedSeconds() < ctx.getDuration()) {
+            for (int i = 0; i < 100; i++)
+                round();
+            rounds += 100;
+        }
+
+        auto nanos = sw.elapsedNanos();
+        allocations = AllocationCounter::count() - allocations;
+        ctx.report(prefix + "_ns_per_round", (double)nanos / rounds, "ns");
+        ctx.report(prefix + "_allocations_per_round", (double)allocations / rounds);
+
+        // the share of parsing one response
+        allocations = AllocationCounter::count();
+        for (int i = 0; i < 1000; i++)
+            parse();
+        allocations = AllocationCounter::count() - allocations;
+        ctx.report(prefix + "_allocations_per_response_parse", (double)allocations / 1000);
+    }
+
+    BlockPool::setEnabled(true);
+}
+
+}  // namespace test
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "utils/metrics.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * Cost of the metrics updated on the packet path: a counter increment and a
+ * histogram record, from one thread and from several threads sharing them.
+ *   -p rounds=1000000 -p threads=4
+ */
+CARRIER_BENCHMARK(metrics_update) {
+    int rounds = ctx.getParam("rounds", 1000000);
+    int threads = ctx.getParam("threads", 4);
+
+    auto& counter = Metrics::counter("benchmark_metrics_total", "Benchmark counter");
+    auto& histogram = Metrics::histogram("benchmark_metrics_seconds", "Benchmark histogram", {}, 1e-6);
+
+    Stopwatch sw;
+    for (int round = 0; round < rounds; round++)
+        counter.inc();
+    ctx.report("counter_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+    sw.reset();
+    for (int round = 0; round < rounds; round++)
+        histogram.record(round & 0xffff);
+    ctx.report("histogram_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+    std::vector<std::thread> workers {};
+    sw.reset();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            for (int round = 0; round < rounds; round++) {
+                counter.inc();
+                histogram.record(round & 0xffff);
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    ctx.report("contended_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+    sw.reset();
+    auto text = Metrics::scrape();
+    doNotOptimize(text.data());
+    ctx.report("scrape_us", sw.elapsedNanos() / 1000.0, "us");
+    ctx.report("scrape_bytes", text.size(), "B");
+}
+
+}  // namespace test
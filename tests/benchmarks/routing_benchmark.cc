@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+
+#include <carrier.h>
+
+#include "constants.h"
+#include "dht.h"
+#include "routing_table.h"
+#include "kbucket.h"
+#include "kbucket_entry.h"
+#include "kclosest_nodes.h"
+#include "task/closest_candidates.h"
+#include "task/candidate_node.h"
+
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+static SocketAddress entryAddress(int i) {
+    auto ip = "10." + std::to_string((i >> 16) & 0xFF) + "." + std::to_string((i >> 8) & 0xFF)
+            + "." + std::to_string(i & 0xFF);
+    return SocketAddress(ip, 39001);
+}
+
+/*
+ * The routing table and the lookup candidates: building a table from the
+ * given number of reachable entries, finding the bucket of an id, filling
+ * the K closest nodes of a target from the table, and one lookup worth of
+ * ClosestCandidates, adding the responses and taking the next candidate
+ * until none is left. The table belongs to a DHT that is never started, so
+ * the node maintenance doesn't run against it.
+ *   -p entries=1000 -p responses=10
+ */
+CARRIER_BENCHMARK(routing_primitives) {
+    int count = ctx.getParam("entries", 1000);
+    int responses = ctx.getParam("responses", Constants::MAX_CONCURRENT_TASK_REQUESTS);
+    int port = ctx.getParam("port", 39171);
+
+    LoopbackNode node("127.0.0.1", port);
+    DHT dht(DHT::Type::IPV4, node.get(), node.getAddress());
+
+    std::vector<Sp<KBucketEntry>> entries {};
+    for (int i = 0; i < count; i++) {
+        auto entry = std::make_shared<KBucketEntry>(Id::random(), entryAddress(i));
+        entry->signalResponse();
+        entries.push_back(entry);
+    }
+
+    std::vector<Id> targets {};
+    for (int i = 0; i < 1024; i++)
+        targets.push_back(Id::random());
+    size_t next = 0;
+    auto target = [&]() -> const Id& {
+        next = (next + 1) % targets.size();
+        return targets[next];
+    };
+
+    uint64_t puts = 0;
+    Stopwatch sw;
+    while (sw.elapsedSeconds() < ctx.getDuration()) {
+        RoutingTable table(dht);
+        for (const auto& entry : entries)
+            table.put(entry);
+        doNotOptimize(table.size());
+        puts += entries.size();
+    }
+    ctx.report("put_ns", (double)sw.elapsedNanos() / puts, "ns");
+
+    auto& table = dht.getRoutingTable();
+    for (const auto& entry : entries)
+        table.put(entry);
+    ctx.report("buckets", table.size());
+    ctx.report("bucket_entries", table.getNumBucketEntries());
+
+    ctx.report("get_bucket_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(table.getBucket(target()));
+    }), "ns");
+
+    ctx.report("kclosest_fill_ns", measureNanos(ctx, [&]() {
+        KClosestNodes closest(dht, target(), Constants::MAX_ENTRIES_PER_BUCKET);
+        closest.fill();
+        doNotOptimize(closest.size());
+    }, 100), "ns");
+
+    // the closest nodes every responder of a lookup returns
+    auto lookupTarget = Id::random();
+    std::vector<std::list<Sp<NodeInfo>>> lists(responses);
+    int i = count;
+    for (auto& list : lists) {
+        for (int n = 0; n < Constants::MAX_ENTRIES_PER_BUCKET; n++, i++)
+            list.push_back(std::make_shared<NodeInfo>(Id::random(), entryAddress(i)));
+    }
+
+    uint64_t adds = 0, nexts = 0;
+    uint64_t addNanos = 0, nextNanos = 0;
+    sw.reset();
+    while (sw.elapsedSeconds() < ctx.getDuration()) {
+        ClosestCandidates candidates(lookupTarget, Constants::MAX_ENTRIES_PER_BUCKET * 3);
+
+        Stopwatch phase;
+        for (const auto& list : lists)
+            candidates.add(list);
+        addNanos += phase.elapsedNanos();
+        adds += lists.size();
+
+        phase.reset();
+        for (auto candidate = candidates.next(); candidate != nullptr; candidate = candidates.next()) {
+            candidate->setSent();
+            nexts++;
+        }
+        nextNanos += phase.elapsedNanos();
+    }
+    ctx.report("candidates_add_ns", (double)addNanos / adds, "ns");
+    ctx.report("candidates_next_ns", nexts ? (double)nextNanos / nexts : 0.0, "ns");
+}
+
+}  // namespace test
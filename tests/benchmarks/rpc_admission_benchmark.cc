@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+/*
+ * Legitimate PING traffic served while sybil attackers flood the node from
+ * another loopback address, with the admission control off (0) and on (1).
+ * Half of the flood are valid requests from the rotating sybil ids, half
+ * are undecryptable garbage.
+ *   -p admission=0,1 -p attackers=2 -p identities=4096 -p garbage=50
+ *   -p clients=4 -p rate=100
+ */
+CARRIER_BENCHMARK(rpc_admission_flood) {
+    auto modes = ctx.getParamList("admission", {0, 1});
+    int attackers = ctx.getParam("attackers", 2);
+    int identities = ctx.getParam("identities", 4096);
+    int garbage = ctx.getParam("garbage", 50);
+    int clients = ctx.getParam("clients", 4);
+    int rate = ctx.getParam("rate", 100);
+    int port = ctx.getParam("port", 39401);
+
+    for (auto enabled : modes) {
+        LoopbackNode server("127.0.0.1", port++, [=](DefaultConfiguration::Builder& builder) {
+            builder.setRPCAdmissionControl(enabled != 0);
+        });
+
+        SybilFlooder flooder(server.getId(), server.getAddress(), "127.0.0.2", attackers, identities, garbage);
+        PingFlooder legitimate(server.getId(), server.getAddress(), clients, 8, rate);
+
+        double floodRate = 0;
+        std::thread attack([&]() {
+            floodRate = flooder.run(ctx.getDuration());
+        });
+        auto pps = legitimate.run(ctx.getDuration());
+        attack.join();
+
+        auto prefix = "admission_" + std::to_string(enabled);
+        ctx.report(prefix + "_legitimate_responses_per_second", pps, "packets/s");
+        ctx.report(prefix + "_legitimate_success_ratio",
+                legitimate.getSent() ? (double)legitimate.getReceived() / legitimate.getSent() : 0.0);
+        ctx.report(prefix + "_flood_packets_per_second", floodRate, "packets/s");
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+/*
+ * Loopback PING throughput of the RPC server decrypting on the receiving
+ * threads (0) or on a pool of crypto workers, with and without receive
+ * workers in front of them.
+ *   -p crypto=0,1,2,4 -p workers=0,2 -p clients=4 -p window=64
+ */
+CARRIER_BENCHMARK(rpc_crypto_workers) {
+    auto cryptoCounts = ctx.getParamList("crypto", {0, 1, 2, 4});
+    auto workerCounts = ctx.getParamList("workers", {0, 2});
+    int clients = ctx.getParam("clients", 4);
+    int window = ctx.getParam("window", 64);
+    int port = ctx.getParam("port", 39301);
+
+    for (auto workers : workerCounts) {
+        for (auto crypto : cryptoCounts) {
+            LoopbackNode server("127.0.0.1", port++, [=](DefaultConfiguration::Builder& builder) {
+                builder.setRPCWorkers(workers);
+                builder.setRPCCryptoWorkers(crypto);
+            });
+
+            PingFlooder flooder(server.getId(), server.getAddress(), clients, window);
+            auto pps = flooder.run(ctx.getDuration());
+
+            auto prefix = "workers_" + std::to_string(workers) + "_crypto_" + std::to_string(crypto);
+            ctx.report(prefix + "_packets_per_second", pps, "packets/s");
+            ctx.report(prefix + "_loss_ratio",
+                    flooder.getSent() ? 1.0 - (double)flooder.getReceived() / flooder.getSent() : 0.0);
+        }
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+/*
+ * Loopback PING throughput of the RPC server with the socket I/O and the
+ * io_uring backend, the library must be built with ENABLE_IO_URING. The
+ * server falls back to the socket I/O if io_uring is unavailable.
+ *   -p clients=4 -p window=64 -p batch=0
+ */
+CARRIER_BENCHMARK(rpc_io_uring) {
+    int clients = ctx.getParam("clients", 4);
+    int window = ctx.getParam("window", 64);
+    int batch = ctx.getParam("batch", 0);
+    int port = ctx.getParam("port", 39141);
+
+    double baseline = 0;
+    for (bool ioUring : {false, true}) {
+        LoopbackNode server("127.0.0.1", port++, [=](DefaultConfiguration::Builder& builder) {
+            builder.setRPCBatchSize(batch);
+            builder.setRPCIoUring(ioUring);
+        });
+
+        PingFlooder flooder(server.getId(), server.getAddress(), clients, window);
+        auto pps = flooder.run(ctx.getDuration());
+
+        std::string prefix = ioUring ? "io_uring" : "socket";
+        ctx.report(prefix + "_packets_per_second", pps, "packets/s");
+
+        if (!ioUring)
+            baseline = pps;
+        else if (baseline > 0)
+            ctx.report("io_uring_speedup", pps / baseline, "x");
+    }
+}
+
+}  // namespace test
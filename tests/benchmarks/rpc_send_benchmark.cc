@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <stdexcept>
+
+#include <carrier.h>
+
+#include "messages/ping_request.h"
+#include "messages/find_node_response.h"
+#include "utils/buffer_pool.h"
+#include "rpcserver.h"
+
+#include "benchmark.h"
+#include "alloc_counter.h"
+#include "loopback.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+// Returns the allocations of the calling thread, the node's own threads keep running meanwhile
+static uint64_t measure(BenchmarkContext& ctx, const std::string& prefix, const std::function<void()>& send) {
+    // warm up the crypto context, the pool and the allocator
+    for (int i = 0; i < 1000; i++)
+        send();
+
+    uint64_t iterations = 0;
+    uint64_t allocations = AllocationCounter::threadCount();
+    Stopwatch sw;
+    while (sw.elapsedSeconds() < ctx.getDuration()) {
+        for (int i = 0; i < 1000; i++)
+            send();
+        iterations += 1000;
+    }
+
+    auto nanos = sw.elapsedNanos();
+    allocations = AllocationCounter::threadCount() - allocations;
+
+    ctx.report(prefix + "_ns_per_packet", (double)nanos / iterations, "ns");
+    ctx.report(prefix + "_allocations_per_packet", (double)allocations / iterations);
+    return allocations;
+}
+
+/*
+ * Builds outbound packets (serialize, encrypt, prepend the sender id) the
+ * old way with three vectors and with the pooled in-place pipeline, and
+ * counts the heap allocations per packet. The serialize_only numbers are
+ * the share of the message serializer. Fails if the pooled pipeline
+ * allocates anything once warmed up.
+ *   -p nodes=8
+ */
+CARRIER_BENCHMARK(rpc_send_pipeline) {
+    int nodes = ctx.getParam("nodes", 8);
+    int port = ctx.getParam("port", 39161);
+
+    LoopbackNode node("127.0.0.1", port);
+    auto peer = Id(Signature::KeyPair::random().publicKey());
+    auto peerAddress = SocketAddress("127.0.0.1", port + 1);
+
+    auto ping = std::make_shared<PingRequest>();
+    auto response = std::make_shared<FindNodeResponse>(1);
+    std::list<Sp<NodeInfo>> closest {};
+    for (int i = 0; i < nodes; i++)
+        closest.push_back(std::make_shared<NodeInfo>(Id::random(), SocketAddress("192.168.1.1", 39001 + i)));
+    response->setNodes4(closest);
+
+    BufferPool pool(16, Constants::RPC_PACKET_BUFFER_SIZE);
+    std::vector<uint8_t> scratch {};
+    scratch.reserve(Constants::RPC_PACKET_BUFFER_SIZE);
+
+    for (auto [name, msg] : std::initializer_list<std::pair<std::string, Sp<Message>>> {
+            {"ping", ping}, {"find_node_response", response}}) {
+        msg->setId(node.getId());
+        msg->setTxid(1);
+        msg->setVersion(1);
+        msg->setRemote(peer, peerAddress);
+
+        measure(ctx, name + "_legacy", [&]() {
+            auto buffer = msg->serialize();
+            auto encrypted = node.get().encrypt(msg->getRemoteId(), {buffer});
+            buffer.resize(ID_BYTES + encrypted.size());
+            std::memcpy(buffer.data(), msg->getId().data(), ID_BYTES);
+            std::memcpy(buffer.data() + ID_BYTES, encrypted.data(), encrypted.size());
+            doNotOptimize(buffer);
+        });
+
+        auto allocations = measure(ctx, name + "_pooled", [&]() {
+            auto packet = pool.acquire();
+            RPCServer::encodePacket(node.get(), *msg, packet);
+            doNotOptimize(packet);
+            pool.release(std::move(packet));
+        });
+        if (allocations != 0)
+            throw std::runtime_error("The pooled " + name + " packets allocated " +
+                    std::to_string(allocations) + " times after the warm up");
+
+        measure(ctx, name + "_serialize_only", [&]() {
+            scratch.clear();
+            msg->serialize(scratch);
+            doNotOptimize(scratch);
+        });
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "benchmark.h"
+#include "loopback.h"
+
+namespace test {
+
+/*
+ * Loopback PING throughput of the RPC server with different numbers of
+ * receive workers, 0 is the single-threaded receive path.
+ *   -p workers=0,1,2,4 -p clients=4 -p window=64
+ */
+CARRIER_BENCHMARK(rpc_receive_workers) {
+    auto workerCounts = ctx.getParamList("workers", {0, 1, 2, 4});
+    int clients = ctx.getParam("clients", 4);
+    int window = ctx.getParam("window", 64);
+    int port = ctx.getParam("port", 39101);
+
+    for (auto workers : workerCounts) {
+        LoopbackNode server("127.0.0.1", port++, [=](DefaultConfiguration::Builder& builder) {
+            builder.setRPCWorkers(workers);
+        });
+
+        PingFlooder flooder(server.getId(), server.getAddress(), clients, window);
+        auto pps = flooder.run(ctx.getDuration());
+
+        auto prefix = "workers_" + std::to_string(workers);
+        ctx.report(prefix + "_packets_per_second", pps, "packets/s");
+        ctx.report(prefix + "_loss_ratio",
+                flooder.getSent() ? 1.0 - (double)flooder.getReceived() / flooder.getSent() : 0.0);
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <map>
+#include <vector>
+#include <random>
+
+#include <carrier.h>
+
+#include "utils/time.h"
+#include "scheduler.h"
+
+#include "benchmark.h"
+#include "alloc_counter.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * The multimap based scheduler replaced by the timing wheel, kept here as
+ * the baseline.
+ */
+class MultimapScheduler {
+public:
+    class Job {
+    public:
+        Job(std::function<void()>&& f) : do_(std::move(f)) {}
+
+        void cancel() {
+            do_ = {};
+            fixedDelay = 0;
+        }
+
+        explicit operator bool() const {
+            return (bool)do_;
+        }
+
+        void operator()() const {
+            do_();
+        }
+
+    private:
+        std::function<void()> do_;
+        long fixedDelay = 0;
+        friend class MultimapScheduler;
+    };
+
+    Sp<Job> add(std::function<void()>&& job_func, long delay, long fixedDelay = 0) {
+        auto job = std::make_shared<Job>(std::move(job_func));
+        job->fixedDelay = fixedDelay;
+        timers.emplace(currentTimeMillis() + delay, job);
+        return job;
+    }
+
+    uint64_t run() {
+        while (!timers.empty()) {
+            auto timer = timers.begin();
+            if (timer->first > now)
+                break;
+
+            auto job = std::move(timer->second);
+            if (*job)
+                (*job)();
+            timers.erase(timer);
+        }
+        return timers.empty() ? std::numeric_limits<uint64_t>::max() : timers.begin()->first;
+    }
+
+    size_t size() const {
+        return timers.size();
+    }
+
+    void syncTime(uint64_t n) {
+        now = n;
+    }
+
+private:
+    uint64_t now {currentTimeMillis()};
+    std::multimap<uint64_t, Sp<Job>> timers {};
+};
+
+/*
+ * The RPC call pattern: arm a stall timer per call, most of them are
+ * cancelled by the response and the rest expire.
+ */
+template <typename S>
+static void measure(BenchmarkContext& ctx, const std::string& prefix, int timers, int rounds) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<long> delays(100, 10000);
+    std::vector<long> schedule(timers);
+    for (auto& delay : schedule)
+        delay = delays(random);
+
+    uint64_t armNanos = 0, cancelNanos = 0, expireNanos = 0;
+    uint64_t allocations = 0;
+    uint64_t expired = 0;
+
+    for (int round = 0; round < rounds; round++) {
+        S scheduler;
+        std::vector<Sp<typename S::Job>> jobs {};
+        jobs.reserve(timers);
+
+        auto before = AllocationCounter::count();
+        Stopwatch sw;
+        for (auto delay : schedule)
+            jobs.push_back(scheduler.add([&expired]() { expired++; }, delay));
+        armNanos += sw.elapsedNanos();
+        allocations += AllocationCounter::count() - before;
+
+        // 90% answered before the stall timer
+        sw.reset();
+        for (int i = 0; i < timers; i++) {
+            if (i % 10 != 0)
+                jobs[i]->cancel();
+        }
+        cancelNanos += sw.elapsedNanos();
+
+        // fast forward through the remaining ones, 1ms at a time
+        sw.reset();
+        uint64_t start = currentTimeMillis();
+        for (uint64_t t = start; t <= start + 10001; t++) {
+            scheduler.syncTime(t);
+            scheduler.run();
+        }
+        expireNanos += sw.elapsedNanos();
+    }
+
+    uint64_t total = (uint64_t)timers * rounds;
+    ctx.report(prefix + "_arm_ns", (double)armNanos / total, "ns");
+    ctx.report(prefix + "_arm_allocations", (double)allocations / total);
+    ctx.report(prefix + "_cancel_ns", (double)cancelNanos / (total - total / 10), "ns");
+    ctx.report(prefix + "_expire_ns", (double)expireNanos / (expired ? expired : 1), "ns");
+}
+
+/*
+ * 100k concurrent timers on the timing wheel and on the old multimap.
+ *   -p timers=100000 -p rounds=5
+ */
+CARRIER_BENCHMARK(scheduler_timers) {
+    int timers = ctx.getParam("timers", 100000);
+    int rounds = ctx.getParam("rounds", 5);
+
+    measure<MultimapScheduler>(ctx, "multimap", timers, rounds);
+    measure<Scheduler>(ctx, "wheel", timers, rounds);
+}
+
+}  // namespace test
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+#include <filesystem>
+
+#include <carrier.h>
+
+#include "scheduler.h"
+#include "data_storage.h"
+#include "sqlite_storage.h"
+#include "utils.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+/*
+ * Every SqliteStorage operation on a database of the given number of
+ * persistent values and of announced peers, each with the given number of
+ * origins. The puts replace the existing records after the first pass, the
+ * removals run once over all the records at the end.
+ *   -p records=1000 -p origins=4
+ */
+CARRIER_BENCHMARK(sqlite_storage) {
+    int count = ctx.getParam("records", 1000);
+    int origins = ctx.getParam("origins", 4);
+
+    auto dir = Utils::getPwdStorage("benchmarks");
+    std::filesystem::create_directories(dir);
+    auto path = dir + Utils::PATH_SEP + "sqlite_storage.db";
+    Utils::removeStorage(path);
+
+    Scheduler scheduler {};
+    auto storage = SqliteStorage::open(path, scheduler);
+
+    std::vector<Value> values {};
+    for (int i = 0; i < count; i++)
+        values.push_back(Value::createSignedValue(std::vector<uint8_t>(256, (uint8_t)i)));
+
+    std::vector<Signature::KeyPair> keypairs(count / origins + 1);
+    std::vector<Id> nodeIds {};
+    for (int i = 0; i < origins; i++)
+        nodeIds.push_back(Id::random());
+
+    std::vector<PeerInfo> peers {};
+    for (int i = 0; i < count; i++) {
+        auto& keypair = keypairs[i / origins];
+        auto& nodeId = nodeIds[i % origins];
+        peers.push_back(PeerInfo::create(keypair, nodeId, 39001 + i % 1000));
+    }
+
+    size_t next = 0;
+    auto index = [&]() {
+        next = (next + 1) % count;
+        return next;
+    };
+
+    ctx.report("put_value_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->putValue(values[index()], -1, true, false));
+    }, 100), "ns");
+
+    ctx.report("get_value_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getValue(values[index()].getId()));
+    }, 100), "ns");
+
+    ctx.report("update_value_last_announce_ns", measureNanos(ctx, [&]() {
+        storage->updateValueLastAnnounce(values[index()].getId());
+    }, 100), "ns");
+
+    ctx.report("get_persistent_values_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getPersistentValues(UINT64_MAX));
+    }, 1), "ns");
+
+    ctx.report("get_all_values_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getAllValues());
+    }, 1), "ns");
+
+    ctx.report("put_peer_ns", measureNanos(ctx, [&]() {
+        storage->putPeer(peers[index()], true, false);
+    }, 100), "ns");
+
+    std::list<PeerInfo> batch(peers.begin(), peers.begin() + std::min(count, 8));
+    ctx.report("put_peers_8_ns", measureNanos(ctx, [&]() {
+        storage->putPeer(batch);
+    }, 100), "ns");
+
+    ctx.report("get_peers_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getPeer(peers[index()].getId(), origins));
+    }, 100), "ns");
+
+    ctx.report("get_peer_ns", measureNanos(ctx, [&]() {
+        const auto& peer = peers[index()];
+        doNotOptimize(storage->getPeer(peer.getId(), peer.getOrigin()));
+    }, 100), "ns");
+
+    ctx.report("update_peer_last_announce_ns", measureNanos(ctx, [&]() {
+        const auto& peer = peers[index()];
+        storage->updatePeerLastAnnounce(peer.getId(), peer.getOrigin());
+    }, 100), "ns");
+
+    ctx.report("get_persistent_peers_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getPersistentPeers(UINT64_MAX));
+    }, 1), "ns");
+
+    ctx.report("get_all_peers_ns", measureNanos(ctx, [&]() {
+        doNotOptimize(storage->getAllPeers());
+    }, 1), "ns");
+
+    Stopwatch sw;
+    for (const auto& value : values)
+        storage->removeValue(value.getId());
+    ctx.report("remove_value_ns", (double)sw.elapsedNanos() / count, "ns");
+
+    sw.reset();
+    for (const auto& peer : peers)
+        storage->removePeer(peer.getId(), peer.getOrigin());
+    ctx.report("remove_peer_ns", (double)sw.elapsedNanos() / count, "ns");
+
+    storage->close();
+    Utils::removeStorage(path);
+}
+
+}  // namespace test
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 - 2023 trinity-tech.io
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <list>
+#include <vector>
+
+#include <carrier.h>
+
+#include "messages/message.h"
+#include "messages/ping_request.h"
+#include "messages/ping_response.h"
+#include "messages/find_node_request.h"
+#include "messages/find_node_response.h"
+
+#include "benchmark.h"
+
+namespace test {
+
+using namespace elastos::carrier;
+
+static std::list<Sp<NodeInfo>> wireNodes(int count, bool ipv6) {
+    std::list<Sp<NodeInfo>> nodes {};
+    for (int i = 0; i < count; i++)
+        nodes.push_back(std::make_shared<NodeInfo>(Id::random(),
+                ipv6 ? "2001:db8::1" : "192.168.1.1", 39001 + i));
+    return nodes;
+}
+
+/*
+ * Bytes on the wire and decoding cost of the PING and FIND_NODE exchanges,
+ * CBOR against the compact layout spoken between nodes of version 2. A
+ * lookup is counted as the given number of FIND_NODE exchanges answered
+ * with 8 IPv4 and 8 IPv6 nodes each; the figures exclude the encryption
+ * overhead, which is the same for both.
+ *   -p requests=20 -p rounds=20000
+ */
+CARRIER_BENCHMARK(wire_format_compact) {
+    int requests = ctx.getParam("requests", 20);
+    int rounds = ctx.getParam("rounds", 20000);
+
+    auto ping = std::make_shared<PingRequest>();
+    ping->setTxid(0x12345678);
+    auto pong = std::make_shared<PingResponse>(0x12345678);
+
+    auto findNode = std::make_shared<FindNodeRequest>(Id::random(), true);
+    findNode->setTxid(0x12345678);
+    findNode->setWant4(true);
+    findNode->setWant6(true);
+
+    auto nodes = std::make_shared<FindNodeResponse>(0x12345678);
+    nodes->setNodes4(wireNodes(8, false));
+    nodes->setNodes6(wireNodes(8, true));
+    nodes->setToken(0x7654321);
+
+    std::list<Sp<Message>> messages { ping, pong, findNode, nodes };
+
+    for (bool compact : { false, true }) {
+        std::string prefix = compact ? "compact_" : "cbor_";
+        size_t sizes[4] {};
+        int i = 0;
+        for (auto& msg : messages) {
+            msg->setCompact(compact);
+            sizes[i++] = msg->serialize().size();
+        }
+
+        ctx.report(prefix + "ping_exchange_bytes", sizes[0] + sizes[1], "B");
+        ctx.report(prefix + "find_node_exchange_bytes", sizes[2] + sizes[3], "B");
+        ctx.report(prefix + "lookup_bytes", (sizes[2] + sizes[3]) * requests, "B");
+
+        auto encoded = nodes->serialize();
+        Stopwatch sw;
+        for (int round = 0; round < rounds; round++) {
+            auto parsed = Message::parse(encoded.data(), encoded.size());
+            doNotOptimize(parsed);
+        }
+        ctx.report(prefix + "find_node_response_parse_ns", (double)sw.elapsedNanos() / rounds, "ns");
+
+        std::vector<uint8_t> buffer {};
+        buffer.reserve(nodes->estimateSize());
+        sw.reset();
+        for (int round = 0; round < rounds; round++) {
+            buffer.clear();
+            nodes->serialize(buffer);
+            doNotOptimize(buffer.data());
+        }
+        ctx.report(prefix + "find_node_response_serialize_ns", (double)sw.elapsedNanos() / rounds, "ns");
+    }
+}
+
+}  // namespace test
